@@ -0,0 +1,115 @@
+#include "BenchData.h"
+#include "DSVWriter.h"
+#include "StringDataSink.h"
+#include <random>
+
+namespace BenchData{
+
+namespace {
+
+const char Letters[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+
+// random alphanumeric text, optionally with the characters that force quoting
+std::string RandomText(std::mt19937 &random, std::size_t length, bool special){
+    std::string Result;
+    Result.reserve(length);
+    for(std::size_t Index = 0; Index < length; Index++){
+        std::uint32_t Pick = random() % 100;
+        if(special && Pick < 4){
+            Result += ",\"\n "[Pick];
+        }
+        else if(Pick < 12){
+            Result += ' ';
+        }
+        else{
+            Result += Letters[random() % (sizeof(Letters) - 1)];
+        }
+    }
+    return Result;
+}
+
+}
+
+std::vector< std::vector< std::string > > DSVRows(std::uint32_t seed, EDSVShape shape, std::size_t rows){
+    std::mt19937 Random(seed);
+    std::size_t Columns = shape == EDSVShape::Wide ? 200 : 8;
+    std::vector< std::vector< std::string > > Result(rows);
+    for(auto &Row : Result){
+        for(std::size_t Column = 0; Column < Columns; Column++){
+            if(Column % 3 == 0){
+                Row.push_back(std::to_string(Random() % 1000000));
+                continue;
+            }
+            std::size_t Length = 4 + Random() % 20;
+            bool Special = (shape == EDSVShape::Quoted && Random() % 4 == 0) || (shape == EDSVShape::Multiline && Random() % 8 == 0);
+            std::string Field = RandomText(Random, Length, Special);
+            if(shape == EDSVShape::Multiline && Special){
+                Field += "\nsecond line";
+            }
+            Row.push_back(std::move(Field));
+        }
+    }
+    return Result;
+}
+
+std::string DSV(std::uint32_t seed, EDSVShape shape, std::size_t rows, char delimiter){
+    auto Sink = std::make_shared<CStringDataSink>();
+    CDSVWriter Writer(Sink, delimiter);
+    for(auto &Row : DSVRows(seed, shape, rows)){
+        Writer.WriteRow(Row);
+    }
+    return Sink->String();
+}
+
+std::string XML(std::uint32_t seed, EXMLShape shape, std::size_t bytes){
+    std::mt19937 Random(seed);
+    std::string Result = "<root>";
+    std::size_t Depth = 0;
+    while(Result.size() < bytes){
+        switch(shape){
+            case EXMLShape::Deep:
+                if(Depth < 64 && Random() % 3){
+                    Result += "<level" + std::to_string(Depth) + " id=\"" + std::to_string(Random() % 1000) + "\">";
+                    Depth++;
+                }
+                else if(Depth){
+                    Depth--;
+                    Result += "</level" + std::to_string(Depth) + ">";
+                }
+                break;
+            case EXMLShape::Flat:
+                Result += "<item id=\"" + std::to_string(Random() % 100000) + "\">" + RandomText(Random, 8, false) + "</item>";
+                break;
+            case EXMLShape::AttributeHeavy:
+                Result += "<record";
+                for(int Attribute = 0; Attribute < 12; Attribute++){
+                    Result += " attr" + std::to_string(Attribute) + "=\"" + RandomText(Random, 6 + Random() % 10, false) + "\"";
+                }
+                Result += "/>";
+                break;
+            case EXMLShape::TextHeavy:
+                Result += "<p>" + RandomText(Random, 400 + Random() % 800, false) + " &amp; more</p>";
+                break;
+        }
+    }
+    while(Depth){
+        Depth--;
+        Result += "</level" + std::to_string(Depth) + ">";
+    }
+    return Result + "</root>";
+}
+
+std::vector< std::string > Words(std::uint32_t seed, std::size_t count, std::size_t maxlength){
+    std::mt19937 Random(seed);
+    std::vector< std::string > Result;
+    Result.reserve(count);
+    for(std::size_t Index = 0; Index < count; Index++){
+        std::string Word(Random() % 4, ' ');
+        Word += RandomText(Random, 1 + Random() % maxlength, false);
+        Word += (Index % 5 == 0) ? "\t\tx" : "  ";
+        Result.push_back(std::move(Word));
+    }
+    return Result;
+}
+
+}
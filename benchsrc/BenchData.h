@@ -0,0 +1,21 @@
+#ifndef BENCHDATA_H
+#define BENCHDATA_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// seeded generators for benchmark inputs, the same seed always produces the same bytes
+namespace BenchData{
+
+enum class EDSVShape{Simple, Quoted, Multiline, Wide};
+enum class EXMLShape{Deep, Flat, AttributeHeavy, TextHeavy};
+
+std::vector< std::vector< std::string > > DSVRows(std::uint32_t seed, EDSVShape shape, std::size_t rows);
+std::string DSV(std::uint32_t seed, EDSVShape shape, std::size_t rows, char delimiter = ',');
+std::string XML(std::uint32_t seed, EXMLShape shape, std::size_t bytes);
+std::vector< std::string > Words(std::uint32_t seed, std::size_t count, std::size_t maxlength = 24);
+
+}
+
+#endif
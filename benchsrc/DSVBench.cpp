@@ -0,0 +1,161 @@
+#include <benchmark/benchmark.h>
+#include "BenchData.h"
+#include "DSVPushParser.h"
+#include "DSVReader.h"
+#include "DSVStaticReader.h"
+#include "DSVWriter.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+
+namespace {
+
+const std::size_t BenchRows = 20000;
+
+// arg 0 selects the generated shape
+void BM_DSVReadRow(benchmark::State &state){
+    auto Shape = static_cast<BenchData::EDSVShape>(state.range(0));
+    std::string Data = BenchData::DSV(1, Shape, Shape == BenchData::EDSVShape::Wide ? BenchRows / 20 : BenchRows);
+    std::size_t Rows = 0;
+    std::vector<std::string> Row;
+    for(auto _ : state){
+        CDSVReader Reader(std::make_shared<CStringDataSource>(Data), ',');
+        while(Reader.ReadRow(Row)){
+            Rows++;
+        }
+        benchmark::DoNotOptimize(Row.data());
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["rows_per_second"] = benchmark::Counter(Rows, benchmark::Counter::kIsRate);
+}
+
+// rows read a block at a time from a per thread pool
+void BM_DSVReadRows(benchmark::State &state){
+    auto Shape = static_cast<BenchData::EDSVShape>(state.range(0));
+    std::string Data = BenchData::DSV(1, Shape, Shape == BenchData::EDSVShape::Wide ? BenchRows / 20 : BenchRows);
+    std::size_t Rows = 0;
+    std::pmr::unsynchronized_pool_resource Pool;
+    TDSVRowBlock Block(&Pool);
+    for(auto _ : state){
+        CDSVReader Reader(std::make_shared<CStringDataSource>(Data), ',');
+        while(std::size_t Count = Reader.ReadRows(Block, 256)){
+            Rows += Count;
+        }
+        benchmark::DoNotOptimize(Block.Capacity());
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["rows_per_second"] = benchmark::Counter(Rows, benchmark::Counter::kIsRate);
+}
+
+// the same shapes through the compile-time reader on the concrete source type
+void BM_DSVStaticReadRow(benchmark::State &state){
+    auto Shape = static_cast<BenchData::EDSVShape>(state.range(0));
+    std::string Data = BenchData::DSV(1, Shape, Shape == BenchData::EDSVShape::Wide ? BenchRows / 20 : BenchRows);
+    std::size_t Rows = 0;
+    std::vector<std::string> Row;
+    for(auto _ : state){
+        CDSVStaticReader<',', EDSVQuoting::RFC4180, EDSVLineEnding::Any, CStringDataSource> Reader(std::make_shared<CStringDataSource>(Data));
+        while(Reader.ReadRow(Row)){
+            Rows++;
+        }
+        benchmark::DoNotOptimize(Row.data());
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["rows_per_second"] = benchmark::Counter(Rows, benchmark::Counter::kIsRate);
+}
+
+// quote-free tab separated rows, the fixed-format feed case
+void BM_DSVStaticReadRowUnquoted(benchmark::State &state){
+    std::string Data = BenchData::DSV(1, BenchData::EDSVShape::Simple, BenchRows, '\t');
+    std::size_t Rows = 0;
+    std::vector<std::string> Row;
+    for(auto _ : state){
+        CDSVStaticReader<'\t', EDSVQuoting::None, EDSVLineEnding::LF, CStringDataSource> Reader(std::make_shared<CStringDataSource>(Data));
+        while(Reader.ReadRow(Row)){
+            Rows++;
+        }
+        benchmark::DoNotOptimize(Row.data());
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["rows_per_second"] = benchmark::Counter(Rows, benchmark::Counter::kIsRate);
+}
+
+// arg 0 is the chunk size fed per call, as a socket read would deliver it
+void BM_DSVPushParser(benchmark::State &state){
+    std::string Data = BenchData::DSV(1, BenchData::EDSVShape::Quoted, BenchRows);
+    std::size_t Chunk = state.range(0);
+    std::size_t Rows = 0;
+    for(auto _ : state){
+        CDSVPushParser Parser(',', [&](std::vector<std::string> &row){
+            Rows++;
+            benchmark::DoNotOptimize(row.data());
+        });
+        for(std::size_t Offset = 0; Offset < Data.size(); Offset += Chunk){
+            Parser.Feed(Data.data() + Offset, std::min(Chunk, Data.size() - Offset));
+        }
+        Parser.Finish();
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["rows_per_second"] = benchmark::Counter(Rows, benchmark::Counter::kIsRate);
+}
+
+void BM_DSVWriteRow(benchmark::State &state){
+    auto Shape = static_cast<BenchData::EDSVShape>(state.range(0));
+    auto Rows = BenchData::DSVRows(2, Shape, Shape == BenchData::EDSVShape::Wide ? BenchRows / 20 : BenchRows);
+    std::size_t Bytes = 0;
+    for(auto _ : state){
+        auto Sink = std::make_shared<CStringDataSink>();
+        CDSVWriter Writer(Sink, ',');
+        for(auto &Row : Rows){
+            Writer.WriteRow(Row);
+        }
+        Bytes += Sink->String().size();
+    }
+    state.SetBytesProcessed(Bytes);
+    state.counters["rows_per_second"] = benchmark::Counter(state.iterations() * Rows.size(), benchmark::Counter::kIsRate);
+}
+
+// a numeric export, arg 0 selects strings formatted up front, typed rows or
+// typed columns
+void BM_DSVWriteNumeric(benchmark::State &state){
+    std::vector<std::int64_t> Ids;
+    std::vector<double> Values;
+    std::vector<bool> Flags;
+    for(std::size_t Index = 0; Index < BenchRows; Index++){
+        Ids.push_back(Index * 7919);
+        Values.push_back(Index / 3.0);
+        Flags.push_back(Index % 2);
+    }
+    std::size_t Bytes = 0;
+    for(auto _ : state){
+        auto Sink = std::make_shared<CStringDataSink>();
+        CDSVWriter Writer(Sink, ',');
+        if(state.range(0) == 0){
+            std::vector<std::string> Row;
+            for(std::size_t Index = 0; Index < Ids.size(); Index++){
+                Row = {std::to_string(Ids[Index]), std::to_string(Values[Index]), Flags[Index] ? "true" : "false"};
+                Writer.WriteRow(Row);
+            }
+        }
+        else if(state.range(0) == 1){
+            for(std::size_t Index = 0; Index < Ids.size(); Index++){
+                Writer.WriteRow(Ids[Index], Values[Index], bool(Flags[Index]));
+            }
+        }
+        else{
+            Writer.WriteColumns(Ids, Values, Flags);
+        }
+        Bytes += Sink->String().size();
+    }
+    state.SetBytesProcessed(Bytes);
+    state.counters["rows_per_second"] = benchmark::Counter(state.iterations() * Ids.size(), benchmark::Counter::kIsRate);
+}
+
+}
+
+BENCHMARK(BM_DSVReadRow)->DenseRange(0, 3)->ArgName("shape")->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DSVReadRows)->DenseRange(0, 3)->ArgName("shape")->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DSVStaticReadRow)->DenseRange(0, 3)->ArgName("shape")->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DSVStaticReadRowUnquoted)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DSVPushParser)->Arg(1)->Arg(1500)->Arg(65536)->ArgName("chunk")->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DSVWriteRow)->DenseRange(0, 3)->ArgName("shape")->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DSVWriteNumeric)->DenseRange(0, 2)->ArgName("mode")->Unit(benchmark::kMillisecond);
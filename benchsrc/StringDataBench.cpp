@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+#include "SegmentedDataSink.h"
+#include "EncodingDataSource.h"
+
+namespace {
+
+const std::size_t BenchBytes = 1 << 20;
+
+void BM_StringDataSourceGet(benchmark::State &state){
+    std::string Data(BenchBytes, 'x');
+    for(auto _ : state){
+        CStringDataSource Source(Data);
+        char Ch;
+        while(Source.Get(Ch)){
+            benchmark::DoNotOptimize(Ch);
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+}
+
+// arg 0 is the block size requested per Read
+void BM_StringDataSourceRead(benchmark::State &state){
+    std::string Data(BenchBytes, 'x');
+    std::vector<char> Buffer;
+    for(auto _ : state){
+        CStringDataSource Source(Data);
+        while(Source.Read(Buffer, state.range(0))){
+            benchmark::DoNotOptimize(Buffer.data());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+}
+
+void BM_StringDataSinkPut(benchmark::State &state){
+    for(auto _ : state){
+        CStringDataSink Sink;
+        for(std::size_t Index = 0; Index < BenchBytes; Index++){
+            Sink.Put('x');
+        }
+        benchmark::DoNotOptimize(Sink.String().data());
+    }
+    state.SetBytesProcessed(state.iterations() * BenchBytes);
+}
+
+// arg 0 is the block size passed per Write
+void BM_StringDataSinkWrite(benchmark::State &state){
+    std::vector<char> Block(state.range(0), 'x');
+    for(auto _ : state){
+        CStringDataSink Sink;
+        for(std::size_t Written = 0; Written < BenchBytes; Written += Block.size()){
+            Sink.Write(Block);
+        }
+        benchmark::DoNotOptimize(Sink.String().data());
+    }
+    state.SetBytesProcessed(state.iterations() * BenchBytes);
+}
+
+// arg 0 is the block size passed per Write, the chunks are never joined
+void BM_SegmentedDataSinkWrite(benchmark::State &state){
+    std::vector<char> Block(state.range(0), 'x');
+    for(auto _ : state){
+        CSegmentedDataSink Sink;
+        for(std::size_t Written = 0; Written < BenchBytes; Written += Block.size()){
+            Sink.Write(Block);
+        }
+        benchmark::DoNotOptimize(Sink.TakeChunks().size());
+    }
+    state.SetBytesProcessed(state.iterations() * BenchBytes);
+}
+
+// arg 0 selects mostly ASCII UTF-8, UTF-8 with a multi-byte character every
+// few bytes, Latin-1 or UTF-16LE input, all read through the encoding source
+void BM_EncodingDataSourceRead(benchmark::State &state){
+    std::string Data;
+    const std::string Word[] = {"plain text, ", "caf\xC3\xA9 \xE2\x82\xAC ", "caf\xE9 cr\xE8me ", std::string("a\0b\0c\0,\0 \0", 10)};
+    EEncoding Encoding[] = {EEncoding::UTF8, EEncoding::UTF8, EEncoding::Latin1, EEncoding::UTF16LE};
+    while(Data.size() < BenchBytes){
+        Data += Word[state.range(0)];
+    }
+    std::vector<char> Buffer;
+    for(auto _ : state){
+        CEncodingDataSource Source(std::make_shared<CStringDataSource>(Data), Encoding[state.range(0)]);
+        while(Source.Read(Buffer, 65536)){
+            benchmark::DoNotOptimize(Buffer.data());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+}
+
+}
+
+BENCHMARK(BM_StringDataSourceGet)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StringDataSourceRead)->Arg(64)->Arg(4096)->Arg(65536)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StringDataSinkPut)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StringDataSinkWrite)->Arg(64)->Arg(4096)->Arg(65536)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SegmentedDataSinkWrite)->Arg(64)->Arg(4096)->Arg(65536)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_EncodingDataSourceRead)->DenseRange(0, 3)->ArgName("input")->Unit(benchmark::kMicrosecond);
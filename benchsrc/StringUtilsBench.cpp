@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+#include "BenchData.h"
+#include "StringUtils.h"
+
+namespace {
+
+const std::size_t BenchWords = 10000;
+
+// runs func over every generated word and reports bytes and fields per second
+template <typename TFunc>
+void RunPerField(benchmark::State &state, TFunc func){
+    auto Words = BenchData::Words(5, BenchWords);
+    std::size_t Bytes = 0;
+    for(auto &Word : Words){
+        Bytes += Word.size();
+    }
+    for(auto _ : state){
+        for(auto &Word : Words){
+            benchmark::DoNotOptimize(func(Word));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * Bytes);
+    state.counters["fields_per_second"] = benchmark::Counter(state.iterations() * Words.size(), benchmark::Counter::kIsRate);
+}
+
+// the column overloads over the same words
+template <typename TFunc>
+void RunColumn(benchmark::State &state, TFunc func){
+    SStringColumn Column(BenchData::Words(5, BenchWords * 10));
+    for(auto _ : state){
+        benchmark::DoNotOptimize(func(Column));
+    }
+    state.SetBytesProcessed(state.iterations() * Column.DData.size());
+    state.counters["fields_per_second"] = benchmark::Counter(state.iterations() * Column.Size(), benchmark::Counter::kIsRate);
+}
+
+void BM_Slice(benchmark::State &state){ RunPerField(state, [](const std::string &str){ return StringUtils::Slice(str, 1, -1); }); }
+void BM_Capitalize(benchmark::State &state){ RunPerField(state, [](const std::string &str){ return StringUtils::Capitalize(str); }); }
+void BM_Upper(benchmark::State &state){ RunPerField(state, [](const std::string &str){ return StringUtils::Upper(str); }); }
+void BM_Lower(benchmark::State &state){ RunPerField(state, [](const std::string &str){ return StringUtils::Lower(str); }); }
+void BM_LStrip(benchmark::State &state){ RunPerField(state, [](const std::string &str){ return StringUtils::LStrip(str); }); }
+void BM_RStrip(benchmark::State &state){ RunPerField(state, [](const std::string &str){ return StringUtils::RStrip(str); }); }
+void BM_Strip(benchmark::State &state){ RunPerField(state, [](const std::string &str){ return StringUtils::Strip(str); }); }
+void BM_Center(benchmark::State &state){ RunPerField(state, [](const std::string &str){ return StringUtils::Center(str, 32, '*'); }); }
+void BM_LJust(benchmark::State &state){ RunPerField(state, [](const std::string &str){ return StringUtils::LJust(str, 32); }); }
+void BM_RJust(benchmark::State &state){ RunPerField(state, [](const std::string &str){ return StringUtils::RJust(str, 32); }); }
+void BM_Replace(benchmark::State &state){ RunPerField(state, [](const std::string &str){ return StringUtils::Replace(str, "a", "xyz"); }); }
+void BM_Split(benchmark::State &state){ RunPerField(state, [](const std::string &str){ return StringUtils::Split(str); }); }
+void BM_Join(benchmark::State &state){
+    auto Words = BenchData::Words(6, 64);
+    RunPerField(state, [&Words](const std::string &str){ return StringUtils::Join(str, Words); });
+}
+void BM_ExpandTabs(benchmark::State &state){ RunPerField(state, [](const std::string &str){ return StringUtils::ExpandTabs(str, 4); }); }
+void BM_EditDistance(benchmark::State &state){ RunPerField(state, [](const std::string &str){ return StringUtils::EditDistance(str, "reference word", true); }); }
+
+void BM_ColumnUpper(benchmark::State &state){ RunColumn(state, [](const SStringColumn &col){ return StringUtils::Upper(col); }); }
+void BM_ColumnStrip(benchmark::State &state){ RunColumn(state, [](const SStringColumn &col){ return StringUtils::Strip(col); }); }
+void BM_ColumnCenter(benchmark::State &state){ RunColumn(state, [](const SStringColumn &col){ return StringUtils::Center(col, 32, '*'); }); }
+void BM_ColumnReplace(benchmark::State &state){ RunColumn(state, [](const SStringColumn &col){ return StringUtils::Replace(col, "a", "xyz"); }); }
+void BM_ColumnExpandTabs(benchmark::State &state){ RunColumn(state, [](const SStringColumn &col){ return StringUtils::ExpandTabs(col, 4); }); }
+
+}
+
+BENCHMARK(BM_Slice);
+BENCHMARK(BM_Capitalize);
+BENCHMARK(BM_Upper);
+BENCHMARK(BM_Lower);
+BENCHMARK(BM_LStrip);
+BENCHMARK(BM_RStrip);
+BENCHMARK(BM_Strip);
+BENCHMARK(BM_Center);
+BENCHMARK(BM_LJust);
+BENCHMARK(BM_RJust);
+BENCHMARK(BM_Replace);
+BENCHMARK(BM_Split);
+BENCHMARK(BM_Join);
+BENCHMARK(BM_ExpandTabs);
+BENCHMARK(BM_EditDistance);
+BENCHMARK(BM_ColumnUpper)->UseRealTime();
+BENCHMARK(BM_ColumnStrip)->UseRealTime();
+BENCHMARK(BM_ColumnCenter)->UseRealTime();
+BENCHMARK(BM_ColumnReplace)->UseRealTime();
+BENCHMARK(BM_ColumnExpandTabs)->UseRealTime();
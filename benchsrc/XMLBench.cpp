@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+#include "BenchData.h"
+#include "XMLBinaryReader.h"
+#include "XMLBinaryWriter.h"
+#include "XMLReader.h"
+#include "XMLWriter.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+
+namespace {
+
+const std::size_t BenchBytes = 1 << 20;
+
+// arg 0 selects the generated shape
+void BM_XMLReadEntity(benchmark::State &state){
+    std::string Data = BenchData::XML(3, static_cast<BenchData::EXMLShape>(state.range(0)), BenchBytes);
+    std::size_t Entities = 0;
+    SXMLEntity Entity;
+    for(auto _ : state){
+        CXMLReader Reader(std::make_shared<CStringDataSource>(Data));
+        while(Reader.ReadEntity(Entity)){
+            Entities++;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["entities_per_second"] = benchmark::Counter(Entities, benchmark::Counter::kIsRate);
+}
+
+// entities read a block at a time, the reader and block share a per thread pool
+void BM_XMLReadEntities(benchmark::State &state){
+    std::string Data = BenchData::XML(3, static_cast<BenchData::EXMLShape>(state.range(0)), BenchBytes);
+    std::size_t Entities = 0;
+    std::pmr::unsynchronized_pool_resource Pool;
+    TXMLEntityBlock Block(&Pool);
+    for(auto _ : state){
+        CXMLReader Reader(std::make_shared<CStringDataSource>(Data), &Pool);
+        while(std::size_t Count = Reader.ReadEntities(Block, 256)){
+            Entities += Count;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["entities_per_second"] = benchmark::Counter(Entities, benchmark::Counter::kIsRate);
+}
+
+// the same documents replayed from their binary recording, bytes are the
+// original XML size so the rate compares directly with BM_XMLReadEntity
+void BM_XMLBinaryReplay(benchmark::State &state){
+    std::string Data = BenchData::XML(3, static_cast<BenchData::EXMLShape>(state.range(0)), BenchBytes);
+    auto Sink = std::make_shared<CStringDataSink>();
+    CXMLReader Reader(std::make_shared<CStringDataSource>(Data));
+    CXMLBinaryWriter Writer(Sink);
+    SXMLEntity Entity;
+    while(Reader.ReadEntity(Entity)){
+        Writer.WriteEntity(Entity);
+    }
+    Writer.Flush();
+    auto Binary = std::make_shared<const std::string>(Sink->String());
+    std::size_t Entities = 0;
+    for(auto _ : state){
+        CXMLBinaryReader Replay(Binary);
+        while(Replay.ReadEntity(Entity)){
+            Entities++;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * Data.size());
+    state.counters["entities_per_second"] = benchmark::Counter(Entities, benchmark::Counter::kIsRate);
+    state.counters["binary_ratio"] = static_cast<double>(Binary->size()) / Data.size();
+}
+
+void BM_XMLWriteEntity(benchmark::State &state){
+    std::string Data = BenchData::XML(4, static_cast<BenchData::EXMLShape>(state.range(0)), BenchBytes);
+    std::vector<SXMLEntity> Entities;
+    SXMLEntity Entity;
+    CXMLReader Reader(std::make_shared<CStringDataSource>(Data));
+    while(Reader.ReadEntity(Entity)){
+        Entities.push_back(Entity);
+    }
+    std::size_t Bytes = 0;
+    for(auto _ : state){
+        auto Sink = std::make_shared<CStringDataSink>();
+        CXMLWriter Writer(Sink);
+        for(auto &Current : Entities){
+            Writer.WriteEntity(Current);
+        }
+        Writer.Flush();
+        Bytes += Sink->String().size();
+    }
+    state.SetBytesProcessed(Bytes);
+    state.counters["entities_per_second"] = benchmark::Counter(state.iterations() * Entities.size(), benchmark::Counter::kIsRate);
+}
+
+}
+
+BENCHMARK(BM_XMLReadEntity)->DenseRange(0, 3)->ArgName("shape")->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_XMLReadEntities)->DenseRange(0, 3)->ArgName("shape")->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_XMLBinaryReplay)->DenseRange(0, 3)->ArgName("shape")->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_XMLWriteEntity)->DenseRange(0, 3)->ArgName("shape")->Unit(benchmark::kMillisecond);
@@ -0,0 +1,45 @@
+#!/usr/bin/env python3
+"""Compares two Google Benchmark JSON outputs and flags slowdowns.
+
+usage: compare.py BASELINE CURRENT [THRESHOLD]
+
+THRESHOLD is the allowed fractional slowdown in real time per benchmark,
+0.10 by default. Exits with status 1 when any benchmark regresses past it.
+"""
+import json
+import sys
+
+
+def load(path):
+    with open(path) as handle:
+        data = json.load(handle)
+    return {bench["name"]: bench for bench in data["benchmarks"]
+            if bench.get("run_type", "iteration") == "iteration"}
+
+
+def main():
+    if len(sys.argv) < 3:
+        print(__doc__.strip())
+        return 2
+    baseline = load(sys.argv[1])
+    current = load(sys.argv[2])
+    threshold = float(sys.argv[3]) if len(sys.argv) > 3 else 0.10
+    regressions = 0
+    print("%-48s %14s %14s %8s" % ("benchmark", "baseline", "current", "change"))
+    for name, bench in current.items():
+        if name not in baseline:
+            print("%-48s %14s %14.1f %8s" % (name, "-", bench["real_time"], "new"))
+            continue
+        old = baseline[name]["real_time"]
+        new = bench["real_time"]
+        change = (new - old) / old if old else 0.0
+        flag = ""
+        if change > threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print("%-48s %14.1f %14.1f %+7.1f%%%s" % (name, old, new, change * 100, flag))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,25 @@
+#ifndef ASYNCDSVREADER_H
+#define ASYNCDSVREADER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "AsyncDataSource.h"
+#include "Task.h"
+
+// DSV reader for coroutines, ReadRow suspends while the source has no data
+// instead of blocking the thread, rows match CDSVReader
+class CAsyncDSVReader{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        CAsyncDSVReader(std::shared_ptr< CAsyncDataSource > src, char delimiter, std::size_t blocksize = 65536);
+        ~CAsyncDSVReader();
+
+        bool End() const;
+        CTask<bool> ReadRow(std::vector<std::string> &row);
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef ASYNCDATASOURCE_H
+#define ASYNCDATASOURCE_H
+
+#include <coroutine>
+#include <functional>
+#include <vector>
+
+// non-blocking counterpart of CDataSource, ReadSome never waits for data and
+// Wait arranges for a callback once more may be available, co_await Read(...)
+// combines the two for coroutines running under CAsyncScheduler
+class CAsyncDataSource{
+    public:
+        enum class EStatus{Data, Pending, End, Error};
+
+        // suspends the awaiting coroutine until a ReadSome makes progress
+        class CReadAwaiter{
+            private:
+                CAsyncDataSource &DSource;
+                std::vector<char> &DBuffer;
+                std::size_t DCount;
+                EStatus DStatus = EStatus::Pending;
+
+            public:
+                CReadAwaiter(CAsyncDataSource &source, std::vector<char> &buf, std::size_t count)
+                    : DSource(source), DBuffer(buf), DCount(count){}
+
+                bool await_ready(){
+                    DStatus = DSource.ReadSome(DBuffer, DCount);
+                    return DStatus != EStatus::Pending;
+                }
+                bool await_suspend(std::coroutine_handle<> handle){
+                    if(!DSource.Wait([handle]{ handle.resume(); })){
+                        DStatus = EStatus::Error;
+                        return false;
+                    }
+                    return true;
+                }
+                // a wakeup can be spurious, so Pending may still come back
+                EStatus await_resume(){
+                    if(DStatus == EStatus::Pending){
+                        DStatus = DSource.ReadSome(DBuffer, DCount);
+                    }
+                    return DStatus;
+                }
+        };
+
+        virtual ~CAsyncDataSource(){};
+
+        // replaces buf with up to count bytes that are available now
+        virtual EStatus ReadSome(std::vector<char> &buf, std::size_t count) noexcept = 0;
+        // calls ready once, on the scheduler thread, when ReadSome may no longer be Pending
+        virtual bool Wait(std::function<void()> ready) = 0;
+
+        CReadAwaiter Read(std::vector<char> &buf, std::size_t count){
+            return CReadAwaiter(*this, buf, count);
+        }
+};
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef ASYNCFDDATASOURCE_H
+#define ASYNCFDDATASOURCE_H
+
+#include "AsyncDataSource.h"
+
+// async source over a pipe, socket or other pollable descriptor, the
+// descriptor is switched to non-blocking mode and waits go through the
+// running CAsyncScheduler's epoll set
+class CAsyncFDDataSource : public CAsyncDataSource{
+    private:
+        int DFD;
+        bool DOwned;
+
+    public:
+        CAsyncFDDataSource(int fd, bool owned = true);
+        ~CAsyncFDDataSource();
+
+        EStatus ReadSome(std::vector<char> &buf, std::size_t count) noexcept override;
+        bool Wait(std::function<void()> ready) override;
+};
+
+#endif
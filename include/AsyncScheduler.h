@@ -0,0 +1,31 @@
+#ifndef ASYNCSCHEDULER_H
+#define ASYNCSCHEDULER_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include "Task.h"
+
+// single threaded event loop for coroutine tasks, Run resumes tasks as their
+// sources become ready and waits on epoll when nothing is runnable, so one
+// thread can drive many slow streams at once
+class CAsyncScheduler{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        CAsyncScheduler();
+        ~CAsyncScheduler();
+
+        void Spawn(CTask<void> task);
+        void Post(std::function<void()> func);
+        bool WatchReadable(int fd, std::function<void()> ready);
+        void Run();
+
+        std::size_t TaskCount() const;
+
+        static CAsyncScheduler *Current() noexcept;
+};
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef ASYNCXMLREADER_H
+#define ASYNCXMLREADER_H
+
+#include <memory>
+#include "AsyncDataSource.h"
+#include "Task.h"
+#include "XMLEntity.h"
+
+// XML reader for coroutines, ReadEntity suspends while the source has no
+// data instead of blocking the thread, entities match CXMLReader
+class CAsyncXMLReader{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        CAsyncXMLReader(std::shared_ptr< CAsyncDataSource > src, std::size_t blocksize = 4096);
+        ~CAsyncXMLReader();
+
+        bool End() const;
+        CTask<bool> ReadEntity(SXMLEntity &entity, bool skipcdata = false);
+};
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+// blocking queue with a fixed capacity for handing work between pipeline
+// threads, Push waits while the queue is full so a fast producer cannot run
+// ahead of a slow consumer, Close wakes everyone and ends the stream
+template <typename T>
+class CBoundedQueue{
+    private:
+        std::mutex DMutex;
+        std::condition_variable DNotFull;
+        std::condition_variable DNotEmpty;
+        std::deque<T> DItems;
+        std::size_t DCapacity;
+        std::size_t DHighWater = 0;
+        bool DClosed = false;
+
+    public:
+        CBoundedQueue(std::size_t capacity) : DCapacity(capacity ? capacity : 1){}
+
+        // false if the queue was closed, in which case item is dropped
+        bool Push(T item){
+            std::unique_lock<std::mutex> Lock(DMutex);
+            DNotFull.wait(Lock, [this]{ return DClosed || DItems.size() < DCapacity; });
+            if(DClosed){
+                return false;
+            }
+            DItems.push_back(std::move(item));
+            DHighWater = std::max(DHighWater, DItems.size());
+            DNotEmpty.notify_one();
+            return true;
+        }
+
+        // false once the queue is closed and drained
+        bool Pop(T &item){
+            std::unique_lock<std::mutex> Lock(DMutex);
+            DNotEmpty.wait(Lock, [this]{ return DClosed || !DItems.empty(); });
+            if(DItems.empty()){
+                return false;
+            }
+            item = std::move(DItems.front());
+            DItems.pop_front();
+            DNotFull.notify_one();
+            return true;
+        }
+
+        // no more items will be pushed, items already queued can still be popped
+        void Close(){
+            std::lock_guard<std::mutex> Lock(DMutex);
+            DClosed = true;
+            DNotFull.notify_all();
+            DNotEmpty.notify_all();
+        }
+
+        std::size_t HighWater(){
+            std::lock_guard<std::mutex> Lock(DMutex);
+            return DHighWater;
+        }
+};
+
+#endif
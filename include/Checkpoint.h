@@ -0,0 +1,29 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <string>
+#include <vector>
+
+// where a CDSVReader can pick up again on a seekable source, always at a row
+// boundary, so no quoted field is open
+struct SDSVCheckpoint{
+    std::size_t DOffset = 0;
+    std::size_t DRow = 0;
+
+    std::string Serialize() const;
+    static bool Parse(const std::string &text, SDSVCheckpoint &checkpoint);
+};
+
+// where a CXMLReader can pick up again on a seekable source, parsing restarts
+// at the markup that produced the last entity returned, DSkip entities into
+// it, with the elements that were open before it supplied as a prefix
+struct SXMLCheckpoint{
+    std::size_t DOffset = 0;
+    std::size_t DSkip = 0;
+    std::vector< std::string > DOpenElements;
+
+    std::string Serialize() const;
+    static bool Parse(const std::string &text, SXMLCheckpoint &checkpoint);
+};
+
+#endif
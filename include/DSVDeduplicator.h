@@ -0,0 +1,31 @@
+#ifndef DSVDEDUPLICATOR_H
+#define DSVDEDUPLICATOR_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "DSVReader.h"
+#include "DSVWriter.h"
+
+// streaming removal of rows whose key columns repeat an earlier row, the first
+// row of each key is written as soon as it is read and its key kept in a
+// CDSVHashTable, once the table outgrows the memory budget it stops taking
+// keys, rows it already holds are dropped and the rest go to hash partitions
+// on disk that are deduplicated one at a time after the input ends, the same
+// way, so a partition with too many keys is split again on other hash bits
+class CDSVDeduplicator{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        CDSVDeduplicator(std::vector< std::size_t > keys, std::size_t memorybudget = 64 << 20, const std::string &tempdir = "");
+        ~CDSVDeduplicator();
+
+        bool Deduplicate(CDSVReader &reader, CDSVWriter &writer);
+        bool Spilled() const;
+        // rows dropped by the last Deduplicate
+        std::size_t Duplicates() const;
+};
+
+#endif
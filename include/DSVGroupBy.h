@@ -0,0 +1,33 @@
+#ifndef DSVGROUPBY_H
+#define DSVGROUPBY_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "DSVReader.h"
+#include "DSVWriter.h"
+
+// hash aggregation of a DSV stream, when the table outgrows the memory budget
+// its partial results are spilled to hash partitions that are merged at the end,
+// a partition that does not fit the budget when merged is split again on other
+// bits of the hash, each output row holds the key fields followed by one field per aggregate
+class CDSVGroupBy{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        struct SAggregate{
+            enum class EFunction{Count, Sum, Min, Max};
+            EFunction DFunction;
+            std::size_t DColumn = 0;
+        };
+
+        CDSVGroupBy(std::vector< std::size_t > keys, std::vector< SAggregate > aggregates, std::size_t memorybudget = 64 << 20, const std::string &tempdir = "");
+        ~CDSVGroupBy();
+
+        bool Aggregate(CDSVReader &reader, CDSVWriter &writer);
+        bool Spilled() const;
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef DSVHASHJOIN_H
+#define DSVHASHJOIN_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "DSVReader.h"
+#include "DSVWriter.h"
+
+// hash join of a DSV probe stream against a build stream, the build side goes
+// into a CDSVHashTable and the probe side streams through it, each output row
+// holds the probe row followed by the build row's fields outside its keys,
+// when the table outgrows the memory budget both sides are split into hash
+// partitions on disk and joined one partition at a time, a partition still
+// over budget is split again on other bits of the hash, and the build rows of
+// a key too common to fit are joined in chunks that each rescan its probe rows
+class CDSVHashJoin{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        // Inner writes one row per matching pair, Left also writes unmatched
+        // probe rows with empty build fields, Semi writes each probe row with a
+        // match once and Anti each probe row without one, both without build fields
+        enum class EType{Inner, Left, Semi, Anti};
+
+        CDSVHashJoin(std::vector< std::size_t > buildkeys, std::vector< std::size_t > probekeys, EType type = EType::Inner, std::size_t memorybudget = 64 << 20, const std::string &tempdir = "", bool parallel = false);
+        ~CDSVHashJoin();
+
+        bool Join(CDSVReader &build, CDSVReader &probe, CDSVWriter &writer);
+        bool Spilled() const;
+};
+
+#endif
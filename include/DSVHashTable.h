@@ -0,0 +1,75 @@
+#ifndef DSVHASHTABLE_H
+#define DSVHASHTABLE_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// open addressing table from the key columns of DSV rows to the rest of each
+// row, keys and payloads are packed into two arenas and every slot keeps the
+// key's hash so probes compare hashes first and growing never rehashes a key,
+// rows with equal keys are chained in the order they were inserted
+class CDSVHashTable{
+    private:
+        struct SSlot{
+            std::uint64_t DHash;
+            std::uint64_t DKey;
+            std::uint32_t DHead;
+            std::uint32_t DTail;
+        };
+        struct SRow{
+            std::uint64_t DPayload;
+            std::uint32_t DFields;
+            std::uint32_t DNext;
+        };
+
+        std::vector< std::size_t > DKeys;
+        std::vector< SSlot > DSlots;
+        std::vector< SRow > DRows;
+        std::vector< char > DKeyArena;
+        std::vector< char > DPayloadArena;
+        std::size_t DSize;
+        std::size_t DWidth;
+
+        std::size_t Locate(std::uint64_t hash, const std::vector< std::string > &row, const std::vector< std::size_t > &keys) const;
+        bool KeyEquals(std::uint64_t key, const std::vector< std::string > &row, const std::vector< std::size_t > &keys) const;
+        std::size_t Claim(std::size_t slot, std::uint64_t hash, const std::vector< std::string > &row);
+        void Grow();
+
+    public:
+        static constexpr std::uint32_t NoRow = UINT32_MAX;
+
+        CDSVHashTable(std::vector< std::size_t > keys);
+
+        // hash of the fields of row at the given columns, missing columns hash as empty
+        static std::uint64_t Hash(const std::vector< std::string > &row, const std::vector< std::size_t > &keys);
+
+        // adds the row's payload, its fields outside the key columns, under its key
+        void Insert(const std::vector< std::string > &row);
+        // adds only the key, true if it was not there yet
+        bool InsertKey(const std::vector< std::string > &row);
+        // first row whose key equals the fields of row at keys, or NoRow, keys
+        // must name as many columns as the table's keys or nothing matches
+        std::uint32_t Find(const std::vector< std::string > &row, const std::vector< std::size_t > &keys) const;
+        bool Contains(const std::vector< std::string > &row, const std::vector< std::size_t > &keys) const;
+        std::uint32_t NextRow(std::uint32_t row) const;
+        // appends the payload fields of a row to fields
+        void AppendPayload(std::uint32_t row, std::vector< std::string > &fields) const;
+
+        // distinct keys
+        std::size_t Size() const;
+        // payload rows
+        std::size_t Rows() const;
+        // most payload fields of any row
+        std::size_t Width() const;
+        // bytes held by the slots and arenas
+        std::size_t Bytes() const;
+        void Clear();
+
+        // calls callback with each row as its key fields followed by its payload,
+        // a key without rows is passed on its own
+        bool Export(const std::function< bool(const std::vector< std::string > &) > &callback) const;
+};
+
+#endif
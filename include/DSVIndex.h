@@ -0,0 +1,38 @@
+#ifndef DSVINDEX_H
+#define DSVINDEX_H
+
+#include <memory>
+#include <vector>
+#include "DataSink.h"
+#include "DataSource.h"
+
+// sampled row start offsets for a DSV stream, every stride rows the byte
+// offset of the row start is kept so a reader can seek near any row
+class CDSVIndex{
+    private:
+        std::size_t DStride;
+        std::size_t DRowCount;
+        std::size_t DEndOffset;
+        std::vector< std::size_t > DOffsets;
+
+    public:
+        struct SSplit{
+            std::size_t DRow;
+            std::size_t DOffset;
+        };
+
+        CDSVIndex(std::size_t stride = 1024);
+
+        std::size_t Stride() const noexcept;
+        std::size_t RowCount() const noexcept;
+        std::size_t EndOffset() const noexcept;
+
+        bool Locate(std::size_t row, std::size_t &offset, std::size_t &skip) const noexcept;
+        std::vector< SSplit > Splits(std::size_t parts) const;
+
+        bool Build(std::shared_ptr< CDataSource > src);
+        bool Save(std::shared_ptr< CDataSink > sink) const;
+        bool Load(std::shared_ptr< CDataSource > src);
+};
+
+#endif
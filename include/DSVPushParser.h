@@ -0,0 +1,33 @@
+#ifndef DSVPUSHPARSER_H
+#define DSVPUSHPARSER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// incremental DSV parser for input that arrives in arbitrary chunks, such as
+// socket or pipe reads, complete rows are passed to the callback as soon as
+// their line ending is seen and Finish flushes the last row at end of input,
+// rows match what CDSVReader returns for the same bytes
+class CDSVPushParser{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        // the row may be moved from, it is cleared before the next row is parsed
+        using TRowCallback = std::function<void(std::vector<std::string> &row)>;
+
+        CDSVPushParser(char delimiter, TRowCallback callback);
+        ~CDSVPushParser();
+
+        bool Feed(const char *data, std::size_t length);
+        bool Finish();
+
+        bool Finished() const;
+        std::size_t Row() const;
+        void Reset();
+};
+
+#endif
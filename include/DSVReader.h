@@ -2,8 +2,17 @@
 #define DSVREADER_H
 
 #include <memory>
+#include <memory_resource>
 #include <string>
+#include "Checkpoint.h"
 #include "DataSource.h"
+#include "DSVIndex.h"
+#include "Generator.h"
+#include "IOStats.h"
+#include "MemoryAccount.h"
+#include "RecordBlock.h"
+
+using TDSVRowBlock = CRecordBlock< std::pmr::vector<std::pmr::string> >;
 
 class CDSVReader{
     private:
@@ -11,11 +20,24 @@ class CDSVReader{
         std::unique_ptr<SImplementation> DImplementation;
 
     public:
-        CDSVReader(std::shared_ptr< CDataSource > src, char delimiter);
+        CDSVReader(std::shared_ptr< CDataSource > src, char delimiter, std::shared_ptr< const CDSVIndex > index = nullptr, std::shared_ptr< CMemoryAccount > account = nullptr);
         ~CDSVReader();
 
         bool End() const;
         bool ReadRow(std::vector<std::string> &row);
+        bool ReadRow(std::pmr::vector<std::pmr::string> &row);
+        std::size_t ReadRows(TDSVRowBlock &block, std::size_t count);
+        CGenerator< std::vector<std::string> > Rows();
+
+        std::size_t Row() const;
+        std::size_t Offset() const;
+        bool SeekRow(std::size_t row);
+        bool Seek(std::size_t offset, std::size_t row);
+
+        SDSVCheckpoint Checkpoint() const;
+        bool Resume(const SDSVCheckpoint &checkpoint);
+
+        SIOStats Stats() const;
 };
 
 #endif
@@ -0,0 +1,32 @@
+#ifndef DSVSORTER_H
+#define DSVSORTER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "DSVReader.h"
+#include "DSVWriter.h"
+
+// stable sort of a DSV stream of any size, rows are gathered into runs that
+// fit the memory budget, each run is sorted in parallel and spilled, and the
+// runs are combined with a k-way loser tree merge
+class CDSVSorter{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        struct SKey{
+            std::size_t DColumn;
+            bool DNumeric = false;
+            bool DDescending = false;
+        };
+
+        CDSVSorter(std::vector< SKey > keys, std::size_t memorybudget = 64 << 20, const std::string &tempdir = "");
+        ~CDSVSorter();
+
+        bool Sort(CDSVReader &reader, CDSVWriter &writer);
+        std::size_t RunCount() const;
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef DSVSPILLFILE_H
+#define DSVSPILLFILE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// anonymous temporary file of rows in a compact binary form, a varint field
+// count followed by a varint length and the bytes of each field, rows are
+// written first and then read back after Rewind
+class CDSVSpillFile{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        CDSVSpillFile(const std::string &tempdir = "");
+        ~CDSVSpillFile();
+
+        bool IsOpen() const;
+        std::size_t Rows() const;
+        std::size_t Bytes() const;
+
+        bool WriteRow(const std::vector<std::string> &row);
+        bool Rewind();
+        bool ReadRow(std::vector<std::string> &row);
+
+        static std::string DefaultTempDir();
+};
+
+#endif
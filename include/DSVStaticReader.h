@@ -0,0 +1,170 @@
+#ifndef DSVSTATICREADER_H
+#define DSVSTATICREADER_H
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "DataSource.h"
+
+// how quote characters are treated, None reads '"' as ordinary data
+enum class EDSVQuoting{None, RFC4180};
+
+// which bytes end a row, Any accepts "\n", "\r\n" and a lone "\r" like CDSVReader
+enum class EDSVLineEnding{LF, CRLF, Any};
+
+// DSV reader with the format fixed at compile time, so byte classification
+// folds to constants and reads on a final source type skip the virtual
+// call, CDSVReader remains the reader for formats only known at runtime
+template <char Delimiter, EDSVQuoting Quoting = EDSVQuoting::RFC4180, EDSVLineEnding LineEnding = EDSVLineEnding::Any, typename TSource = CDataSource>
+class CDSVStaticReader{
+    static_assert(std::is_base_of_v<CDataSource, TSource>, "TSource must be a CDataSource");
+    static_assert(Delimiter != '\n' && Delimiter != '\r', "the delimiter cannot be a line ending");
+    static_assert(Quoting == EDSVQuoting::None || Delimiter != '"', "the delimiter cannot be the quote character");
+
+    private:
+        std::shared_ptr< TSource > DSource;
+        std::vector<char> DBuffer;
+        std::size_t DIndex = 0;
+        std::size_t DBlockSize;
+        std::size_t DRow = 0;
+
+        // true for the bytes that can end a field outside quotes
+        static constexpr bool Special(char ch) noexcept{
+            return ch == Delimiter || ch == '\n'
+                || (LineEnding != EDSVLineEnding::LF && ch == '\r')
+                || (Quoting == EDSVQuoting::RFC4180 && ch == '"');
+        }
+
+        // a final source type lets the compiler call its Read directly, any
+        // other type still reaches the override of the object it points to
+        bool SourceRead() noexcept{
+            return DSource->Read(DBuffer, DBlockSize);
+        }
+
+        bool SourceEnd() const noexcept{
+            return DSource->End();
+        }
+
+        // pulls the next block once the buffer is used up
+        bool Fill(){
+            if(DIndex < DBuffer.size()){
+                return true;
+            }
+            DIndex = 0;
+            if(!SourceRead()){
+                DBuffer.clear();
+                return false;
+            }
+            return true;
+        }
+
+        bool Peek(char &ch){
+            if(!Fill()){
+                return false;
+            }
+            ch = DBuffer[DIndex];
+            return true;
+        }
+
+        // the cleared string for a column, reusing the capacity left by earlier rows
+        static std::string &Slot(std::vector<std::string> &row, std::size_t column){
+            if(column == row.size()){
+                row.emplace_back();
+            }
+            row[column].clear();
+            return row[column];
+        }
+
+        // trims the row to the columns read, an empty line gives an empty row
+        static void EndRow(std::vector<std::string> &row, std::size_t column){
+            if(!row[column].empty() || column){
+                column++;
+            }
+            row.resize(column);
+        }
+
+    public:
+        CDSVStaticReader(std::shared_ptr< TSource > src, std::size_t blocksize = 65536)
+            : DSource(std::move(src)), DBlockSize(blocksize ? blocksize : 1){
+        }
+
+        bool End() const{
+            return DIndex >= DBuffer.size() && SourceEnd();
+        }
+
+        // number of the next row to be read, counting from zero
+        std::size_t Row() const{
+            return DRow;
+        }
+
+        // reads the next row with the same results CDSVReader gives for this format,
+        // the strings already in row are reused to avoid reallocating each field
+        bool ReadRow(std::vector<std::string> &row){
+            std::size_t Column = 0;
+            std::string *Field = &Slot(row, Column);
+            bool Quotes = false;
+            bool Data = false;
+            while(Fill()){
+                Data = true;
+                const char *Begin = DBuffer.data() + DIndex;
+                const char *Stop = DBuffer.data() + DBuffer.size();
+                const char *Ptr = Begin;
+                // copy the run of plain bytes in one go
+                if(Quoting == EDSVQuoting::RFC4180 && Quotes){
+                    while(Ptr < Stop && *Ptr != '"'){
+                        Ptr++;
+                    }
+                }
+                else{
+                    while(Ptr < Stop && !Special(*Ptr)){
+                        Ptr++;
+                    }
+                }
+                Field->append(Begin, Ptr);
+                DIndex += Ptr - Begin;
+                if(Ptr == Stop){
+                    continue;
+                }
+                char Ch = *Ptr;
+                DIndex++;
+                char Next;
+                if(Quoting == EDSVQuoting::RFC4180 && Ch == '"'){
+                    // two quotes in a row are a literal quote
+                    if(Peek(Next) && Next == '"'){
+                        DIndex++;
+                        *Field += '"';
+                    }
+                    else{
+                        Quotes = !Quotes;
+                    }
+                }
+                else if(Ch == Delimiter){
+                    Field = &Slot(row, ++Column);
+                }
+                else if(Ch == '\r'){
+                    bool LF = Peek(Next) && Next == '\n';
+                    if(LF){
+                        DIndex++;
+                    }
+                    if(LineEnding == EDSVLineEnding::CRLF && !LF){
+                        *Field += '\r';
+                        continue;
+                    }
+                    EndRow(row, Column);
+                    DRow++;
+                    return true;
+                }
+                else{
+                    EndRow(row, Column);
+                    DRow++;
+                    return true;
+                }
+            }
+            EndRow(row, Column);
+            DRow += Data;
+            return Data;
+        }
+};
+
+#endif
@@ -1,20 +1,109 @@
 #ifndef DSVWRITER_H
 #define DSVWRITER_H
 
+#include <algorithm>
+#include <charconv>
+#include <limits>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 #include "DataSink.h"
+#include "IOStats.h"
+#include "MemoryAccount.h"
 
 class CDSVWriter{
     private:
         struct SImplementation;
         std::unique_ptr<SImplementation> DImplementation;
 
+        // pieces the typed writers are built from, fields go straight into the
+        // row buffer and EndRow passes the buffer on once it holds enough rows
+        void BeginRow();
+        void AppendString(std::string_view field);
+        char *AppendSpace(std::size_t maxsize);
+        void EndSpace(char *end);
+        bool EndRow(std::size_t flushsize);
+
+        // longest text to_chars can produce for a T, floats use the shortest
+        // form that reads back to the same value
+        template <typename T>
+        static constexpr std::size_t MaxChars(){
+            if constexpr(std::is_floating_point_v<T>){
+                return 4 + std::numeric_limits<T>::max_digits10 + 8;
+            }
+            else{
+                return 2 + std::numeric_limits<T>::digits10 + 1;
+            }
+        }
+
+        // numbers and booleans can never hold a quote or newline, so they skip
+        // the quoting analysis strings go through
+        template <typename T>
+        void AppendField(const T &field){
+            if constexpr(std::is_same_v<T, bool>){
+                std::string_view Text = field ? "true" : "false";
+                char *Begin = AppendSpace(Text.size());
+                EndSpace(std::copy(Text.begin(), Text.end(), Begin));
+            }
+            else if constexpr(std::is_same_v<T, char>){
+                AppendString(std::string_view(&field, 1));
+            }
+            else if constexpr(std::is_arithmetic_v<T>){
+                char *Begin = AppendSpace(MaxChars<T>());
+                EndSpace(std::to_chars(Begin, Begin + MaxChars<T>(), field).ptr);
+            }
+            else{
+                static_assert(std::is_convertible_v<const T &, std::string_view>, "DSV fields must be numbers, booleans or strings");
+                AppendString(std::string_view(field));
+            }
+        }
+
     public:
-        CDSVWriter(std::shared_ptr< CDataSink > sink, char delimiter, bool quoteall = false);
+        CDSVWriter(std::shared_ptr< CDataSink > sink, char delimiter, bool quoteall = false, std::shared_ptr< CMemoryAccount > account = nullptr);
         ~CDSVWriter();
 
         bool WriteRow(const std::vector<std::string> &row);
+
+        // writes one field per argument, for example WriteRow("id", 42, 1.5, true)
+        template <typename... TFields>
+        bool WriteRow(const TFields &...fields){
+            BeginRow();
+            (AppendField(fields), ...);
+            return EndRow(0);
+        }
+
+        template <typename... TFields>
+        bool WriteRow(const std::tuple<TFields...> &row){
+            return std::apply([this](const TFields &...fields){ return WriteRow(fields...); }, row);
+        }
+
+        // writes row i from element i of every column, each column is any
+        // indexable container with a size such as a vector or span, rows are
+        // batched so the sink sees a few large writes instead of one per row
+        template <typename... TColumns>
+        bool WriteColumns(const TColumns &...columns){
+            static_assert(sizeof...(TColumns) > 0, "WriteColumns needs at least one column");
+            const std::size_t Rows = std::get<0>(std::tie(columns...)).size();
+            if(((columns.size() != Rows) || ...)){
+                return false;
+            }
+            for(std::size_t Index = 0; Index < Rows; Index++){
+                BeginRow();
+                (AppendField(columns[Index]), ...);
+                if(!EndRow(Index + 1 < Rows ? ColumnsFlushSize : 0)){
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        SIOStats Stats() const;
+
+        // buffered bytes that make WriteColumns pass its rows to the sink
+        static const std::size_t ColumnsFlushSize = 1 << 16;
 };
 
 #endif
@@ -0,0 +1,68 @@
+#ifndef DSVZONEMAP_H
+#define DSVZONEMAP_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "DataSink.h"
+#include "SeekableDataSource.h"
+
+// per block, per column statistics for a DSV stream so filtered scans can
+// skip blocks whose rows cannot satisfy a predicate
+class CDSVZoneMap{
+    public:
+        // bloom filter bits given to each row of a block when the size is not
+        // picked, and the most any one filter gets
+        static constexpr std::size_t BloomBitsPerRow = 10;
+        static constexpr std::size_t MaxBloomBits = 1 << 15;
+
+        struct SColumnStats{
+            std::size_t DNullCount = 0;
+            std::size_t DNumericCount = 0;
+            double DMin = 0;
+            double DMax = 0;
+            std::vector< std::uint64_t > DBloom;
+        };
+
+        struct SBlock{
+            std::size_t DRow;
+            std::size_t DRowCount;
+            std::size_t DOffset;
+            std::vector< SColumnStats > DColumns;
+        };
+
+        struct SPredicate{
+            enum class EOp{Equal, Less, LessEqual, Greater, GreaterEqual, Empty, NotEmpty};
+            std::size_t DColumn;
+            EOp DOp;
+            std::string DValue;
+
+            bool Matches(const std::vector< std::string > &row) const;
+        };
+
+    private:
+        std::size_t DBlockRows;
+        std::size_t DBloomWords;
+        std::vector< SBlock > DBlocks;
+
+    public:
+        // bloombits sizes each column's filter, zero sizes it from blockrows
+        CDSVZoneMap(std::size_t blockrows = 4096, std::size_t bloombits = 0);
+
+        std::size_t BlockRows() const noexcept;
+        std::size_t BloomBits() const noexcept;
+        const std::vector< SBlock > &Blocks() const noexcept;
+
+        bool MayMatch(std::size_t block, const std::vector< SPredicate > &preds) const;
+        std::vector< std::size_t > CandidateBlocks(const std::vector< SPredicate > &preds) const;
+
+        bool Build(std::shared_ptr< CDataSource > src, char delimiter);
+        bool Save(std::shared_ptr< CDataSink > sink) const;
+        bool Load(std::shared_ptr< CDataSource > src);
+
+        bool Scan(std::shared_ptr< CSeekableDataSource > src, char delimiter, const std::vector< SPredicate > &preds, const std::function< bool(const std::vector< std::string > &) > &callback) const;
+};
+
+#endif
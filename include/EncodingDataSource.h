@@ -0,0 +1,44 @@
+#ifndef ENCODINGDATASOURCE_H
+#define ENCODINGDATASOURCE_H
+
+#include <memory>
+#include <string_view>
+#include "DataSource.h"
+
+enum class EEncoding{Auto, UTF8, Latin1, UTF16LE, UTF16BE};
+
+// what happens to a malformed UTF-8 or UTF-16 sequence, Reject ends the
+// output before it, Replace writes U+FFFD for it and PassThrough keeps the
+// bytes as they were, or encodes a lone UTF-16 surrogate as is
+enum class EInvalidPolicy{Reject, Replace, PassThrough};
+
+// source decorator that hands on its input as UTF-8, so it can sit in front
+// of CDSVReader or CXMLReader, Auto picks the encoding from a byte order mark,
+// then from the zero bytes of UTF-16 text, and otherwise reads UTF-8 if the
+// first block is valid UTF-8 and Latin-1 if not, byte order marks are dropped
+class CEncodingDataSource : public CDataSource{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        CEncodingDataSource(std::shared_ptr< CDataSource > src, EEncoding encoding = EEncoding::Auto, EInvalidPolicy policy = EInvalidPolicy::Replace, std::size_t blocksize = 1 << 16);
+        ~CEncodingDataSource();
+
+        // the encoding being read, Auto until the first block has been seen
+        EEncoding Encoding() const noexcept;
+        // true once Reject has stopped the output at a malformed sequence
+        bool Failed() const noexcept;
+        // malformed sequences replaced or passed through so far
+        std::size_t InvalidSequences() const noexcept;
+
+        bool End() const noexcept override;
+        bool Get(char &ch) noexcept override;
+        bool Peek(char &ch) noexcept override;
+        bool Read(std::vector<char> &buf, std::size_t count) noexcept override;
+
+        // length of the longest prefix of data that is well formed UTF-8
+        static std::size_t ValidUTF8Length(std::string_view data) noexcept;
+};
+
+#endif
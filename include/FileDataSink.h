@@ -0,0 +1,42 @@
+#ifndef FILEDATASINK_H
+#define FILEDATASINK_H
+
+#include "DataSink.h"
+#include <memory>
+#include <string>
+
+// buffered sink over a file created or truncated at path, the buffer is
+// written out when full, on Flush and when the sink is destroyed
+class CFileDataSink : public CDataSink{
+    private:
+        int DHandle;
+        bool DOwned;
+        std::vector<char> DBuffer;
+        std::size_t DLength;
+        std::size_t DWritten;
+
+        // picks the resume constructor, which would otherwise take the same
+        // arguments as the truncating one
+        struct SResume{};
+
+        CFileDataSink(SResume, const std::string &path, std::size_t resumeoffset, std::size_t buffersize);
+        bool WriteAll(const char *data, std::size_t length) noexcept;
+    public:
+        CFileDataSink(const std::string &path, std::size_t buffersize = 1 << 16);
+        CFileDataSink(int fd, bool owned, std::size_t buffersize = 1 << 16);
+        ~CFileDataSink();
+
+        // reopens a partly written file to append from resumeoffset, anything
+        // past it is cut off, the sink is not open if the file is shorter than that
+        static std::shared_ptr< CFileDataSink > Resume(const std::string &path, std::size_t resumeoffset, std::size_t buffersize = 1 << 16);
+
+        bool IsOpen() const noexcept;
+        bool Flush() noexcept;
+        // bytes written through the sink, buffered ones included, plus the resume offset
+        std::size_t Offset() const noexcept;
+
+        bool Put(const char &ch) noexcept override;
+        bool Write(const std::vector<char> &buf) noexcept override;
+};
+
+#endif
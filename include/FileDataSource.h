@@ -0,0 +1,39 @@
+#ifndef FILEDATASOURCE_H
+#define FILEDATASOURCE_H
+
+#include "SeekableDataSource.h"
+#include <future>
+#include <memory>
+#include <string>
+
+class CFileDataSource final : public CSeekableDataSource{
+    private:
+        int DHandle;
+        std::size_t DSize;
+        mutable std::vector<char> DBuffer;
+        mutable std::size_t DBufferOffset;
+        mutable std::size_t DBufferIndex;
+        mutable std::size_t DBufferLength;
+
+        bool Fill() const noexcept;
+    public:
+        CFileDataSource(const std::string &path, std::size_t buffersize = 1 << 16);
+        ~CFileDataSource();
+
+        bool IsOpen() const noexcept;
+
+        bool End() const noexcept override;
+        bool Get(char &ch) noexcept override;
+        bool Peek(char &ch) noexcept override;
+        bool Read(std::vector<char> &buf, std::size_t count) noexcept override;
+
+        bool Seek(std::size_t offset) noexcept override;
+        std::size_t Tell() const noexcept override;
+        std::size_t Size() const noexcept override;
+
+        // opens a file and reads its first block on another thread, so it is
+        // ready by the time the file before it has been drained
+        static std::future< std::unique_ptr< CFileDataSource > > OpenAhead(const std::string &path, std::size_t buffersize = 1 << 16);
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+// lazy range produced by a coroutine that co_yields lvalues of T, each
+// element is a reference into the coroutine, so a reused buffer is handed
+// out again on every step and is only valid until the next increment
+template <typename T>
+class CGenerator{
+    public:
+        struct promise_type{
+            T *DValue = nullptr;
+            std::exception_ptr DException;
+
+            CGenerator get_return_object() noexcept{
+                return CGenerator(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept{ return {}; }
+            std::suspend_always final_suspend() noexcept{ return {}; }
+            std::suspend_always yield_value(T &value) noexcept{
+                DValue = std::addressof(value);
+                return {};
+            }
+            void return_void() noexcept{}
+            void unhandled_exception() noexcept{ DException = std::current_exception(); }
+        };
+
+        struct SSentinel{};
+
+        class CIterator{
+            private:
+                std::coroutine_handle<promise_type> DHandle;
+
+                // runs the coroutine to its next element and rethrows its failures
+                void Advance(){
+                    DHandle.resume();
+                    if(DHandle.done() && DHandle.promise().DException){
+                        std::rethrow_exception(std::exchange(DHandle.promise().DException, nullptr));
+                    }
+                }
+
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using difference_type = std::ptrdiff_t;
+                using value_type = T;
+                using reference = T &;
+                using pointer = T *;
+
+                CIterator() = default;
+                explicit CIterator(std::coroutine_handle<promise_type> handle) : DHandle(handle){
+                    Advance();
+                }
+
+                reference operator*() const{ return *DHandle.promise().DValue; }
+                pointer operator->() const{ return DHandle.promise().DValue; }
+                CIterator &operator++(){
+                    Advance();
+                    return *this;
+                }
+                void operator++(int){ ++*this; }
+                bool operator==(SSentinel) const noexcept{ return !DHandle || DHandle.done(); }
+        };
+
+    private:
+        std::coroutine_handle<promise_type> DHandle;
+
+        explicit CGenerator(std::coroutine_handle<promise_type> handle) noexcept : DHandle(handle){}
+
+    public:
+        CGenerator(CGenerator &&other) noexcept : DHandle(std::exchange(other.DHandle, nullptr)){}
+        CGenerator &operator=(CGenerator &&other) noexcept{
+            if(this != &other){
+                if(DHandle){
+                    DHandle.destroy();
+                }
+                DHandle = std::exchange(other.DHandle, nullptr);
+            }
+            return *this;
+        }
+        ~CGenerator(){
+            if(DHandle){
+                DHandle.destroy();
+            }
+        }
+
+        // starts the coroutine, a generator can only be iterated once
+        CIterator begin(){ return CIterator(DHandle); }
+        SSentinel end() noexcept{ return {}; }
+};
+
+#endif
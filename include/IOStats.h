@@ -0,0 +1,118 @@
+#ifndef IOSTATS_H
+#define IOSTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// counters are only collected when built with ENABLE_IOSTATS (make STATS=1),
+// otherwise every update below is an empty inline function
+
+// a point in time copy of one reader or writer's counters, DIONanoseconds is
+// time spent in source reads or sink writes and DProcessNanoseconds the rest
+struct SIOStats{
+    enum class EKind{DSVReader, DSVWriter, XMLReader, XMLWriter};
+    EKind DKind = EKind::DSVReader;
+    std::uint64_t DId = 0;
+    std::uint64_t DBytes = 0;
+    std::uint64_t DRecords = 0;
+    std::uint64_t DMaxFieldSize = 0;
+    std::uint64_t DMaxRecordSize = 0;
+    std::uint64_t DQuotedFields = 0;
+    std::uint64_t DParseCalls = 0;
+    std::uint64_t DQueueHighWater = 0;
+    std::uint64_t DIONanoseconds = 0;
+    std::uint64_t DProcessNanoseconds = 0;
+};
+
+// live counters owned by one reader or writer, only the owning thread writes
+// them so updates are plain relaxed load and store pairs, the registry reads
+// them from other threads
+class CIOStatsCounters{
+    private:
+#ifdef ENABLE_IOSTATS
+        SIOStats::EKind DKind;
+        std::uint64_t DId;
+        std::atomic<std::uint64_t> DBytes{0};
+        std::atomic<std::uint64_t> DRecords{0};
+        std::atomic<std::uint64_t> DMaxFieldSize{0};
+        std::atomic<std::uint64_t> DMaxRecordSize{0};
+        std::atomic<std::uint64_t> DQuotedFields{0};
+        std::atomic<std::uint64_t> DParseCalls{0};
+        std::atomic<std::uint64_t> DQueueHighWater{0};
+        std::atomic<std::uint64_t> DIONanoseconds{0};
+        std::atomic<std::uint64_t> DProcessNanoseconds{0};
+
+        static void Add(std::atomic<std::uint64_t> &counter, std::uint64_t value) noexcept{
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        static void Max(std::atomic<std::uint64_t> &counter, std::uint64_t value) noexcept{
+            if(value > counter.load(std::memory_order_relaxed)){
+                counter.store(value, std::memory_order_relaxed);
+            }
+        }
+#endif
+
+    public:
+#ifdef ENABLE_IOSTATS
+        static constexpr bool Enabled = true;
+#else
+        static constexpr bool Enabled = false;
+#endif
+
+        CIOStatsCounters(SIOStats::EKind kind);
+        ~CIOStatsCounters();
+        CIOStatsCounters(const CIOStatsCounters &) = delete;
+        CIOStatsCounters &operator=(const CIOStatsCounters &) = delete;
+
+        SIOStats Snapshot() const;
+
+#ifdef ENABLE_IOSTATS
+        void AddBytes(std::uint64_t count) noexcept{ Add(DBytes, count); }
+        void AddRecord(std::uint64_t size) noexcept{ Add(DRecords, 1); Max(DMaxRecordSize, size); }
+        void AddField(std::uint64_t size, bool quoted) noexcept{ Max(DMaxFieldSize, size); Add(DQuotedFields, quoted); }
+        void AddParseCall() noexcept{ Add(DParseCalls, 1); }
+        void QueueDepth(std::uint64_t depth) noexcept{ Max(DQueueHighWater, depth); }
+        void AddIOTime(std::uint64_t nanoseconds) noexcept{ Add(DIONanoseconds, nanoseconds); }
+        void AddProcessTime(std::uint64_t nanoseconds) noexcept{ Add(DProcessNanoseconds, nanoseconds); }
+        std::uint64_t IOTime() const noexcept{ return DIONanoseconds.load(std::memory_order_relaxed); }
+#else
+        void AddBytes(std::uint64_t) noexcept{}
+        void AddRecord(std::uint64_t) noexcept{}
+        void AddField(std::uint64_t, bool) noexcept{}
+        void AddParseCall() noexcept{}
+        void QueueDepth(std::uint64_t) noexcept{}
+        void AddIOTime(std::uint64_t) noexcept{}
+        void AddProcessTime(std::uint64_t) noexcept{}
+        std::uint64_t IOTime() const noexcept{ return 0; }
+#endif
+};
+
+// measures from construction, reads the clock only when statistics are enabled
+class CIOStatsTimer{
+    private:
+#ifdef ENABLE_IOSTATS
+        std::chrono::steady_clock::time_point DStart = std::chrono::steady_clock::now();
+#endif
+
+    public:
+#ifdef ENABLE_IOSTATS
+        std::uint64_t Nanoseconds() const noexcept{
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - DStart).count();
+        }
+#else
+        std::uint64_t Nanoseconds() const noexcept{ return 0; }
+#endif
+};
+
+// every live reader and writer registers its counters here
+class CIOStatsRegistry{
+    public:
+        static void Register(const CIOStatsCounters *counters);
+        static void Unregister(const CIOStatsCounters *counters);
+        static std::vector< SIOStats > Snapshot();
+};
+
+#endif
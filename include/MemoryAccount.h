@@ -0,0 +1,62 @@
+#ifndef MEMORYACCOUNT_H
+#define MEMORYACCOUNT_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+// a point in time copy of one account, DRefused counts requests turned down by the limit
+struct SMemoryStats{
+    std::string DName;
+    std::uint64_t DLive = 0;
+    std::uint64_t DPeak = 0;
+    std::uint64_t DLimit = 0;
+    std::uint64_t DRefused = 0;
+};
+
+// memory resource that counts the live and peak bytes of the component it is
+// given to, allocations pass through to upstream, buffers that do not come
+// from a resource are counted with Charge and Credit, a limit of zero means
+// none, over the limit an allocation throws std::bad_alloc and Charge returns
+// false, which readers, writers and sinks turn into a failed read or write,
+// every live account can be listed with Snapshot
+class CMemoryAccount : public std::pmr::memory_resource{
+    private:
+        std::string DName;
+        std::size_t DLimit;
+        std::pmr::memory_resource *DUpstream;
+        std::atomic<std::size_t> DLive{0};
+        std::atomic<std::size_t> DPeak{0};
+        std::atomic<std::size_t> DRefused{0};
+
+    protected:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+    public:
+        CMemoryAccount(std::string name, std::size_t limit = 0, std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+        ~CMemoryAccount();
+        CMemoryAccount(const CMemoryAccount &) = delete;
+        CMemoryAccount &operator=(const CMemoryAccount &) = delete;
+
+        const std::string &Name() const noexcept;
+        std::size_t Live() const noexcept;
+        std::size_t Peak() const noexcept;
+        std::size_t Limit() const noexcept;
+        // true once the limit has turned down a request
+        bool Exceeded() const noexcept;
+        SMemoryStats Stats() const;
+
+        bool Charge(std::size_t bytes) noexcept;
+        void Credit(std::size_t bytes) noexcept;
+        // charges or credits the difference so a buffer counted as charged is
+        // counted as bytes, leaves charged alone and returns false if growing is refused
+        bool Resize(std::size_t &charged, std::size_t bytes) noexcept;
+
+        static std::vector< SMemoryStats > Snapshot();
+};
+
+#endif
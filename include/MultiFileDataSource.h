@@ -0,0 +1,38 @@
+#ifndef MULTIFILEDATASOURCE_H
+#define MULTIFILEDATASOURCE_H
+
+#include "DataSource.h"
+#include <memory>
+#include <string>
+
+// source that reads a list of files back to back as one stream, the next
+// file is opened and its first block read in the background while the
+// current one is drained, with dsvheader set every file is taken to start
+// with a DSV header row, a later file's header is dropped when it matches
+// the first file's, and a file that does not end in a newline gets one
+class CMultiFileDataSource : public CDataSource{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        CMultiFileDataSource(std::vector< std::string > paths, bool dsvheader = false, std::size_t buffersize = 1 << 16);
+        ~CMultiFileDataSource();
+
+        // index into paths of the file being read
+        std::size_t FileIndex() const noexcept;
+        // true once a file could not be opened, the stream ends before it
+        bool Failed() const noexcept;
+        // later headers that differed from the first and were kept as rows
+        std::size_t HeaderMismatches() const noexcept;
+
+        bool End() const noexcept override;
+        bool Get(char &ch) noexcept override;
+        bool Peek(char &ch) noexcept override;
+        bool Read(std::vector<char> &buf, std::size_t count) noexcept override;
+
+        // regular files matching a shell pattern, or in a directory, sorted by name
+        static std::vector< std::string > Glob(const std::string &pattern);
+};
+
+#endif
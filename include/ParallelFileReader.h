@@ -0,0 +1,47 @@
+#ifndef PARALLELFILEREADER_H
+#define PARALLELFILEREADER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "DataSource.h"
+#include "XMLEntity.h"
+#include "ThreadPool.h"
+
+// reads a list of files on several workers at once, each file whole on one
+// worker with its own reader, files are dealt out largest first to the least
+// loaded worker, a worker that runs dry steals the smallest file left from
+// the busiest one, and the file a worker will take next is opened and its
+// first block read while the current one is drained, callbacks run on the
+// workers concurrently and the worker index lets them keep per worker state
+class CParallelFileReader{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        using TFileCallback = std::function<bool(std::size_t worker, std::size_t file, std::shared_ptr< CDataSource > source)>;
+        using TDSVRowCallback = std::function<void(std::size_t worker, std::size_t file, const std::vector< std::string > &row)>;
+        using TXMLEntityCallback = std::function<void(std::size_t worker, std::size_t file, const SXMLEntity &entity)>;
+
+        // workers of zero means one per thread of the pool, which defaults to the shared pool
+        CParallelFileReader(std::vector< std::string > paths, std::size_t workers = 0, CThreadPool *pool = nullptr, std::size_t buffersize = 1 << 16);
+        ~CParallelFileReader();
+
+        std::size_t WorkerCount() const noexcept;
+        // files taken from another worker's queue in the last run
+        std::size_t StolenFiles() const noexcept;
+        // indices of the files that could not be opened or read in the last run, sorted
+        std::vector< std::size_t > FailedFiles() const;
+
+        // hands every file to callback on some worker, a false return marks it failed,
+        // returns true if no file failed
+        bool ForEachFile(const TFileCallback &callback);
+        // reads every file with a CDSVReader, dropping each file's first row when asked
+        bool ReadDSV(char delimiter, bool skipheader, const TDSVRowCallback &callback);
+        // reads every file with a CXMLReader
+        bool ReadXML(bool skipcdata, const TXMLEntityCallback &callback);
+};
+
+#endif
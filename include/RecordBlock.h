@@ -0,0 +1,75 @@
+#ifndef RECORDBLOCK_H
+#define RECORDBLOCK_H
+
+#include <memory_resource>
+#include <vector>
+
+// a batch of records filled by the readers' batch calls, records past Size()
+// are kept with their capacity so later batches refill them without
+// allocating, everything is carved from the resource given at construction,
+// so an arena per batch means a block per batch while a pool can back one
+// long lived block
+template <typename T>
+class CRecordBlock{
+    private:
+        std::pmr::vector<T> DRecords;
+        std::size_t DSize = 0;
+
+    public:
+        using iterator = typename std::pmr::vector<T>::iterator;
+        using const_iterator = typename std::pmr::vector<T>::const_iterator;
+
+        explicit CRecordBlock(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+            : DRecords(resource){
+        }
+
+        std::size_t Size() const{
+            return DSize;
+        }
+
+        bool Empty() const{
+            return !DSize;
+        }
+
+        // records held for reuse, filled or not
+        std::size_t Capacity() const{
+            return DRecords.size();
+        }
+
+        std::pmr::memory_resource *Resource() const{
+            return DRecords.get_allocator().resource();
+        }
+
+        T &operator[](std::size_t index){
+            return DRecords[index];
+        }
+
+        const T &operator[](std::size_t index) const{
+            return DRecords[index];
+        }
+
+        iterator begin(){ return DRecords.begin(); }
+        iterator end(){ return DRecords.begin() + DSize; }
+        const_iterator begin() const{ return DRecords.begin(); }
+        const_iterator end() const{ return DRecords.begin() + DSize; }
+
+        // the record after the last filled one, still holding its old contents
+        T &Next(){
+            if(DSize == DRecords.size()){
+                DRecords.emplace_back();
+            }
+            return DRecords[DSize];
+        }
+
+        // counts the record returned by Next as filled
+        void Commit(){
+            DSize++;
+        }
+
+        // empties the block but keeps the records for reuse
+        void Clear(){
+            DSize = 0;
+        }
+};
+
+#endif
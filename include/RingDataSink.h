@@ -0,0 +1,25 @@
+#ifndef RINGDATASINK_H
+#define RINGDATASINK_H
+
+#include "DataSink.h"
+#include "SPSCRing.h"
+#include <memory>
+
+class CRingDataSink : public CDataSink{
+    private:
+        std::shared_ptr< CSPSCRing > DRing;
+        char *DSpan;
+        std::size_t DSpanLength;
+        bool DClosed;
+    public:
+        CRingDataSink(std::shared_ptr< CSPSCRing > ring);
+        ~CRingDataSink();
+
+        bool Put(const char &ch) noexcept override;
+        bool Write(const std::vector<char> &buf) noexcept override;
+        bool Write(const char *data, std::size_t length) noexcept;
+        bool Flush() noexcept;
+        void Close() noexcept;
+};
+
+#endif
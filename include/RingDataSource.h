@@ -0,0 +1,25 @@
+#ifndef RINGDATASOURCE_H
+#define RINGDATASOURCE_H
+
+#include "DataSource.h"
+#include "SPSCRing.h"
+#include <memory>
+
+class CRingDataSource : public CDataSource{
+    private:
+        std::shared_ptr< CSPSCRing > DRing;
+        mutable const char *DSpan;
+        mutable std::size_t DSpanLength;
+
+        bool Fill() const noexcept;
+    public:
+        CRingDataSource(std::shared_ptr< CSPSCRing > ring);
+        ~CRingDataSource();
+
+        bool End() const noexcept override;
+        bool Get(char &ch) noexcept override;
+        bool Peek(char &ch) noexcept override;
+        bool Read(std::vector<char> &buf, std::size_t count) noexcept override;
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <cstddef>
+#include <memory>
+
+// lock-free single producer single consumer byte ring, each side reserves or
+// acquires a contiguous span, advances through it locally and publishes its
+// position in batches, blocked sides spin briefly and then sleep on a futex
+class CSPSCRing{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        CSPSCRing(std::size_t capacity = 1 << 16, std::size_t batch = 0);
+        ~CSPSCRing();
+
+        std::size_t Capacity() const noexcept;
+
+        // producer side
+        std::size_t Reserve(char *&ptr) noexcept;
+        void Produce(std::size_t count) noexcept;
+        void Flush() noexcept;
+        void CloseProducer() noexcept;
+
+        // consumer side
+        std::size_t Acquire(const char *&ptr) noexcept;
+        void Consume(std::size_t count) noexcept;
+        void CloseConsumer() noexcept;
+};
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef SEEKABLEDATASOURCE_H
+#define SEEKABLEDATASOURCE_H
+
+#include "DataSource.h"
+#include <cstddef>
+
+class CSeekableDataSource : public CDataSource{
+    public:
+        virtual ~CSeekableDataSource(){};
+        virtual bool Seek(std::size_t offset) noexcept = 0;
+        virtual std::size_t Tell() const noexcept = 0;
+        virtual std::size_t Size() const noexcept = 0;
+};
+
+#endif
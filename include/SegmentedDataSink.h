@@ -0,0 +1,40 @@
+#ifndef SEGMENTEDDATASINK_H
+#define SEGMENTEDDATASINK_H
+
+#include "DataSink.h"
+#include "MemoryAccount.h"
+#include <memory>
+#include <string>
+
+// sink that appends into fixed size chunks, so growing never reallocates or
+// copies what was already written, TakeChunks hands the chunks on as they
+// are, for instance to a CSegmentedDataSource, and String joins them only when asked
+class CSegmentedDataSink : public CDataSink{
+    public:
+        using TChunk = std::shared_ptr< const std::string >;
+
+    private:
+        std::vector< std::shared_ptr< std::string > > DChunks;
+        std::size_t DChunkSize;
+        std::size_t DSize;
+        std::shared_ptr< CMemoryAccount > DAccount;
+        std::size_t DCharged = 0;
+
+        std::string *Tail();
+    public:
+        // each chunk is charged to the account until it is taken, a write
+        // that needs a chunk past the account's limit fails part way
+        CSegmentedDataSink(std::size_t chunksize = 1 << 16, std::shared_ptr< CMemoryAccount > account = nullptr);
+        ~CSegmentedDataSink();
+
+        std::size_t Size() const noexcept;
+        std::size_t ChunkCount() const noexcept;
+        std::string String() const;
+        std::vector< TChunk > TakeChunks();
+
+        bool Put(const char &ch) noexcept override;
+        bool Write(const std::vector<char> &buf) noexcept override;
+        bool Write(const char *data, std::size_t length) noexcept;
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef SEGMENTEDDATASOURCE_H
+#define SEGMENTEDDATASOURCE_H
+
+#include "SeekableDataSource.h"
+#include <memory>
+#include <string>
+
+// source that reads a sequence of shared chunks as one stream, such as the
+// chunks taken from a CSegmentedDataSink, without joining them first
+class CSegmentedDataSource : public CSeekableDataSource{
+    public:
+        using TChunk = std::shared_ptr< const std::string >;
+
+    private:
+        std::vector< TChunk > DChunks;
+        std::vector< std::size_t > DStarts;
+        std::size_t DSize;
+        std::size_t DChunk;
+        std::size_t DIndex;
+
+        void Settle() noexcept;
+    public:
+        CSegmentedDataSource(std::vector< TChunk > chunks);
+
+        bool End() const noexcept override;
+        bool Get(char &ch) noexcept override;
+        bool Peek(char &ch) noexcept override;
+        bool Read(std::vector<char> &buf, std::size_t count) noexcept override;
+
+        bool Seek(std::size_t offset) noexcept override;
+        std::size_t Tell() const noexcept override;
+        std::size_t Size() const noexcept override;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef STRINGCOLUMN_H
+#define STRINGCOLUMN_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// a column of strings packed into one contiguous byte arena, field i is
+// DData[DOffsets[i], DOffsets[i + 1])
+struct SStringColumn{
+    std::vector< char > DData;
+    std::vector< std::size_t > DOffsets{0};
+
+    SStringColumn() = default;
+
+    SStringColumn(const std::vector< std::string > &strs){
+        std::size_t Total = 0;
+        for(auto &Str : strs){
+            Total += Str.size();
+        }
+        DData.reserve(Total);
+        DOffsets.reserve(strs.size() + 1);
+        for(auto &Str : strs){
+            Append(Str);
+        }
+    };
+
+    std::size_t Size() const{
+        return DOffsets.size() - 1;
+    };
+
+    std::string_view Field(std::size_t index) const{
+        return std::string_view(DData.data() + DOffsets[index], DOffsets[index + 1] - DOffsets[index]);
+    };
+
+    std::string String(std::size_t index) const{
+        return std::string(Field(index));
+    };
+
+    void Append(std::string_view str){
+        DData.insert(DData.end(), str.begin(), str.end());
+        DOffsets.push_back(DData.size());
+    };
+
+    void Clear(){
+        DData.clear();
+        DOffsets.assign(1, 0);
+    };
+
+    std::vector< std::string > Strings() const{
+        std::vector< std::string > Result;
+        Result.reserve(Size());
+        for(std::size_t Index = 0; Index < Size(); Index++){
+            Result.emplace_back(Field(Index));
+        }
+        return Result;
+    };
+};
+
+#endif
@@ -2,12 +2,24 @@
 #define STRINGDATASINK_H
 
 #include "DataSink.h"
+#include "MemoryAccount.h"
+#include <memory>
 #include <string>
 
 class CStringDataSink : public CDataSink{
     private:
         std::string DString;
+        std::shared_ptr< CMemoryAccount > DAccount;
+        std::size_t DCharged = 0;
+
+        bool Reserve(std::size_t length) noexcept;
     public:
+        CStringDataSink() = default;
+        // the string's capacity is charged to the account, a write that would
+        // take it over the account's limit fails and leaves the string as it was
+        explicit CStringDataSink(std::shared_ptr< CMemoryAccount > account);
+        ~CStringDataSink();
+
         const std::string &String() const;
 
         bool Put(const char &ch) noexcept override;
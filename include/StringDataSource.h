@@ -1,20 +1,33 @@
 #ifndef STRINGDATASOURCE_H
 #define STRINGDATASOURCE_H
 
-#include "DataSource.h"
+#include "SeekableDataSource.h"
+#include <memory>
 #include <string>
+#include <string_view>
 
-class CStringDataSource : public CDataSource{
+// source over an in-memory string, which can be copied or moved in, shared
+// with other owners, or borrowed as a view the caller keeps alive
+class CStringDataSource final : public CSeekableDataSource{
     private:
-        std::string DString;
+        std::shared_ptr< const std::string > DOwner;
+        std::string_view DString;
         size_t DIndex;
     public:
         CStringDataSource(const std::string &str);
+        CStringDataSource(std::string &&str);
+        CStringDataSource(const char *str);
+        CStringDataSource(std::shared_ptr< const std::string > str);
+        CStringDataSource(std::string_view str);
 
         bool End() const noexcept override;
         bool Get(char &ch) noexcept override;
         bool Peek(char &ch) noexcept override;
         bool Read(std::vector<char> &buf, std::size_t count) noexcept override;
+
+        bool Seek(std::size_t offset) noexcept override;
+        std::size_t Tell() const noexcept override;
+        std::size_t Size() const noexcept override;
 };
 
 #endif
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include "StringColumn.h"
 
 namespace StringUtils{
     
@@ -22,6 +23,30 @@ std::string Join(const std::string &str, const std::vector< std::string > &vect)
 std::string ExpandTabs(const std::string &str, int tabsize = 4) noexcept;
 int EditDistance(const std::string &left, const std::string &right, bool ignorecase=false) noexcept;
 
+// column batch versions, each writes every output field into one arena and
+// splits large columns across the shared thread pool
+SStringColumn Upper(const SStringColumn &col) noexcept;
+SStringColumn Lower(const SStringColumn &col) noexcept;
+SStringColumn LStrip(const SStringColumn &col) noexcept;
+SStringColumn RStrip(const SStringColumn &col) noexcept;
+SStringColumn Strip(const SStringColumn &col) noexcept;
+SStringColumn Center(const SStringColumn &col, int width, char fill = ' ') noexcept;
+SStringColumn LJust(const SStringColumn &col, int width, char fill = ' ') noexcept;
+SStringColumn RJust(const SStringColumn &col, int width, char fill = ' ') noexcept;
+SStringColumn Replace(const SStringColumn &col, const std::string &old, const std::string &rep) noexcept;
+SStringColumn ExpandTabs(const SStringColumn &col, int tabsize = 4) noexcept;
+
+SStringColumn Upper(const std::vector< std::string > &col) noexcept;
+SStringColumn Lower(const std::vector< std::string > &col) noexcept;
+SStringColumn LStrip(const std::vector< std::string > &col) noexcept;
+SStringColumn RStrip(const std::vector< std::string > &col) noexcept;
+SStringColumn Strip(const std::vector< std::string > &col) noexcept;
+SStringColumn Center(const std::vector< std::string > &col, int width, char fill = ' ') noexcept;
+SStringColumn LJust(const std::vector< std::string > &col, int width, char fill = ' ') noexcept;
+SStringColumn RJust(const std::vector< std::string > &col, int width, char fill = ' ') noexcept;
+SStringColumn Replace(const std::vector< std::string > &col, const std::string &old, const std::string &rep) noexcept;
+SStringColumn ExpandTabs(const std::vector< std::string > &col, int tabsize = 4) noexcept;
+
 }
 
 #endif
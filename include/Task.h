@@ -0,0 +1,113 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+// lazily started coroutine whose result is collected with co_await, the
+// awaiting coroutine is resumed directly when the task finishes so chains of
+// tasks run without growing the stack, top level tasks go to CAsyncScheduler::Spawn
+template <typename T = void>
+class CTask;
+
+namespace TaskDetail{
+
+// resumes whoever awaited the task once it has finished
+struct SFinalAwaiter{
+    bool await_ready() const noexcept{ return false; }
+    template <typename TPromise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> handle) noexcept{
+        auto Continuation = handle.promise().DContinuation;
+        return Continuation ? Continuation : std::noop_coroutine();
+    }
+    void await_resume() const noexcept{}
+};
+
+struct SPromiseBase{
+    std::coroutine_handle<> DContinuation;
+    std::exception_ptr DException;
+
+    std::suspend_always initial_suspend() noexcept{ return {}; }
+    SFinalAwaiter final_suspend() noexcept{ return {}; }
+    void unhandled_exception() noexcept{ DException = std::current_exception(); }
+};
+
+template <typename T>
+struct SPromise : SPromiseBase{
+    std::optional<T> DValue;
+
+    CTask<T> get_return_object() noexcept;
+    template <typename TValue>
+    void return_value(TValue &&value){ DValue.emplace(std::forward<TValue>(value)); }
+    T Result(){
+        if(DException){
+            std::rethrow_exception(DException);
+        }
+        return std::move(*DValue);
+    }
+};
+
+template <>
+struct SPromise<void> : SPromiseBase{
+    CTask<void> get_return_object() noexcept;
+    void return_void() noexcept{}
+    void Result(){
+        if(DException){
+            std::rethrow_exception(DException);
+        }
+    }
+};
+
+}
+
+template <typename T>
+class CTask{
+    public:
+        using promise_type = TaskDetail::SPromise<T>;
+
+    private:
+        std::coroutine_handle<promise_type> DHandle;
+
+    public:
+        explicit CTask(std::coroutine_handle<promise_type> handle) noexcept : DHandle(handle){}
+        CTask(CTask &&other) noexcept : DHandle(std::exchange(other.DHandle, nullptr)){}
+        CTask &operator=(CTask &&other) noexcept{
+            if(this != &other){
+                if(DHandle){
+                    DHandle.destroy();
+                }
+                DHandle = std::exchange(other.DHandle, nullptr);
+            }
+            return *this;
+        }
+        ~CTask(){
+            if(DHandle){
+                DHandle.destroy();
+            }
+        }
+
+        bool Done() const noexcept{
+            return !DHandle || DHandle.done();
+        }
+
+        // starts the task and suspends the caller until it finishes
+        bool await_ready() const noexcept{ return Done(); }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept{
+            DHandle.promise().DContinuation = continuation;
+            return DHandle;
+        }
+        T await_resume(){ return DHandle.promise().Result(); }
+};
+
+template <typename T>
+CTask<T> TaskDetail::SPromise<T>::get_return_object() noexcept{
+    return CTask<T>(std::coroutine_handle<SPromise<T>>::from_promise(*this));
+}
+
+inline CTask<void> TaskDetail::SPromise<void>::get_return_object() noexcept{
+    return CTask<void>(std::coroutine_handle<SPromise<void>>::from_promise(*this));
+}
+
+#endif
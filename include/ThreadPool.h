@@ -0,0 +1,25 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+class CThreadPool{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        CThreadPool(std::size_t threads = 0);
+        ~CThreadPool();
+
+        std::size_t ThreadCount() const noexcept;
+        void Submit(std::function<void()> task);
+        void Wait();
+        void ParallelFor(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)> &func);
+
+        static CThreadPool &Shared();
+};
+
+#endif
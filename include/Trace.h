@@ -0,0 +1,50 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <memory>
+#include "DataSink.h"
+
+// spans are only recorded when built with ENABLE_TRACE (make TRACE=1),
+// otherwise TRACE_SPAN expands to nothing and the helpers are empty
+
+class CTrace{
+    public:
+#ifdef ENABLE_TRACE
+        static constexpr bool Enabled = true;
+#else
+        static constexpr bool Enabled = false;
+#endif
+
+#ifdef ENABLE_TRACE
+        static std::uint64_t Now() noexcept;
+        static void Record(const char *name, std::uint64_t begin, std::uint64_t end) noexcept;
+#else
+        static std::uint64_t Now() noexcept{ return 0; }
+        static void Record(const char *, std::uint64_t, std::uint64_t) noexcept{}
+#endif
+
+        static bool WriteChromeTrace(std::shared_ptr< CDataSink > sink);
+        static void Clear();
+        static std::size_t EventCount();
+};
+
+// records a span from construction to destruction, name must outlive the trace
+class CTraceSpan{
+    private:
+        const char *DName;
+        std::uint64_t DBegin;
+    public:
+        CTraceSpan(const char *name) noexcept : DName(name), DBegin(CTrace::Now()){}
+        ~CTraceSpan(){ CTrace::Record(DName, DBegin, CTrace::Now()); }
+};
+
+#ifdef ENABLE_TRACE
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SPAN(name) CTraceSpan TRACE_CONCAT(TraceSpan, __LINE__)(name)
+#else
+#define TRACE_SPAN(name) do{}while(0)
+#endif
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef VARINT_H
+#define VARINT_H
+
+#include <cstdint>
+#include <vector>
+#include "DataSource.h"
+
+// little endian base 128 integers as used by the sidecar and spill formats
+namespace Varint{
+
+inline void Append(std::vector< char > &buf, std::uint64_t value){
+    while(value >= 0x80){
+        buf.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buf.push_back(static_cast<char>(value));
+}
+
+inline bool Decode(const char *&ptr, const char *end, std::uint64_t &value){
+    value = 0;
+    for(int Shift = 0; ptr < end && Shift < 64; Shift += 7){
+        std::uint8_t Byte = static_cast<std::uint8_t>(*ptr++);
+        value |= static_cast<std::uint64_t>(Byte & 0x7F) << Shift;
+        if(!(Byte & 0x80)){
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool Read(CDataSource &src, std::uint64_t &value){
+    value = 0;
+    for(int Shift = 0; Shift < 64; Shift += 7){
+        char Ch;
+        if(!src.Get(Ch)){
+            return false;
+        }
+        std::uint8_t Byte = static_cast<std::uint8_t>(Ch);
+        value |= static_cast<std::uint64_t>(Byte & 0x7F) << Shift;
+        if(!(Byte & 0x80)){
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+#endif
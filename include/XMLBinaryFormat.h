@@ -0,0 +1,30 @@
+#ifndef XMLBINARYFORMAT_H
+#define XMLBINARYFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+
+// layout shared by CXMLBinaryWriter and CXMLBinaryReader, all integers are
+// varints unless noted
+//
+//   header   "XMLB" version
+//   block    entity count, dictionary size, dictionary strings, entities
+//   footer   block count, then per block its offset delta and entity count
+//   trailer  footer offset as 8 little endian bytes, then "XMLB"
+//
+// strings are a length and the bytes, the dictionary holds the element names
+// and attribute keys used in its block so each block decodes on its own, an
+// entity is its type byte and then
+//   start/complete   name id, attribute count, per attribute key id and value string
+//   end              name id
+//   char data        text string
+namespace XMLBinary{
+
+constexpr char Magic[4] = {'X', 'M', 'L', 'B'};
+constexpr char Version = 1;
+constexpr std::size_t HeaderSize = sizeof(Magic) + 1;
+constexpr std::size_t TrailerSize = 8 + sizeof(Magic);
+
+}
+
+#endif
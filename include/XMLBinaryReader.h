@@ -0,0 +1,32 @@
+#ifndef XMLBINARYREADER_H
+#define XMLBINARYREADER_H
+
+#include <memory>
+#include <string>
+#include "Generator.h"
+#include "XMLEntity.h"
+
+// replays a stream written by CXMLBinaryWriter with the same interface as
+// CXMLReader, the file is memory mapped and decoded without expat, blocks
+// decode independently so separate readers can replay ranges of blocks in parallel
+class CXMLBinaryReader{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        CXMLBinaryReader(const std::string &path);
+        CXMLBinaryReader(std::shared_ptr< const std::string > data);
+        ~CXMLBinaryReader();
+
+        bool IsOpen() const;
+        std::size_t BlockCount() const;
+        std::size_t BlockEntities(std::size_t block) const;
+        bool SeekBlock(std::size_t block, std::size_t count = -1);
+
+        bool End() const;
+        bool ReadEntity(SXMLEntity &entity, bool skipcdata = false);
+        CGenerator< SXMLEntity > Entities(bool skipcdata = false);
+};
+
+#endif
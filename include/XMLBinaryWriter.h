@@ -0,0 +1,26 @@
+#ifndef XMLBINARYWRITER_H
+#define XMLBINARYWRITER_H
+
+#include <memory>
+#include "DataSink.h"
+#include "XMLEntity.h"
+
+// records an entity stream, such as the one CXMLReader produces, in the
+// compact form described in XMLBinaryFormat.h so CXMLBinaryReader can replay
+// it without parsing, Flush ends the stream and nothing can be written after it
+class CXMLBinaryWriter{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        CXMLBinaryWriter(std::shared_ptr< CDataSink > sink, std::size_t blockentities = 4096);
+        ~CXMLBinaryWriter();
+
+        bool WriteEntity(const SXMLEntity &entity);
+        bool Flush();
+
+        std::size_t BlockCount() const;
+};
+
+#endif
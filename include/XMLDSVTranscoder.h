@@ -0,0 +1,58 @@
+#ifndef XMLDSVTRANSCODER_H
+#define XMLDSVTRANSCODER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "DataSink.h"
+#include "DataSource.h"
+
+// converts between XML records and DSV rows in a three stage pipeline, the
+// reader, the mapper and the writer each run on their own thread and pass
+// batches through bounded queues, so memory stays fixed however large the input
+class CXMLDSVTranscoder{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        // a column and where its value lives relative to the record element,
+        // "@name" is an attribute of the record, "." is the record's own text,
+        // "child" is the text of a child element and "child/@name" its attribute
+        struct SField{
+            std::string DColumn;
+            std::string DPath;
+        };
+
+        struct SSpec{
+            std::string DRecordElement;
+            std::vector< SField > DFields;
+            std::string DRootElement = "records";
+            char DDelimiter = ',';
+            bool DHeader = true;
+        };
+
+        // items and bytes moved by a stage and how much of its time was spent
+        // working rather than waiting on its queues
+        struct SStageStats{
+            std::string DName;
+            std::uint64_t DItems = 0;
+            std::uint64_t DBytes = 0;
+            std::uint64_t DBusyNanoseconds = 0;
+            std::uint64_t DWallNanoseconds = 0;
+            std::size_t DQueueHighWater = 0;
+        };
+
+        CXMLDSVTranscoder(SSpec spec, std::size_t batchsize = 1024, std::size_t queuedepth = 8);
+        ~CXMLDSVTranscoder();
+
+        bool XMLToDSV(std::shared_ptr< CDataSource > src, std::shared_ptr< CDataSink > sink);
+        bool DSVToXML(std::shared_ptr< CDataSource > src, std::shared_ptr< CDataSink > sink);
+
+        const std::vector< SStageStats > &Stages() const;
+
+        static bool ParseField(const std::string &arg, SField &field);
+};
+
+#endif
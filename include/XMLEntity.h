@@ -1,48 +1,75 @@
 #ifndef XMLENTITY_H
 #define XMLENTITY_H
 
+#include <memory>
+#include <memory_resource>
 #include <utility>
 #include <string>
+#include <string_view>
 #include <vector>
 
-struct SXMLEntity{
-    using TAttribute = std::pair< std::string, std::string >;
-    enum class EType{StartElement, EndElement, CharData, CompleteElement};
+enum class EXMLEntityType{StartElement, EndElement, CharData, CompleteElement};
+
+// an XML entity whose strings come from TAllocator, SXMLEntity uses the heap
+// and SPmrXMLEntity a std::pmr memory resource that containers pass down
+template <typename TAllocator>
+struct SBasicXMLEntity{
+    using allocator_type = TAllocator;
+    using TString = std::basic_string< char, std::char_traits<char>, TAllocator >;
+    using TAttribute = std::pair< TString, TString >;
+    using TAttributes = std::vector< TAttribute, typename std::allocator_traits<TAllocator>::template rebind_alloc<TAttribute> >;
+    using EType = EXMLEntityType;
     EType DType;
-    std::string DNameData;
-    std::vector< TAttribute > DAttributes;
-    
-    bool AttributeExists(const std::string &name) const{
+    TString DNameData;
+    TAttributes DAttributes;
+
+    SBasicXMLEntity() = default;
+    explicit SBasicXMLEntity(const TAllocator &alloc) : DNameData(alloc), DAttributes(alloc){}
+    SBasicXMLEntity(EType type, TString name, TAttributes attributes = {})
+        : DType(type), DNameData(std::move(name)), DAttributes(std::move(attributes)){}
+    SBasicXMLEntity(const SBasicXMLEntity &other) = default;
+    SBasicXMLEntity(SBasicXMLEntity &&other) = default;
+    SBasicXMLEntity(const SBasicXMLEntity &other, const TAllocator &alloc)
+        : DType(other.DType), DNameData(other.DNameData, alloc), DAttributes(other.DAttributes, alloc){}
+    SBasicXMLEntity(SBasicXMLEntity &&other, const TAllocator &alloc)
+        : DType(other.DType), DNameData(std::move(other.DNameData), alloc), DAttributes(std::move(other.DAttributes), alloc){}
+    SBasicXMLEntity &operator=(const SBasicXMLEntity &other) = default;
+    SBasicXMLEntity &operator=(SBasicXMLEntity &&other) = default;
+
+    bool AttributeExists(std::string_view name) const{
         for(auto &Attribute : DAttributes){
             if(std::get<0>(Attribute) == name){
-                return true;   
+                return true;
             }
         }
         return false;
     };
-    
-    std::string AttributeValue(const std::string &name) const{
+
+    TString AttributeValue(std::string_view name) const{
         for(auto &Attribute : DAttributes){
             if(std::get<0>(Attribute) == name){
-                return std::get<1>(Attribute);   
+                return std::get<1>(Attribute);
             }
         }
-        return std::string();
+        return TString();
     };
-    
-    bool SetAttribute(const std::string &name, const std::string &value){
+
+    bool SetAttribute(std::string_view name, std::string_view value){
         if(name.empty()){
-            return false;   
+            return false;
         }
-        for(std::vector< TAttribute >::size_type Index = 0; Index < DAttributes.size(); Index++){
-            if(std::get<0>(DAttributes[Index]) == name){
-                DAttributes[Index] = std::make_pair(name,value);
+        for(auto &Attribute : DAttributes){
+            if(std::get<0>(Attribute) == name){
+                std::get<1>(Attribute).assign(value);
                 return true;
             }
         }
-        DAttributes.push_back(std::make_pair(name,value));
+        DAttributes.emplace_back(name, value);
         return true;
     };
 };
-   
+
+using SXMLEntity = SBasicXMLEntity< std::allocator<char> >;
+using SPmrXMLEntity = SBasicXMLEntity< std::pmr::polymorphic_allocator<char> >;
+
 #endif
@@ -0,0 +1,40 @@
+#ifndef XMLPUSHPARSER_H
+#define XMLPUSHPARSER_H
+
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include "XMLEntity.h"
+
+// incremental XML parser for input that arrives in arbitrary chunks, each
+// entity is passed to the callback as soon as expat reports it, entities
+// match what CXMLReader returns for the same bytes
+class CXMLPushParser{
+    private:
+        struct SImplementation;
+        std::unique_ptr<SImplementation> DImplementation;
+
+    public:
+        // the entity may be moved from
+        using TEntityCallback = std::function<void(SXMLEntity &entity)>;
+        using TPmrEntityCallback = std::function<void(SPmrXMLEntity &entity)>;
+
+        CXMLPushParser(TEntityCallback callback);
+        // the entities' strings and the pending character data come from the resource
+        CXMLPushParser(TPmrEntityCallback callback, std::pmr::memory_resource *resource);
+        ~CXMLPushParser();
+
+        bool Feed(const char *data, std::size_t length);
+        bool Finish();
+        // starts a new document, the callback stays
+        void Reset();
+
+        bool Finished() const;
+        // an allocation failed while building an entity, Feed and Finish return false
+        bool OutOfMemory() const;
+        // byte index, counted from the last Reset, of the markup or first
+        // character of text behind the entity being handed to the callback
+        std::size_t EntityOffset() const;
+};
+
+#endif
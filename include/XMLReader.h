@@ -2,8 +2,16 @@
 #define XMLREADER_H
 
 #include <memory>
+#include <memory_resource>
 #include "XMLEntity.h"
+#include "Checkpoint.h"
 #include "DataSource.h"
+#include "Generator.h"
+#include "IOStats.h"
+#include "MemoryAccount.h"
+#include "RecordBlock.h"
+
+using TXMLEntityBlock = CRecordBlock< SPmrXMLEntity >;
 
 class CXMLReader{
     private:
@@ -11,11 +19,20 @@ class CXMLReader{
         std::unique_ptr<SImplementation> DImplementation;
         
     public:
-        CXMLReader(std::shared_ptr< CDataSource > src);
+        CXMLReader(std::shared_ptr< CDataSource > src, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+        CXMLReader(std::shared_ptr< CDataSource > src, std::shared_ptr< CMemoryAccount > account);
         ~CXMLReader();
         
         bool End() const;
         bool ReadEntity(SXMLEntity &entity, bool skipcdata = false);
+        bool ReadEntity(SPmrXMLEntity &entity, bool skipcdata = false);
+        std::size_t ReadEntities(TXMLEntityBlock &block, std::size_t count, bool skipcdata = false);
+
+        SXMLCheckpoint Checkpoint() const;
+        bool Resume(const SXMLCheckpoint &checkpoint);
+        CGenerator< SXMLEntity > Entities(bool skipcdata = false);
+
+        SIOStats Stats() const;
 };
 
 #endif
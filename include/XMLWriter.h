@@ -2,8 +2,12 @@
 #define XMLWRITER_H
 
 #include <memory>
+#include <string>
+#include <vector>
 #include "XMLEntity.h"
 #include "DataSink.h"
+#include "IOStats.h"
+#include "MemoryAccount.h"
 
 class CXMLWriter{
     private:
@@ -12,10 +16,15 @@ class CXMLWriter{
         
     public:
         CXMLWriter(std::shared_ptr< CDataSink > sink);
+        CXMLWriter(std::shared_ptr< CDataSink > sink, std::vector< std::string > openelements);
+        CXMLWriter(std::shared_ptr< CDataSink > sink, std::shared_ptr< CMemoryAccount > account);
         ~CXMLWriter();
         
         bool Flush();
         bool WriteEntity(const SXMLEntity &entity);
+        std::vector< std::string > OpenElements() const;
+
+        SIOStats Stats() const;
 };
 
 #endif
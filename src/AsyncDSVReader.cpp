@@ -0,0 +1,54 @@
+#include "AsyncDSVReader.h"
+#include "DSVPushParser.h"
+#include <deque>
+
+struct CAsyncDSVReader::SImplementation {
+    std::shared_ptr<CAsyncDataSource> Source; // non-blocking source
+    std::size_t BlockSize; // bytes asked for per read
+    std::vector<char> Buffer; // the last block read
+    std::deque<std::vector<std::string>> Rows; // rows parsed but not yet returned
+    CDSVPushParser Parser; // keeps partial rows between blocks
+    bool Failed = false; // the source reported an error
+
+    SImplementation(std::shared_ptr<CAsyncDataSource> src, char delimiter, std::size_t blocksize)
+        : Source(std::move(src)), BlockSize(blocksize ? blocksize : 1),
+          Parser(delimiter, [this](std::vector<std::string> &row) { Rows.push_back(std::move(row)); }) {}
+};
+
+CAsyncDSVReader::CAsyncDSVReader(std::shared_ptr<CAsyncDataSource> src, char delimiter, std::size_t blocksize)
+    : DImplementation(std::make_unique<SImplementation>(std::move(src), delimiter, blocksize)) {}
+
+CAsyncDSVReader::~CAsyncDSVReader() = default;
+
+// checks if all data has been read
+bool CAsyncDSVReader::End() const {
+    return DImplementation->Rows.empty() && (DImplementation->Parser.Finished() || DImplementation->Failed);
+}
+
+// reads the next row, suspending while the source is waiting for data, the
+// reader must outlive the returned task
+CTask<bool> CAsyncDSVReader::ReadRow(std::vector<std::string> &row) {
+    auto &Impl = *DImplementation;
+    while (Impl.Rows.empty() && !Impl.Parser.Finished() && !Impl.Failed) {
+        switch (co_await Impl.Source->Read(Impl.Buffer, Impl.BlockSize)) {
+            case CAsyncDataSource::EStatus::Data:
+                Impl.Parser.Feed(Impl.Buffer.data(), Impl.Buffer.size());
+                break;
+            case CAsyncDataSource::EStatus::End:
+                Impl.Parser.Finish();
+                break;
+            case CAsyncDataSource::EStatus::Error:
+                Impl.Failed = true;
+                break;
+            case CAsyncDataSource::EStatus::Pending:
+                break;
+        }
+    }
+    if (Impl.Rows.empty()) {
+        row.clear();
+        co_return false;
+    }
+    row = std::move(Impl.Rows.front());
+    Impl.Rows.pop_front();
+    co_return true;
+}
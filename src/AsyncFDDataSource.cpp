@@ -0,0 +1,40 @@
+#include "AsyncFDDataSource.h"
+#include "AsyncScheduler.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+CAsyncFDDataSource::CAsyncFDDataSource(int fd, bool owned) : DFD(fd), DOwned(owned){
+    int Flags = fcntl(DFD, F_GETFL);
+    if(Flags >= 0){
+        fcntl(DFD, F_SETFL, Flags | O_NONBLOCK);
+    }
+}
+
+CAsyncFDDataSource::~CAsyncFDDataSource(){
+    if(DOwned && DFD >= 0){
+        close(DFD);
+    }
+}
+
+CAsyncDataSource::EStatus CAsyncFDDataSource::ReadSome(std::vector<char> &buf, std::size_t count) noexcept{
+    buf.resize(count);
+    ssize_t Length;
+    do{
+        Length = read(DFD, buf.data(), count);
+    }while(Length < 0 && errno == EINTR);
+    buf.resize(Length > 0 ? Length : 0);
+    if(Length > 0){
+        return EStatus::Data;
+    }
+    if(Length == 0){
+        return EStatus::End;
+    }
+    return errno == EAGAIN || errno == EWOULDBLOCK ? EStatus::Pending : EStatus::Error;
+}
+
+// only works from a coroutine running under a scheduler
+bool CAsyncFDDataSource::Wait(std::function<void()> ready){
+    CAsyncScheduler *Scheduler = CAsyncScheduler::Current();
+    return Scheduler && Scheduler->WatchReadable(DFD, std::move(ready));
+}
@@ -0,0 +1,174 @@
+#include "AsyncScheduler.h"
+#include <atomic>
+#include <cerrno>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace {
+
+// scheduler running on this thread, set for the duration of Run
+thread_local CAsyncScheduler *CurrentScheduler = nullptr;
+
+// coroutine that owns a spawned task and reports when it is finished
+struct SDetached {
+    struct promise_type {
+        SDetached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+}
+
+struct CAsyncScheduler::SImplementation {
+    int EpollFD; // readiness of watched descriptors and the wakeup event
+    int WakeFD; // eventfd written by Post from other threads
+    std::mutex Mutex; // guards Ready
+    std::vector<std::function<void()>> Ready; // work to run on the next pass
+    std::unordered_map<int, std::function<void()>> Watches; // one-shot callbacks by descriptor
+    std::atomic<std::size_t> Tasks{0}; // spawned tasks not yet finished
+    std::exception_ptr Failure; // first exception thrown by a spawned task
+
+    SImplementation() {
+        EpollFD = epoll_create1(EPOLL_CLOEXEC);
+        WakeFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        epoll_event Event{};
+        Event.events = EPOLLIN;
+        Event.data.fd = WakeFD;
+        epoll_ctl(EpollFD, EPOLL_CTL_ADD, WakeFD, &Event);
+    }
+
+    ~SImplementation() {
+        close(WakeFD);
+        close(EpollFD);
+    }
+
+    SDetached Own(CTask<void> task) {
+        try {
+            co_await task;
+        } catch (...) {
+            if (!Failure) {
+                Failure = std::current_exception();
+            }
+        }
+        Tasks--;
+    }
+
+    void Post(std::function<void()> func) {
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            Ready.push_back(std::move(func));
+        }
+        std::uint64_t One = 1;
+        [[maybe_unused]] auto Written = write(WakeFD, &One, sizeof(One));
+    }
+
+    // arms a one-shot watch, rearming a descriptor that was watched before
+    bool WatchReadable(int fd, std::function<void()> ready) {
+        epoll_event Event{};
+        Event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        Event.data.fd = fd;
+        if (epoll_ctl(EpollFD, EPOLL_CTL_MOD, fd, &Event) != 0) {
+            if (errno != ENOENT || epoll_ctl(EpollFD, EPOLL_CTL_ADD, fd, &Event) != 0) {
+                return false;
+            }
+        }
+        Watches[fd] = std::move(ready);
+        return true;
+    }
+
+    // blocks until a watched descriptor is ready or work is posted
+    void Poll() {
+        epoll_event Events[64];
+        int Count = epoll_wait(EpollFD, Events, 64, -1);
+        for (int Index = 0; Index < Count; Index++) {
+            int FD = Events[Index].data.fd;
+            if (FD == WakeFD) {
+                std::uint64_t Value;
+                [[maybe_unused]] auto Read = read(WakeFD, &Value, sizeof(Value));
+                continue;
+            }
+            auto Found = Watches.find(FD);
+            if (Found != Watches.end()) {
+                auto Callback = std::move(Found->second);
+                Watches.erase(Found);
+                Callback();
+            }
+        }
+    }
+
+    void Run() {
+        while (true) {
+            std::vector<std::function<void()>> Batch;
+            {
+                std::lock_guard<std::mutex> Lock(Mutex);
+                Batch.swap(Ready);
+            }
+            for (auto &Func : Batch) {
+                Func();
+            }
+            if (Failure) {
+                std::rethrow_exception(std::exchange(Failure, nullptr));
+            }
+            if (!Batch.empty()) {
+                continue;
+            }
+            if (Tasks == 0) {
+                return;
+            }
+            Poll();
+        }
+    }
+};
+
+CAsyncScheduler::CAsyncScheduler() : DImplementation(std::make_unique<SImplementation>()) {}
+
+CAsyncScheduler::~CAsyncScheduler() = default;
+
+// takes ownership of a task, it starts on the next pass of Run
+void CAsyncScheduler::Spawn(CTask<void> task) {
+    DImplementation->Tasks++;
+    auto Shared = std::make_shared<CTask<void>>(std::move(task));
+    DImplementation->Post([this, Shared]() mutable {
+        DImplementation->Own(std::move(*Shared));
+    });
+}
+
+// queues a function to run on the scheduler thread, safe from any thread
+void CAsyncScheduler::Post(std::function<void()> func) {
+    DImplementation->Post(std::move(func));
+}
+
+// calls ready once on the scheduler thread when fd has data, end of file or
+// an error, must be called from the scheduler thread
+bool CAsyncScheduler::WatchReadable(int fd, std::function<void()> ready) {
+    return DImplementation->WatchReadable(fd, std::move(ready));
+}
+
+// runs until every spawned task has finished, rethrows the first exception a task let escape
+void CAsyncScheduler::Run() {
+    CAsyncScheduler *Previous = std::exchange(CurrentScheduler, this);
+    try {
+        DImplementation->Run();
+    } catch (...) {
+        CurrentScheduler = Previous;
+        throw;
+    }
+    CurrentScheduler = Previous;
+}
+
+// spawned tasks that have not finished
+std::size_t CAsyncScheduler::TaskCount() const {
+    return DImplementation->Tasks;
+}
+
+// the scheduler whose Run is active on the calling thread, or null
+CAsyncScheduler *CAsyncScheduler::Current() noexcept {
+    return CurrentScheduler;
+}
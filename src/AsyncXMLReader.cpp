@@ -0,0 +1,57 @@
+#include "AsyncXMLReader.h"
+#include "XMLPushParser.h"
+#include <queue>
+#include <vector>
+
+struct CAsyncXMLReader::SImplementation {
+    std::shared_ptr<CAsyncDataSource> Source; // non-blocking source
+    std::size_t BlockSize; // bytes asked for per read
+    std::vector<char> Buffer; // the last block read
+    std::queue<SXMLEntity> Queue; // entities parsed but not yet returned
+    CXMLPushParser Parser{[this](SXMLEntity &entity) { Queue.push(std::move(entity)); }}; // keeps expat state between blocks
+    bool Failed = false; // the source reported an error or the XML was malformed
+
+    SImplementation(std::shared_ptr<CAsyncDataSource> src, std::size_t blocksize)
+        : Source(std::move(src)), BlockSize(blocksize ? blocksize : 1) {}
+};
+
+CAsyncXMLReader::CAsyncXMLReader(std::shared_ptr<CAsyncDataSource> src, std::size_t blocksize)
+    : DImplementation(std::make_unique<SImplementation>(std::move(src), blocksize)) {}
+
+CAsyncXMLReader::~CAsyncXMLReader() = default;
+
+// returns true if all data has been parsed and the entity queue is empty
+bool CAsyncXMLReader::End() const {
+    return DImplementation->Queue.empty() && (DImplementation->Parser.Finished() || DImplementation->Failed);
+}
+
+// reads the next entity, suspending while the source is waiting for data,
+// the reader must outlive the returned task
+CTask<bool> CAsyncXMLReader::ReadEntity(SXMLEntity &entity, bool skipcdata) {
+    auto &Impl = *DImplementation;
+    while (true) {
+        while (Impl.Queue.empty() && !Impl.Parser.Finished() && !Impl.Failed) {
+            switch (co_await Impl.Source->Read(Impl.Buffer, Impl.BlockSize)) {
+                case CAsyncDataSource::EStatus::Data:
+                    Impl.Failed = !Impl.Parser.Feed(Impl.Buffer.data(), Impl.Buffer.size());
+                    break;
+                case CAsyncDataSource::EStatus::End:
+                    Impl.Parser.Finish();
+                    break;
+                case CAsyncDataSource::EStatus::Error:
+                    Impl.Failed = true;
+                    break;
+                case CAsyncDataSource::EStatus::Pending:
+                    break;
+            }
+        }
+        if (Impl.Queue.empty()) {
+            co_return false;
+        }
+        entity = std::move(Impl.Queue.front());
+        Impl.Queue.pop();
+        if (!(skipcdata && entity.DType == SXMLEntity::EType::CharData)) {
+            co_return true;
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#include "Checkpoint.h"
+#include <sstream>
+
+// one line of text, "DSV offset row"
+std::string SDSVCheckpoint::Serialize() const {
+    return "DSV " + std::to_string(DOffset) + " " + std::to_string(DRow);
+}
+
+bool SDSVCheckpoint::Parse(const std::string &text, SDSVCheckpoint &checkpoint) {
+    std::istringstream Input(text);
+    std::string Kind;
+    SDSVCheckpoint Result;
+    if (!(Input >> Kind >> Result.DOffset >> Result.DRow) || Kind != "DSV") {
+        return false;
+    }
+    checkpoint = Result;
+    return true;
+}
+
+// one line of text, "XML offset skip" followed by the open element names,
+// which can never hold a space
+std::string SXMLCheckpoint::Serialize() const {
+    std::string Result = "XML " + std::to_string(DOffset) + " " + std::to_string(DSkip);
+    for (const auto &Name : DOpenElements) {
+        Result += " " + Name;
+    }
+    return Result;
+}
+
+bool SXMLCheckpoint::Parse(const std::string &text, SXMLCheckpoint &checkpoint) {
+    std::istringstream Input(text);
+    std::string Kind;
+    SXMLCheckpoint Result;
+    if (!(Input >> Kind >> Result.DOffset >> Result.DSkip) || Kind != "XML") {
+        return false;
+    }
+    std::string Name;
+    while (Input >> Name) {
+        Result.DOpenElements.push_back(Name);
+    }
+    checkpoint = std::move(Result);
+    return true;
+}
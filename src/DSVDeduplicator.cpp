@@ -0,0 +1,111 @@
+#include "DSVDeduplicator.h"
+#include "DSVHashTable.h"
+#include "DSVSpillFile.h"
+
+namespace {
+
+// hash partitions for rows read after the table filled up, picked by the top
+// bits of the key hash since the table places keys by the low ones, a
+// partition whose keys still do not fit is split again on the bits below
+const std::size_t PartitionBits = 5;
+const std::size_t PartitionCount = 1 << PartitionBits;
+const std::size_t MaxDepth = 64 / PartitionBits;
+
+std::size_t PartitionOf(std::uint64_t hash, std::size_t depth) {
+    return (hash << (depth * PartitionBits)) >> (64 - PartitionBits);
+}
+
+}
+
+struct CDSVDeduplicator::SImplementation {
+    std::vector<std::size_t> Keys; // columns that identify a row
+    std::size_t MemoryBudget; // bytes the key table may use before rows are spilled
+    std::string TempDir; // where partitions are spilled
+    bool DidSpill = false; // the last Deduplicate spilled
+    std::size_t Duplicates = 0; // rows dropped by the last Deduplicate
+
+    SImplementation(std::vector<std::size_t> keys, std::size_t memorybudget, const std::string &tempdir)
+        : Keys(std::move(keys)), MemoryBudget(memorybudget), TempDir(tempdir) {}
+
+    // writes the row if its key is new, counts it otherwise
+    bool Add(CDSVHashTable &table, const std::vector<std::string> &row, CDSVWriter &writer) {
+        if (!table.InsertKey(row)) {
+            Duplicates++;
+            return true;
+        }
+        return writer.WriteRow(row);
+    }
+
+    // the keys of every row written so far are in the table, so only rows with
+    // other keys are kept, and any key lands in one partition
+    template <typename TSource>
+    bool Spill(CDSVHashTable &table, TSource &source, std::vector<std::unique_ptr<CDSVSpillFile>> &partitions, std::size_t depth) {
+        DidSpill = true;
+        for (std::size_t Index = 0; Index < PartitionCount; Index++) {
+            partitions.push_back(std::make_unique<CDSVSpillFile>(TempDir));
+            if (!partitions.back()->IsOpen()) return false;
+        }
+        std::vector<std::string> Row;
+        while (source.ReadRow(Row)) {
+            if (table.Contains(Row, Keys)) {
+                Duplicates++;
+            } else if (!partitions[PartitionOf(CDSVHashTable::Hash(Row, Keys), depth)]->WriteRow(Row)) {
+                return false;
+            }
+        }
+        table.Clear();
+        return true;
+    }
+
+    // the input and then each partition goes through the same steps, a
+    // partition at the last depth has no hash bits left to split on and is
+    // deduplicated in memory whatever its size
+    template <typename TSource>
+    bool DeduplicateRows(TSource &source, CDSVWriter &writer, std::size_t depth) {
+        std::vector<std::unique_ptr<CDSVSpillFile>> Partitions;
+        {
+            CDSVHashTable Table(Keys);
+            std::vector<std::string> Row;
+            while (Table.Bytes() <= MemoryBudget || depth >= MaxDepth) {
+                if (!source.ReadRow(Row)) {
+                    return true;
+                }
+                if (!Add(Table, Row, writer)) return false;
+            }
+            if (!Spill(Table, source, Partitions, depth)) return false;
+        }
+        for (auto &Partition : Partitions) {
+            if (!Partition->Rewind() || !DeduplicateRows(*Partition, writer, depth + 1)) return false;
+            Partition.reset();
+        }
+        return true;
+    }
+
+    bool Deduplicate(CDSVReader &reader, CDSVWriter &writer) {
+        DidSpill = false;
+        Duplicates = 0;
+        return DeduplicateRows(reader, writer, 0);
+    }
+};
+
+// keys are the columns compared, memorybudget bounds the key table and tempdir
+// picks where partitions are spilled, empty means TMPDIR or /tmp
+CDSVDeduplicator::CDSVDeduplicator(std::vector<std::size_t> keys, std::size_t memorybudget, const std::string &tempdir)
+    : DImplementation(std::make_unique<SImplementation>(std::move(keys), memorybudget, tempdir)) {}
+
+CDSVDeduplicator::~CDSVDeduplicator() = default;
+
+// writes the first row of every key, rows come out in input order unless the
+// table spilled, then the rows read after that follow partition by partition
+bool CDSVDeduplicator::Deduplicate(CDSVReader &reader, CDSVWriter &writer) {
+    return DImplementation->Deduplicate(reader, writer);
+}
+
+// true when the last Deduplicate had to spill partitions to disk
+bool CDSVDeduplicator::Spilled() const {
+    return DImplementation->DidSpill;
+}
+
+std::size_t CDSVDeduplicator::Duplicates() const {
+    return DImplementation->Duplicates;
+}
@@ -0,0 +1,244 @@
+#include "DSVGroupBy.h"
+#include "DSVSpillFile.h"
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+namespace {
+
+// hash partitions written once the table no longer fits, a partition that
+// still does not fit is split again on the next bits of the hash
+const std::size_t PartitionBits = 5;
+const std::size_t PartitionCount = 1 << PartitionBits;
+const std::size_t MaxDepth = 64 / PartitionBits;
+
+// the partition a key hash falls in at a depth of splitting
+std::size_t PartitionOf(std::size_t hash, std::size_t depth) {
+    return (static_cast<std::uint64_t>(hash) >> (depth * PartitionBits)) % PartitionCount;
+}
+
+// parses the whole field as a number
+bool ParseNumber(const std::string &str, double &value) {
+    auto Result = std::from_chars(str.data(), str.data() + str.size(), value);
+    return !str.empty() && Result.ec == std::errc() && Result.ptr == str.data() + str.size();
+}
+
+// shortest text that reads back as the same double, whole numbers that fit
+// exactly are written without an exponent
+std::string FormatNumber(double value) {
+    char Buffer[32];
+    auto Result = (value == std::trunc(value) && std::fabs(value) < 9007199254740992.0)
+        ? std::to_chars(Buffer, Buffer + sizeof(Buffer), static_cast<long long>(value))
+        : std::to_chars(Buffer, Buffer + sizeof(Buffer), value);
+    return std::string(Buffer, Result.ptr);
+}
+
+// running state of one aggregate, Count counts rows for Count and numeric
+// values for the others
+struct SAccumulator {
+    std::uint64_t Count = 0;
+    double Value = 0;
+};
+
+// the key fields packed into one string with length prefixes so the packing is unambiguous
+void PackKey(const std::vector<std::string> &row, const std::vector<std::size_t> &keys, std::string &packed) {
+    packed.clear();
+    for (auto Column : keys) {
+        std::size_t Length = Column < row.size() ? row[Column].size() : 0;
+        packed.append(reinterpret_cast<const char *>(&Length), sizeof(Length));
+        if (Length) {
+            packed.append(row[Column]);
+        }
+    }
+}
+
+std::vector<std::string> UnpackKey(const std::string &packed) {
+    std::vector<std::string> Fields;
+    for (std::size_t Index = 0; Index < packed.size();) {
+        std::size_t Length;
+        packed.copy(reinterpret_cast<char *>(&Length), sizeof(Length), Index);
+        Index += sizeof(Length);
+        Fields.push_back(packed.substr(Index, Length));
+        Index += Length;
+    }
+    return Fields;
+}
+
+}
+
+struct CDSVGroupBy::SImplementation {
+    std::vector<std::size_t> Keys; // grouping columns
+    std::vector<SAggregate> Aggregates; // values computed per group
+    std::size_t MemoryBudget; // bytes the table may use before it is spilled
+    std::string TempDir; // where partitions are spilled
+    std::unordered_map<std::string, std::vector<SAccumulator>> Table; // packed key to accumulators
+    std::size_t TableBytes = 0; // estimated size of the table
+    std::vector<std::unique_ptr<CDSVSpillFile>> Partitions; // created on first spill
+    std::vector<std::size_t> PartialKeys; // key columns of a partial row
+    bool DidSpill = false; // the last Aggregate spilled
+
+    SImplementation(std::vector<std::size_t> keys, std::vector<SAggregate> aggregates, std::size_t memorybudget, const std::string &tempdir)
+        : Keys(std::move(keys)), Aggregates(std::move(aggregates)), MemoryBudget(memorybudget), TempDir(tempdir) {
+        for (std::size_t Index = 0; Index < Keys.size(); Index++) {
+            PartialKeys.push_back(Index);
+        }
+    }
+
+    // finds or creates the accumulators for a packed key
+    std::vector<SAccumulator> &Group(const std::string &packed) {
+        auto Found = Table.find(packed);
+        if (Found == Table.end()) {
+            Found = Table.emplace(packed, std::vector<SAccumulator>(Aggregates.size())).first;
+            TableBytes += packed.capacity() + Aggregates.size() * sizeof(SAccumulator) + 96;
+        }
+        return Found->second;
+    }
+
+    // folds one input value into an accumulator
+    void Add(SAccumulator &acc, SAggregate::EFunction function, double value, std::uint64_t count) {
+        switch (function) {
+            case SAggregate::EFunction::Count: acc.Count += count; return;
+            case SAggregate::EFunction::Sum: acc.Value += value; break;
+            case SAggregate::EFunction::Min: acc.Value = acc.Count ? std::min(acc.Value, value) : value; break;
+            case SAggregate::EFunction::Max: acc.Value = acc.Count ? std::max(acc.Value, value) : value; break;
+        }
+        acc.Count += count;
+    }
+
+    void AddRow(const std::vector<std::string> &row, std::string &packed) {
+        PackKey(row, Keys, packed);
+        auto &Accumulators = Group(packed);
+        for (std::size_t Index = 0; Index < Aggregates.size(); Index++) {
+            const SAggregate &Agg = Aggregates[Index];
+            double Value = 0;
+            if (Agg.DFunction == SAggregate::EFunction::Count) {
+                Add(Accumulators[Index], Agg.DFunction, 0, 1);
+            } else if (Agg.DColumn < row.size() && ParseNumber(row[Agg.DColumn], Value)) {
+                Add(Accumulators[Index], Agg.DFunction, Value, 1);
+            }
+        }
+    }
+
+    // partial rows hold the key fields and then a count and value per aggregate
+    bool SpillTable(std::vector<std::unique_ptr<CDSVSpillFile>> &partitions, std::size_t depth) {
+        DidSpill = true;
+        if (partitions.empty()) {
+            for (std::size_t Index = 0; Index < PartitionCount; Index++) {
+                partitions.push_back(std::make_unique<CDSVSpillFile>(TempDir));
+                if (!partitions.back()->IsOpen()) return false;
+            }
+        }
+        std::vector<std::string> Row;
+        for (auto &Entry : Table) {
+            Row = UnpackKey(Entry.first);
+            for (auto &Acc : Entry.second) {
+                Row.push_back(std::to_string(Acc.Count));
+                Row.push_back(FormatNumber(Acc.Value));
+            }
+            if (!partitions[PartitionOf(std::hash<std::string>()(Entry.first), depth)]->WriteRow(Row)) return false;
+        }
+        Table.clear();
+        TableBytes = 0;
+        return true;
+    }
+
+    void MergePartial(const std::vector<std::string> &row, std::string &packed) {
+        PackKey(row, PartialKeys, packed);
+        auto &Accumulators = Group(packed);
+        for (std::size_t Index = 0; Index < Aggregates.size(); Index++) {
+            std::uint64_t Count = std::stoull(row[Keys.size() + Index * 2]);
+            double Value = 0;
+            ParseNumber(row[Keys.size() + Index * 2 + 1], Value);
+            if (Count) {
+                Add(Accumulators[Index], Aggregates[Index].DFunction, Value, Count);
+            }
+        }
+    }
+
+    bool WriteTable(CDSVWriter &writer) {
+        std::vector<std::string> Row;
+        for (auto &Entry : Table) {
+            Row = UnpackKey(Entry.first);
+            for (std::size_t Index = 0; Index < Aggregates.size(); Index++) {
+                const SAccumulator &Acc = Entry.second[Index];
+                if (Aggregates[Index].DFunction == SAggregate::EFunction::Count) {
+                    Row.push_back(std::to_string(Acc.Count));
+                } else {
+                    Row.push_back(Acc.Count ? FormatNumber(Acc.Value) : std::string()); // empty when no numeric values
+                }
+            }
+            if (!writer.WriteRow(Row)) return false;
+        }
+        Table.clear();
+        TableBytes = 0;
+        return true;
+    }
+
+    // merges the partial rows of one partition, when they outgrow the budget
+    // they are split into partitions on the next hash bits and each is merged
+    // in turn, fails only when the hash has no bits left to split on
+    bool MergePartition(CDSVSpillFile &partition, std::size_t depth, CDSVWriter &writer) {
+        std::vector<std::string> Row;
+        std::string Packed;
+        std::vector<std::unique_ptr<CDSVSpillFile>> Children;
+        if (!partition.Rewind()) return false;
+        while (partition.ReadRow(Row)) {
+            MergePartial(Row, Packed);
+            if (TableBytes > MemoryBudget) {
+                if (depth + 1 >= MaxDepth || !SpillTable(Children, depth + 1)) return false;
+            }
+        }
+        if (Children.empty()) {
+            return WriteTable(writer);
+        }
+        if (!SpillTable(Children, depth + 1)) return false;
+        for (auto &Child : Children) {
+            if (!MergePartition(*Child, depth + 1, writer)) return false;
+            Child.reset();
+        }
+        return true;
+    }
+
+    bool Aggregate(CDSVReader &reader, CDSVWriter &writer) {
+        std::vector<std::string> Row;
+        std::string Packed;
+        Table.clear();
+        TableBytes = 0;
+        Partitions.clear();
+        DidSpill = false;
+        while (reader.ReadRow(Row)) {
+            AddRow(Row, Packed);
+            if (TableBytes > MemoryBudget && !SpillTable(Partitions, 0)) return false;
+        }
+        if (!DidSpill) {
+            return WriteTable(writer);
+        }
+        if (!SpillTable(Partitions, 0)) return false;
+        // every key lands in one partition so each can be finished on its own
+        for (auto &Partition : Partitions) {
+            if (!MergePartition(*Partition, 0, writer)) return false;
+            Partition.reset();
+        }
+        return true;
+    }
+};
+
+// keys are the grouping columns, memorybudget bounds the hash table and tempdir
+// picks where partitions are spilled, empty means TMPDIR or /tmp
+CDSVGroupBy::CDSVGroupBy(std::vector<std::size_t> keys, std::vector<SAggregate> aggregates, std::size_t memorybudget, const std::string &tempdir)
+    : DImplementation(std::make_unique<SImplementation>(std::move(keys), std::move(aggregates), memorybudget, tempdir)) {}
+
+CDSVGroupBy::~CDSVGroupBy() = default;
+
+// reads every row and writes one row per distinct key, Sum, Min and Max only
+// consider fields that parse as numbers and are left empty when there are none
+bool CDSVGroupBy::Aggregate(CDSVReader &reader, CDSVWriter &writer) {
+    return DImplementation->Aggregate(reader, writer);
+}
+
+// true when the last Aggregate had to spill partitions to disk
+bool CDSVGroupBy::Spilled() const {
+    return DImplementation->DidSpill;
+}
@@ -0,0 +1,353 @@
+#include "DSVHashJoin.h"
+#include "DSVHashTable.h"
+#include "DSVSpillFile.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+namespace {
+
+// hash partitions written once the build table no longer fits, picked by the
+// top bits of the key hash since the table places keys by the low ones, a
+// partition that still does not fit is split again on the bits below
+const std::size_t PartitionBits = 5;
+const std::size_t PartitionCount = 1 << PartitionBits;
+const std::size_t MaxDepth = 64 / PartitionBits;
+
+// probe rows read per block and handed to each task when probing in parallel
+const std::size_t ProbeBlock = 4096;
+const std::size_t ProbeGrain = 256;
+
+// output rows gathered by a partition task before it takes the writer
+const std::size_t OutputBatch = 1024;
+
+std::size_t PartitionOf(std::uint64_t hash, std::size_t depth) {
+    return (hash << (depth * PartitionBits)) >> (64 - PartitionBits);
+}
+
+// the key fields followed by the other fields in order, the layout of spilled build rows
+void Normalize(const std::vector<std::string> &row, const std::vector<std::size_t> &keys, std::vector<std::string> &normalized) {
+    normalized.clear();
+    for (auto Column : keys) {
+        normalized.push_back(Column < row.size() ? row[Column] : std::string());
+    }
+    for (std::size_t Column = 0; Column < row.size(); Column++) {
+        if (std::find(keys.begin(), keys.end(), Column) == keys.end()) {
+            normalized.push_back(row[Column]);
+        }
+    }
+}
+
+}
+
+struct CDSVHashJoin::SImplementation {
+    using TFlush = std::function<bool(std::vector<std::vector<std::string>> &)>;
+
+    std::vector<std::size_t> BuildKeys; // key columns of the build rows
+    std::vector<std::size_t> ProbeKeys; // key columns of the probe rows, matched in order
+    std::vector<std::size_t> SpilledKeys; // key columns of normalized build rows
+    EType Type;
+    std::size_t MemoryBudget; // bytes the build table may use before it is spilled
+    std::string TempDir; // where partitions are spilled
+    bool Parallel; // probe across the shared pool
+    std::size_t Width = 0; // most build fields outside the keys, the padding for Left
+    bool DidSpill = false; // the last Join spilled
+
+    SImplementation(std::vector<std::size_t> buildkeys, std::vector<std::size_t> probekeys, EType type, std::size_t memorybudget, const std::string &tempdir, bool parallel)
+        : BuildKeys(std::move(buildkeys)), ProbeKeys(std::move(probekeys)), Type(type), MemoryBudget(memorybudget), TempDir(tempdir), Parallel(parallel) {
+        for (std::size_t Index = 0; Index < BuildKeys.size(); Index++) {
+            SpilledKeys.push_back(Index);
+        }
+    }
+
+    // keeps the widest build row so unmatched Left rows can be padded to it
+    void Measure(const std::vector<std::string> &row) {
+        std::size_t Keys = std::count_if(BuildKeys.begin(), BuildKeys.end(), [&row](std::size_t column) { return column < row.size(); });
+        Width = std::max(Width, row.size() - Keys);
+    }
+
+    // passes the output rows for one probe row to emit
+    template <typename TEmit>
+    bool Probe(const CDSVHashTable &table, const std::vector<std::string> &row, std::vector<std::string> &output, TEmit &&emit) const {
+        std::uint32_t Match = table.Find(row, ProbeKeys);
+        switch (Type) {
+            case EType::Semi: return Match == CDSVHashTable::NoRow || emit(row);
+            case EType::Anti: return Match != CDSVHashTable::NoRow || emit(row);
+            default: break;
+        }
+        if (Match == CDSVHashTable::NoRow) {
+            if (Type != EType::Left) {
+                return true;
+            }
+            output.assign(row.begin(), row.end());
+            output.resize(row.size() + Width);
+            return emit(output);
+        }
+        for (; Match != CDSVHashTable::NoRow; Match = table.NextRow(Match)) {
+            output.assign(row.begin(), row.end());
+            table.AppendPayload(Match, output);
+            if (!emit(output)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename TSource, typename TEmit>
+    bool ProbeAll(const CDSVHashTable &table, TSource &source, TEmit &&emit) const {
+        std::vector<std::string> Row, Output;
+        while (source.ReadRow(Row)) {
+            if (!Probe(table, Row, Output, emit)) return false;
+        }
+        return true;
+    }
+
+    // rows are read and written in order, only the lookups and the building of
+    // output rows are spread across the pool
+    bool ProbeParallel(const CDSVHashTable &table, CDSVReader &probe, CDSVWriter &writer) const {
+        std::vector<std::vector<std::string>> Block(ProbeBlock);
+        std::vector<std::vector<std::vector<std::string>>> Outputs((ProbeBlock + ProbeGrain - 1) / ProbeGrain);
+        while (true) {
+            std::size_t Count = 0;
+            while (Count < ProbeBlock && probe.ReadRow(Block[Count])) {
+                Count++;
+            }
+            CThreadPool::Shared().ParallelFor(Count, ProbeGrain, [&](std::size_t begin, std::size_t end) {
+                auto &Output = Outputs[begin / ProbeGrain];
+                Output.clear();
+                std::vector<std::string> Row;
+                for (std::size_t Index = begin; Index < end; Index++) {
+                    Probe(table, Block[Index], Row, [&Output](const std::vector<std::string> &row) {
+                        Output.push_back(row);
+                        return true;
+                    });
+                }
+            });
+            for (std::size_t Chunk = 0; Chunk * ProbeGrain < Count; Chunk++) {
+                for (auto &Row : Outputs[Chunk]) {
+                    if (!writer.WriteRow(Row)) return false;
+                }
+            }
+            if (Count < ProbeBlock) {
+                return true;
+            }
+        }
+    }
+
+    bool Spill(std::vector<std::unique_ptr<CDSVSpillFile>> &partitions, const std::vector<std::string> &normalized, std::size_t depth) {
+        return partitions[PartitionOf(CDSVHashTable::Hash(normalized, SpilledKeys), depth)]->WriteRow(normalized);
+    }
+
+    bool SpillProbe(std::vector<std::unique_ptr<CDSVSpillFile>> &partitions, const std::vector<std::string> &row, std::size_t depth) {
+        return partitions[PartitionOf(CDSVHashTable::Hash(row, ProbeKeys), depth)]->WriteRow(row);
+    }
+
+    bool OpenPartitions(std::vector<std::unique_ptr<CDSVSpillFile>> &partitions) {
+        for (std::size_t Index = 0; Index < PartitionCount; Index++) {
+            partitions.push_back(std::make_unique<CDSVSpillFile>(TempDir));
+            if (!partitions.back()->IsOpen()) return false;
+        }
+        return true;
+    }
+
+    // builds the table for one partition and streams its probe rows through it,
+    // a build side over budget is split again instead
+    bool JoinPartition(CDSVSpillFile &build, CDSVSpillFile &probe, std::size_t budget, std::size_t depth, const TFlush &flush) {
+        if (!build.Rows() && (Type == EType::Inner || Type == EType::Semi)) {
+            return true;  // no probe row of this partition can match
+        }
+        {
+            CDSVHashTable Table(SpilledKeys);
+            std::vector<std::string> Row;
+            bool Fits = true;
+            if (!build.Rewind()) return false;
+            while (Fits && build.ReadRow(Row)) {
+                Table.Insert(Row);
+                Fits = Table.Bytes() <= budget;
+            }
+            if (Fits) {
+                std::vector<std::vector<std::string>> Batch;
+                if (!probe.Rewind()) return false;
+                bool Result = ProbeAll(Table, probe, [&](const std::vector<std::string> &row) {
+                    Batch.push_back(row);
+                    return Batch.size() < OutputBatch || flush(Batch);
+                });
+                return Result && flush(Batch);
+            }
+        }
+        return SplitPartition(build, probe, budget, depth, flush);
+    }
+
+    // spreads both sides of a partition over partitions on the next hash bits
+    // and joins each, rows the hash cannot spread are joined in chunks
+    bool SplitPartition(CDSVSpillFile &build, CDSVSpillFile &probe, std::size_t budget, std::size_t depth, const TFlush &flush) {
+        if (depth + 1 < MaxDepth) {
+            std::vector<std::unique_ptr<CDSVSpillFile>> BuildPartitions, ProbePartitions;
+            std::vector<std::string> Row;
+            if (!OpenPartitions(BuildPartitions) || !build.Rewind()) return false;
+            while (build.ReadRow(Row)) {
+                if (!Spill(BuildPartitions, Row, depth + 1)) return false;
+            }
+            // one key, or keys the hash cannot tell apart, all land in one partition
+            bool Spread = std::none_of(BuildPartitions.begin(), BuildPartitions.end(), [&build](const std::unique_ptr<CDSVSpillFile> &partition) {
+                return partition->Rows() == build.Rows();
+            });
+            if (Spread) {
+                if (!OpenPartitions(ProbePartitions) || !probe.Rewind()) return false;
+                while (probe.ReadRow(Row)) {
+                    if (!SpillProbe(ProbePartitions, Row, depth + 1)) return false;
+                }
+                for (std::size_t Index = 0; Index < PartitionCount; Index++) {
+                    if (!JoinPartition(*BuildPartitions[Index], *ProbePartitions[Index], budget, depth + 1, flush)) return false;
+                    BuildPartitions[Index].reset();
+                    ProbePartitions[Index].reset();
+                }
+                return true;
+            }
+        }
+        return JoinChunks(build, probe, budget, flush);
+    }
+
+    // fills the table with as many build rows as the budget allows and streams
+    // every probe row through it, chunk after chunk, Matched remembers the probe
+    // rows that found a match so Semi writes them once and Left and Anti write
+    // the unmatched ones at the end
+    bool JoinChunks(CDSVSpillFile &build, CDSVSpillFile &probe, std::size_t budget, const TFlush &flush) const {
+        CDSVHashTable Table(SpilledKeys);
+        std::vector<bool> Matched(probe.Rows());
+        std::vector<std::string> Row, Output;
+        std::vector<std::vector<std::string>> Batch;
+        auto Emit = [&](const std::vector<std::string> &row) {
+            Batch.push_back(row);
+            return Batch.size() < OutputBatch || flush(Batch);
+        };
+        bool More = build.Rewind();
+        while (More) {
+            Table.Clear();
+            while ((More = build.ReadRow(Row))) {
+                Table.Insert(Row);
+                if (Table.Bytes() > budget) break;
+            }
+            if (!Table.Rows() || !probe.Rewind()) break;
+            for (std::size_t Index = 0; probe.ReadRow(Row); Index++) {
+                std::uint32_t Match = Table.Find(Row, ProbeKeys);
+                if (Match == CDSVHashTable::NoRow) continue;
+                if (Type == EType::Inner || Type == EType::Left) {
+                    for (; Match != CDSVHashTable::NoRow; Match = Table.NextRow(Match)) {
+                        Output.assign(Row.begin(), Row.end());
+                        Table.AppendPayload(Match, Output);
+                        if (!Emit(Output)) return false;
+                    }
+                } else if (Type == EType::Semi && !Matched[Index] && !Emit(Row)) {
+                    return false;
+                }
+                Matched[Index] = true;
+            }
+        }
+        if (Type == EType::Left || Type == EType::Anti) {
+            if (!probe.Rewind()) return false;
+            for (std::size_t Index = 0; probe.ReadRow(Row); Index++) {
+                if (Matched[Index]) continue;
+                Output.assign(Row.begin(), Row.end());
+                if (Type == EType::Left) {
+                    Output.resize(Row.size() + Width);
+                }
+                if (!Emit(Output)) return false;
+            }
+        }
+        return flush(Batch);
+    }
+
+    bool JoinSpilled(CDSVHashTable &table, CDSVReader &build, CDSVReader &probe, CDSVWriter &writer) {
+        DidSpill = true;
+        std::vector<std::unique_ptr<CDSVSpillFile>> BuildPartitions, ProbePartitions;
+        if (!OpenPartitions(BuildPartitions) || !OpenPartitions(ProbePartitions)) return false;
+        if (!table.Export([&](const std::vector<std::string> &row) { return Spill(BuildPartitions, row, 0); })) return false;
+        table.Clear();
+        std::vector<std::string> Row, Normalized;
+        while (build.ReadRow(Row)) {
+            Measure(Row);
+            Normalize(Row, BuildKeys, Normalized);
+            if (!Spill(BuildPartitions, Normalized, 0)) return false;
+        }
+        while (probe.ReadRow(Row)) {
+            if (!SpillProbe(ProbePartitions, Row, 0)) return false;
+        }
+        // partitions joined at once share the budget, so the tables in flight stay within it
+        std::size_t Concurrent = 1;
+        if (Parallel && CThreadPool::Shared().ThreadCount() > 1) {
+            Concurrent = std::min(PartitionCount, CThreadPool::Shared().ThreadCount() + 1);
+        }
+        std::size_t Budget = MemoryBudget / Concurrent;
+
+        std::mutex WriterMutex;
+        std::atomic<bool> Failed{false};
+        auto Flush = [&](std::vector<std::vector<std::string>> &batch) {
+            std::lock_guard<std::mutex> Lock(WriterMutex);
+            for (auto &Output : batch) {
+                if (!writer.WriteRow(Output)) return false;
+            }
+            batch.clear();
+            return true;
+        };
+        auto Run = [&](std::size_t begin, std::size_t end) {
+            for (std::size_t Index = begin; Index < end && !Failed; Index++) {
+                if (!JoinPartition(*BuildPartitions[Index], *ProbePartitions[Index], Budget, 0, Flush)) {
+                    Failed = true;
+                }
+                BuildPartitions[Index].reset();
+                ProbePartitions[Index].reset();
+            }
+        };
+        if (Parallel) {
+            CThreadPool::Shared().ParallelFor(PartitionCount, 1, Run);
+        } else {
+            Run(0, PartitionCount);
+        }
+        return !Failed;
+    }
+
+    bool Join(CDSVReader &build, CDSVReader &probe, CDSVWriter &writer) {
+        DidSpill = false;
+        Width = 0;
+        if (BuildKeys.size() != ProbeKeys.size()) {
+            return false;  // the keys could never be compared column for column
+        }
+        CDSVHashTable Table(BuildKeys);
+        std::vector<std::string> Row;
+        while (build.ReadRow(Row)) {
+            Measure(Row);
+            Table.Insert(Row);
+            if (Table.Bytes() > MemoryBudget) {
+                return JoinSpilled(Table, build, probe, writer);
+            }
+        }
+        if (Parallel) {
+            return ProbeParallel(Table, probe, writer);
+        }
+        return ProbeAll(Table, probe, [&writer](const std::vector<std::string> &row) { return writer.WriteRow(row); });
+    }
+};
+
+// buildkeys and probekeys are matched column for column, memorybudget bounds
+// the build table and tempdir picks where partitions are spilled, empty means
+// TMPDIR or /tmp, parallel spreads the probing, and spilled partitions, across
+// the shared pool
+CDSVHashJoin::CDSVHashJoin(std::vector<std::size_t> buildkeys, std::vector<std::size_t> probekeys, EType type, std::size_t memorybudget, const std::string &tempdir, bool parallel)
+    : DImplementation(std::make_unique<SImplementation>(std::move(buildkeys), std::move(probekeys), type, memorybudget, tempdir, parallel)) {}
+
+CDSVHashJoin::~CDSVHashJoin() = default;
+
+// reads the whole build side, then streams the probe side through it, output
+// follows probe order unless the join spilled, then it goes partition by
+// partition, fails without reading if the key lists differ in length
+bool CDSVHashJoin::Join(CDSVReader &build, CDSVReader &probe, CDSVWriter &writer) {
+    return DImplementation->Join(build, probe, writer);
+}
+
+// true when the last Join had to spill partitions to disk
+bool CDSVHashJoin::Spilled() const {
+    return DImplementation->DidSpill;
+}
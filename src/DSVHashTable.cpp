@@ -0,0 +1,204 @@
+#include "DSVHashTable.h"
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+namespace {
+
+// marks a slot that holds no key
+const std::uint64_t EmptyKey = UINT64_MAX;
+
+std::string_view Field(const std::vector<std::string> &row, std::size_t column) {
+    return column < row.size() ? std::string_view(row[column]) : std::string_view();
+}
+
+// fields are packed as a 32 bit length followed by the bytes
+void AppendField(std::vector<char> &arena, std::string_view field) {
+    std::uint32_t Length = field.size();
+    const char *Bytes = reinterpret_cast<const char *>(&Length);
+    arena.insert(arena.end(), Bytes, Bytes + sizeof(Length));
+    arena.insert(arena.end(), field.begin(), field.end());
+}
+
+std::string_view ReadField(const char *&data) {
+    std::uint32_t Length;
+    std::memcpy(&Length, data, sizeof(Length));
+    std::string_view Result(data + sizeof(Length), Length);
+    data += sizeof(Length) + Length;
+    return Result;
+}
+
+}
+
+CDSVHashTable::CDSVHashTable(std::vector< std::size_t > keys) : DKeys(std::move(keys)), DSize(0), DWidth(0){
+
+}
+
+std::uint64_t CDSVHashTable::Hash(const std::vector< std::string > &row, const std::vector< std::size_t > &keys){
+    std::uint64_t Result = 0x243F6A8885A308D3ULL;
+    for(auto Column : keys){
+        Result = (Result ^ std::hash<std::string_view>()(Field(row, Column))) * 0x9E3779B97F4A7C15ULL;
+        Result ^= Result >> 32;
+    }
+    return Result;
+}
+
+bool CDSVHashTable::KeyEquals(std::uint64_t key, const std::vector< std::string > &row, const std::vector< std::size_t > &keys) const{
+    const char *Data = DKeyArena.data() + key;
+    for(auto Column : keys){
+        if(ReadField(Data) != Field(row, Column)){
+            return false;
+        }
+    }
+    return true;
+}
+
+// slot holding the key, or the empty slot where it would go
+std::size_t CDSVHashTable::Locate(std::uint64_t hash, const std::vector< std::string > &row, const std::vector< std::size_t > &keys) const{
+    std::size_t Mask = DSlots.size() - 1;
+    for(std::size_t Index = hash & Mask;; Index = (Index + 1) & Mask){
+        const SSlot &Slot = DSlots[Index];
+        if(Slot.DKey == EmptyKey || (Slot.DHash == hash && KeyEquals(Slot.DKey, row, keys))){
+            return Index;
+        }
+    }
+}
+
+std::size_t CDSVHashTable::Claim(std::size_t slot, std::uint64_t hash, const std::vector< std::string > &row){
+    DSlots[slot] = {hash, DKeyArena.size(), NoRow, NoRow};
+    for(auto Column : DKeys){
+        AppendField(DKeyArena, Field(row, Column));
+    }
+    DSize++;
+    return slot;
+}
+
+// doubles the slots once they are 70% full, the stored hashes place every key again
+void CDSVHashTable::Grow(){
+    if(!DSlots.empty() && (DSize + 1) * 10 <= DSlots.size() * 7){
+        return;
+    }
+    std::vector<SSlot> Old(std::max<std::size_t>(DSlots.size() * 2, 16), SSlot{0, EmptyKey, NoRow, NoRow});
+    Old.swap(DSlots);
+    std::size_t Mask = DSlots.size() - 1;
+    for(const auto &Slot : Old){
+        if(Slot.DKey != EmptyKey){
+            std::size_t Index = Slot.DHash & Mask;
+            while(DSlots[Index].DKey != EmptyKey){
+                Index = (Index + 1) & Mask;
+            }
+            DSlots[Index] = Slot;
+        }
+    }
+}
+
+void CDSVHashTable::Insert(const std::vector< std::string > &row){
+    Grow();
+    std::uint64_t KeyHash = Hash(row, DKeys);
+    std::size_t Index = Locate(KeyHash, row, DKeys);
+    if(DSlots[Index].DKey == EmptyKey){
+        Claim(Index, KeyHash, row);
+    }
+    SRow Row{DPayloadArena.size(), 0, NoRow};
+    for(std::size_t Column = 0; Column < row.size(); Column++){
+        if(std::find(DKeys.begin(), DKeys.end(), Column) == DKeys.end()){
+            AppendField(DPayloadArena, row[Column]);
+            Row.DFields++;
+        }
+    }
+    DWidth = std::max<std::size_t>(DWidth, Row.DFields);
+    std::uint32_t RowIndex = DRows.size();
+    DRows.push_back(Row);
+    SSlot &Slot = DSlots[Index];
+    if(Slot.DHead == NoRow){
+        Slot.DHead = RowIndex;
+    }
+    else{
+        DRows[Slot.DTail].DNext = RowIndex;
+    }
+    Slot.DTail = RowIndex;
+}
+
+bool CDSVHashTable::InsertKey(const std::vector< std::string > &row){
+    Grow();
+    std::uint64_t KeyHash = Hash(row, DKeys);
+    std::size_t Index = Locate(KeyHash, row, DKeys);
+    if(DSlots[Index].DKey != EmptyKey){
+        return false;
+    }
+    Claim(Index, KeyHash, row);
+    return true;
+}
+
+std::uint32_t CDSVHashTable::Find(const std::vector< std::string > &row, const std::vector< std::size_t > &keys) const{
+    if(DSlots.empty() || keys.size() != DKeys.size()){
+        return NoRow;
+    }
+    const SSlot &Slot = DSlots[Locate(Hash(row, keys), row, keys)];
+    return Slot.DKey == EmptyKey ? NoRow : Slot.DHead;
+}
+
+bool CDSVHashTable::Contains(const std::vector< std::string > &row, const std::vector< std::size_t > &keys) const{
+    return !DSlots.empty() && keys.size() == DKeys.size() && DSlots[Locate(Hash(row, keys), row, keys)].DKey != EmptyKey;
+}
+
+std::uint32_t CDSVHashTable::NextRow(std::uint32_t row) const{
+    return DRows[row].DNext;
+}
+
+void CDSVHashTable::AppendPayload(std::uint32_t row, std::vector< std::string > &fields) const{
+    const char *Data = DPayloadArena.data() + DRows[row].DPayload;
+    for(std::uint32_t Index = 0; Index < DRows[row].DFields; Index++){
+        fields.emplace_back(ReadField(Data));
+    }
+}
+
+std::size_t CDSVHashTable::Size() const{
+    return DSize;
+}
+
+std::size_t CDSVHashTable::Rows() const{
+    return DRows.size();
+}
+
+std::size_t CDSVHashTable::Width() const{
+    return DWidth;
+}
+
+std::size_t CDSVHashTable::Bytes() const{
+    return DSlots.size() * sizeof(SSlot) + DRows.size() * sizeof(SRow) + DKeyArena.size() + DPayloadArena.size();
+}
+
+void CDSVHashTable::Clear(){
+    DSlots.clear();
+    DRows.clear();
+    DKeyArena.clear();
+    DPayloadArena.clear();
+    DSize = 0;
+    DWidth = 0;
+}
+
+bool CDSVHashTable::Export(const std::function< bool(const std::vector< std::string > &) > &callback) const{
+    std::vector<std::string> Fields;
+    for(const auto &Slot : DSlots){
+        if(Slot.DKey == EmptyKey){
+            continue;
+        }
+        Fields.clear();
+        const char *Data = DKeyArena.data() + Slot.DKey;
+        for(std::size_t Index = 0; Index < DKeys.size(); Index++){
+            Fields.emplace_back(ReadField(Data));
+        }
+        if(Slot.DHead == NoRow && !callback(Fields)){
+            return false;
+        }
+        for(std::uint32_t Row = Slot.DHead; Row != NoRow; Row = DRows[Row].DNext){
+            Fields.resize(DKeys.size());
+            AppendPayload(Row, Fields);
+            if(!callback(Fields)){
+                return false;
+            }
+        }
+    }
+    return true;
+}
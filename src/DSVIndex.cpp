@@ -0,0 +1,173 @@
+#include "DSVIndex.h"
+#include "SeekableDataSource.h"
+#include "Varint.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// identifies a sidecar index file and its layout version
+const char IndexMagic[4] = {'D', 'S', 'V', 'I'};
+const char IndexVersion = 1;
+
+// bytes pulled from the source per scan step
+const std::size_t ScanChunk = 1 << 16;
+
+}
+
+CDSVIndex::CDSVIndex(std::size_t stride)
+    : DStride(std::max<std::size_t>(stride, 1)), DRowCount(0), DEndOffset(0) {}
+
+std::size_t CDSVIndex::Stride() const noexcept {
+    return DStride;
+}
+
+// number of rows CDSVReader::ReadRow returns for the indexed stream
+std::size_t CDSVIndex::RowCount() const noexcept {
+    return DRowCount;
+}
+
+// source offset just past the last indexed byte
+std::size_t CDSVIndex::EndOffset() const noexcept {
+    return DEndOffset;
+}
+
+// finds the nearest sampled row at or before row, the reader seeks to offset
+// and then skips the given number of rows
+bool CDSVIndex::Locate(std::size_t row, std::size_t &offset, std::size_t &skip) const noexcept {
+    if (row > DRowCount) {
+        return false;
+    }
+    std::size_t Sample = row / DStride;
+    if (Sample >= DOffsets.size()) {
+        offset = DEndOffset;
+        skip = 0;
+        return true;
+    }
+    offset = DOffsets[Sample];
+    skip = row - Sample * DStride;
+    return true;
+}
+
+// picks up to parts ranges of roughly equal byte size, each starting on a
+// sampled row, the result holds the boundaries including both ends
+std::vector<CDSVIndex::SSplit> CDSVIndex::Splits(std::size_t parts) const {
+    std::vector<SSplit> Result;
+    if (DOffsets.empty()) {
+        Result.push_back({0, DEndOffset});
+        return Result;
+    }
+    parts = std::max<std::size_t>(parts, 1);
+    Result.push_back({0, DOffsets[0]});
+    std::size_t Span = DEndOffset - DOffsets[0];
+    for (std::size_t Part = 1; Part < parts; Part++) {
+        std::size_t Target = DOffsets[0] + Span / parts * Part;
+        auto Found = std::lower_bound(DOffsets.begin(), DOffsets.end(), Target);
+        if (Found == DOffsets.end()) {
+            break;
+        }
+        std::size_t Sample = Found - DOffsets.begin();
+        if (Sample * DStride > Result.back().DRow) {
+            Result.push_back({Sample * DStride, *Found});
+        }
+    }
+    Result.push_back({DRowCount, DEndOffset});
+    return Result;
+}
+
+// scans the source from its current position using the same quote and line
+// ending rules as CDSVReader, a doubled quote is a literal and does not toggle
+bool CDSVIndex::Build(std::shared_ptr<CDataSource> src) {
+    if (!src) {
+        return false;
+    }
+    auto Seekable = std::dynamic_pointer_cast<CSeekableDataSource>(src);
+    std::size_t Offset = Seekable ? Seekable->Tell() : 0;
+    bool Quotes = false; // inside a quoted field
+    bool PendingQuote = false; // saw a quote, waiting to see if it is doubled
+    bool PendingCR = false; // saw a row ending carriage return
+    bool RowStart = true; // next byte begins a new row
+
+    DOffsets.clear();
+    DRowCount = 0;
+    std::vector<char> Chunk;
+    while (src->Read(Chunk, ScanChunk)) {
+        for (char c : Chunk) {
+            if (PendingCR) {
+                PendingCR = false;
+                if (c == '\n') {
+                    Offset++;
+                    continue;
+                }
+            }
+            if (PendingQuote) {
+                PendingQuote = false;
+                if (c == '"') {
+                    Offset++;
+                    continue;
+                }
+                Quotes = !Quotes;
+            }
+            if (RowStart) {
+                if (DRowCount % DStride == 0) {
+                    DOffsets.push_back(Offset);
+                }
+                DRowCount++;
+                RowStart = false;
+            }
+            if (c == '"') {
+                PendingQuote = true;
+            } else if ((c == '\n' || c == '\r') && !Quotes) {
+                RowStart = true;
+                PendingCR = c == '\r';
+            }
+            Offset++;
+        }
+    }
+    DEndOffset = Offset;
+    return true;
+}
+
+// writes the index as magic, version, stride, row count and delta encoded offsets
+bool CDSVIndex::Save(std::shared_ptr<CDataSink> sink) const {
+    std::vector<char> Buffer(IndexMagic, IndexMagic + sizeof(IndexMagic));
+    Buffer.push_back(IndexVersion);
+    Varint::Append(Buffer, DStride);
+    Varint::Append(Buffer, DRowCount);
+    Varint::Append(Buffer, DOffsets.size());
+    std::size_t Previous = 0;
+    for (auto Offset : DOffsets) {
+        Varint::Append(Buffer, Offset - Previous);
+        Previous = Offset;
+    }
+    Varint::Append(Buffer, DEndOffset - Previous);
+    return sink && sink->Write(Buffer);
+}
+
+// reads an index written by Save, leaves this index untouched on failure
+bool CDSVIndex::Load(std::shared_ptr<CDataSource> src) {
+    std::vector<char> Header;
+    if (!src || !src->Read(Header, sizeof(IndexMagic) + 1) || Header.size() != sizeof(IndexMagic) + 1 ||
+        std::memcmp(Header.data(), IndexMagic, sizeof(IndexMagic)) != 0 || Header.back() != IndexVersion) {
+        return false;
+    }
+    std::uint64_t Stride, RowCount, Count, Delta;
+    if (!Varint::Read(*src, Stride) || !Varint::Read(*src, RowCount) || !Varint::Read(*src, Count) || !Stride) {
+        return false;
+    }
+    std::vector<std::size_t> Offsets;
+    std::size_t Previous = 0;
+    for (std::uint64_t Index = 0; Index <= Count; Index++) {
+        if (!Varint::Read(*src, Delta)) {
+            return false;
+        }
+        Previous += Delta;
+        Offsets.push_back(Previous);
+    }
+    DStride = Stride;
+    DRowCount = RowCount;
+    DEndOffset = Offsets.back();
+    Offsets.pop_back();
+    DOffsets = std::move(Offsets);
+    return true;
+}
@@ -0,0 +1,137 @@
+#include "DSVPushParser.h"
+
+struct CDSVPushParser::SImplementation {
+    char Delimiter; // character used as delimiter
+    TRowCallback Callback; // receives each completed row
+    std::vector<std::string> Row; // fields completed so far in the current row
+    std::string Field; // the field being read
+    bool Quotes = false; // inside quoted text
+    bool Data = false; // the current row has read any bytes
+    bool PendingQuote = false; // the last chunk ended on a quote, the next byte decides if it was doubled
+    bool PendingLF = false; // the last row ended on '\r', a following '\n' belongs to it
+    bool Done = false; // Finish has been called
+    std::size_t RowNumber = 0; // rows passed to the callback
+
+    SImplementation(char delimiter, TRowCallback callback)
+        : Delimiter(delimiter), Callback(std::move(callback)) {}
+
+    // true for the bytes that need more than copying outside quotes
+    bool Special(char c) const {
+        return c == Delimiter || c == '"' || c == '\n' || c == '\r';
+    }
+
+    // hands the current row to the callback and starts the next one
+    void EmitRow() {
+        if (!Field.empty() || !Row.empty()) {
+            Row.push_back(std::move(Field));
+        }
+        Field.clear();
+        if (Callback) {
+            Callback(Row);
+        }
+        Row.clear();
+        Quotes = false;
+        Data = false;
+        RowNumber++;
+    }
+
+    void Feed(const char *data, std::size_t length) {
+        const char *Ptr = data;
+        const char *Stop = data + length;
+        if (Ptr < Stop && PendingLF) {
+            PendingLF = false;
+            if (*Ptr == '\n') {
+                Ptr++;
+            }
+        }
+        if (Ptr < Stop && PendingQuote) {
+            PendingQuote = false;
+            if (*Ptr == '"') {
+                Field += '"'; // two quotes in a row means one quote in the data
+                Ptr++;
+            } else {
+                Quotes = !Quotes;
+            }
+        }
+        while (Ptr < Stop) {
+            Data = true;
+            // copy the run of plain bytes in one go
+            const char *Begin = Ptr;
+            if (Quotes) {
+                while (Ptr < Stop && *Ptr != '"') Ptr++;
+            } else {
+                while (Ptr < Stop && !Special(*Ptr)) Ptr++;
+            }
+            Field.append(Begin, Ptr);
+            if (Ptr == Stop) break;
+
+            char c = *Ptr++;
+            if (c == '"') {
+                if (Ptr == Stop) {
+                    PendingQuote = true; // decided by the first byte of the next chunk
+                } else if (*Ptr == '"') {
+                    Field += '"';
+                    Ptr++;
+                } else {
+                    Quotes = !Quotes;
+                }
+            } else if (c == Delimiter) {
+                Row.push_back(std::move(Field));
+                Field.clear();
+            } else {
+                EmitRow();
+                if (c == '\r') { // handle windows line endings
+                    if (Ptr == Stop) {
+                        PendingLF = true;
+                    } else if (*Ptr == '\n') {
+                        Ptr++;
+                    }
+                }
+            }
+        }
+    }
+};
+
+// the callback is called from inside Feed and Finish
+CDSVPushParser::CDSVPushParser(char delimiter, TRowCallback callback)
+    : DImplementation(std::make_unique<SImplementation>(delimiter, std::move(callback))) {}
+
+CDSVPushParser::~CDSVPushParser() = default;
+
+// parses the next chunk of input, fails once Finish has been called
+bool CDSVPushParser::Feed(const char *data, std::size_t length) {
+    if (DImplementation->Done) return false;
+    DImplementation->Feed(data, length);
+    return true;
+}
+
+// marks the end of input and emits the last row when it has no line ending,
+// returns whether a row was emitted
+bool CDSVPushParser::Finish() {
+    auto &Impl = *DImplementation;
+    if (Impl.Done) return false;
+    Impl.Done = true;
+    Impl.PendingQuote = false;
+    Impl.PendingLF = false;
+    if (!Impl.Data) return false;
+    Impl.EmitRow();
+    return true;
+}
+
+bool CDSVPushParser::Finished() const {
+    return DImplementation->Done;
+}
+
+// number of rows passed to the callback
+std::size_t CDSVPushParser::Row() const {
+    return DImplementation->RowNumber;
+}
+
+// drops any partial row so the parser can take a new stream
+void CDSVPushParser::Reset() {
+    auto &Impl = *DImplementation;
+    Impl.Row.clear();
+    Impl.Field.clear();
+    Impl.Quotes = Impl.Data = Impl.PendingQuote = Impl.PendingLF = Impl.Done = false;
+    Impl.RowNumber = 0;
+}
@@ -1,80 +1,317 @@
 #include "DSVReader.h"
+#include "SeekableDataSource.h"
+#include "Trace.h"
 #include <sstream>
 #include <iostream>
 
 // this structure handles reading delimiter-separated values from a data source
 struct CDSVReader::SImplementation {
     std::shared_ptr<CDataSource> Source;  // holds our data source
+    std::shared_ptr<CSeekableDataSource> Seekable; // same source when it supports seeking
+    std::shared_ptr<const CDSVIndex> Index; // optional row offset index for seeking
     char Delimiter; // the character that splits the data into columns
+    std::vector<char> Buffer; // block of bytes pulled from the source
+    std::size_t BufferIndex = 0; // next unread byte in the buffer
+    std::size_t BufferBase = 0; // source offset of the first buffered byte
+    std::size_t Origin = 0; // source offset of row zero, where the source stood at construction
+    std::size_t RowNumber = 0; // rows returned so far
+    CIOStatsCounters Stats{SIOStats::EKind::DSVReader}; // compiled out unless ENABLE_IOSTATS
+    std::uint64_t BlockStart = 0; // trace time the current buffer started being tokenized
+    std::shared_ptr<CMemoryAccount> Account; // charged for the buffer and the row being read, may be null
+    std::size_t Charged = 0; // bytes currently charged to the account
+    std::size_t RowStart = 0; // source offset where the row being read began
+    bool Refused = false; // the account refused to let a row grow, reading stops
+
+    // bytes requested from the source per refill
+    static const std::size_t RefillSize = 1 << 16;
     
     // constructor sets up the data source and the delimiter
-    SImplementation(std::shared_ptr<CDataSource> src, char delimiter)
-        : Source(std::move(src)), Delimiter(delimiter) {}
+    SImplementation(std::shared_ptr<CDataSource> src, char delimiter, std::shared_ptr<const CDSVIndex> index, std::shared_ptr<CMemoryAccount> account)
+        : Source(std::move(src)), Index(std::move(index)), Delimiter(delimiter), Account(std::move(account)) {
+        Seekable = std::dynamic_pointer_cast<CSeekableDataSource>(Source);
+        BufferBase = Origin = Seekable ? Seekable->Tell() : 0;
+    }
+
+    ~SImplementation() {
+        if (Account) {
+            Account->Credit(Charged);
+        }
+    }
+
+    // charges the buffer and the bytes of the row read so far, the row's
+    // fields hold about that much, a refusal stops the reader for good
+    bool Charge(std::size_t rowbytes) {
+        if (Account && !Refused && !Account->Resize(Charged, Buffer.capacity() + rowbytes)) {
+            Refused = true;
+        }
+        return !Refused;
+    }
+
+    // closes the trace span for tokenizing the current buffer
+    void EndBlock() {
+        if (BlockStart) {
+            CTrace::Record("DSVReader::Tokenize", BlockStart, CTrace::Now());
+            BlockStart = 0;
+        }
+    }
+
+    // pulls the next block from the source once the buffer is used up
+    bool Fill() {
+        if (BufferIndex < Buffer.size()) {
+            return true;
+        }
+        EndBlock();
+        BufferBase += Buffer.size();
+        BufferIndex = 0;
+        CIOStatsTimer Timer;
+        bool Filled;
+        {
+            TRACE_SPAN("DSVReader::Refill");
+            Filled = Source->Read(Buffer, RefillSize);
+        }
+        Stats.AddIOTime(Timer.Nanoseconds());
+        BlockStart = Filled ? CTrace::Now() : 0;
+        if (!Filled || !Charge(BufferBase - RowStart)) {
+            Buffer.clear();
+            return false;
+        }
+        return true;
+    }
+
+    bool AtEnd() {
+        if (Refused) {
+            return true;
+        }
+        if (BufferIndex >= Buffer.size() && Source->End()) {
+            EndBlock();
+            return true;
+        }
+        return false;
+    }
+
+    bool Get(char &c) {
+        if (!Fill()) return false;
+        c = Buffer[BufferIndex++];
+        return true;
+    }
+
+    bool Peek(char &c) {
+        if (!Fill()) return false;
+        c = Buffer[BufferIndex];
+        return true;
+    }
     
-    // reads a row of data, splitting it by delimiter and handling quotes
-    bool ReadRow(std::vector<std::string> &row) {
-        row.clear(); // start with a fresh row
-        std::string right; // collects the characters between delimiters
+    // reads a row and records its size and the time spent outside source reads
+    template <bool Store, typename TRow>
+    bool ParseRow(TRow &row) {
+        CIOStatsTimer Timer;
+        std::uint64_t IOBefore = Stats.IOTime();
+        std::size_t Start = BufferBase + BufferIndex;
+        RowStart = Start;
+        bool Result = ParseRowData<Store>(row);
+        if (!Charge(0)) {
+            // the row was cut off where the account refused it
+            if (Store) row.clear();
+            Result = false;
+        }
+        if (Result) {
+            Stats.AddBytes(BufferBase + BufferIndex - Start);
+            Stats.AddRecord(BufferBase + BufferIndex - Start);
+        }
+        Stats.AddProcessTime(Timer.Nanoseconds() - (Stats.IOTime() - IOBefore));
+        return Result;
+    }
+
+    // the cleared string for a column, reusing the one an earlier row left there
+    template <typename TRow>
+    static typename TRow::value_type &Slot(TRow &row, std::size_t column) {
+        if (column == row.size()) {
+            row.emplace_back();
+        }
+        row[column].clear();
+        return row[column];
+    }
+
+    // reads a row of data, splitting it by delimiter and handling quotes, when
+    // Store is false the row is only skipped, the strings already in the row
+    // are refilled so their capacity carries over from row to row
+    template <bool Store, typename TRow>
+    bool ParseRowData(TRow &row) {
+        std::size_t column = 0; // the column being read
+        typename TRow::value_type *right = nullptr; // collects the characters between delimiters
+        if (Store) right = &Slot(row, column);
         char c; // the current character being read
         bool quotes = false; // inside quoted text
+        bool quoted = false; // the current column opened a quote
         bool data = false; // read any data
-        
-        while (!Source->End()) {
-            if (!Source->Get(c)) return false; // if we can't read anymore, we are done
+
+        // keeps the last column when it has data or follows a delimiter
+        auto endRow = [&]() {
+            if (!Store) return;
+            if (!right->empty() || column) {
+                Stats.AddField(right->size(), quoted);
+                column++;
+            }
+            row.resize(column);
+        };
+
+        while (!AtEnd()) {
+            if (!Get(c)) { // if we can't read anymore, we are done
+                if (Store) row.clear();
+                return false;
+            }
             data = true;
-            
+
             if (c == '"') { // handle quotes
                 char next;
-                if (!Source->End() && Source->Peek(next)) {
+                if (!AtEnd() && Peek(next)) {
                     if (next == '"') { // two quotes in a row means add one quote to the data
-                        Source->Get(next);
-                        right += '"';
+                        Get(next);
+                        if (Store) *right += '"';
                     } else {
                         quotes = !quotes; // flip  quote boool
+                        quoted = true;
                     }
                 } else {
                     quotes = !quotes; // flip  quote bool
+                    quoted = true;
                 }
             } else if (c == Delimiter && !quotes) {
-                row.push_back(std::move(right)); // end of a column
-                right.clear();
-            } else if ((c == '\n' || c == '\r') && !quotes) {
-                if (!right.empty() || !row.empty()) {
-                    row.push_back(std::move(right)); // end of a row
+                if (Store) {
+                    Stats.AddField(right->size(), quoted);
+                    right = &Slot(row, ++column); // end of a column
                 }
-                
-                if (c == '\r' && !Source->End()) {  // handle windows line endings
+                quoted = false;
+            } else if ((c == '\n' || c == '\r') && !quotes) {
+                endRow(); // end of a row
+
+                if (c == '\r' && !AtEnd()) {  // handle windows line endings
                     char next;
-                    if (Source->Peek(next) && next == '\n') {
-                        Source->Get(next);
+                    if (Peek(next) && next == '\n') {
+                        Get(next);
                     }
                 }
+                RowNumber++;
                 return true; // we read a full row
-            } else {
-                right += c; // just another character in the current column
+            } else if (Store) {
+                *right += c; // just another character in the current column
             }
         }
-        
-        if (!right.empty() || !row.empty()) {
-            row.push_back(std::move(right)); // make sure to capture the last column
-        }
+
+        endRow(); // make sure to capture the last column
+        RowNumber += data;
         return data; // return whether we read any data at all
     }
+
+    // fills the block with up to count rows, starting it afresh
+    std::size_t ParseRows(TDSVRowBlock &block, std::size_t count) {
+        block.Clear();
+        while (block.Size() < count && ParseRow<true>(block.Next())) {
+            block.Commit();
+        }
+        return block.Size();
+    }
+
+    // jumps to a byte offset the caller knows is the start of the given row
+    bool Seek(std::size_t offset, std::size_t row) {
+        if (!Seekable || !Seekable->Seek(offset)) return false;
+        Buffer.clear();
+        BufferIndex = 0;
+        BufferBase = offset;
+        RowNumber = row;
+        return true;
+    }
+
+    // moves to the start of a row, through the index when there is one and
+    // otherwise by rescanning from where the reader started
+    bool SeekRow(std::size_t row) {
+        if (!Seekable) return false;
+        std::size_t offset = Origin;
+        std::size_t skip = row;
+        if (Index && !Index->Locate(row, offset, skip)) return false;
+        if (!Seek(offset, row - skip)) return false;
+        std::vector<std::string> scratch;
+        while (skip && ParseRow<false>(scratch)) {
+            skip--;
+        }
+        return skip == 0;
+    }
 };
 
-// constructor for initializing the DSV reader with a source and delimiter
-CDSVReader::CDSVReader(std::shared_ptr<CDataSource> src, char delimiter)
-    : DImplementation(std::make_unique<SImplementation>(src, delimiter)) {}
+// constructor for initializing the DSV reader with a source and delimiter, the
+// optional index lets SeekRow jump straight to a nearby row, and the optional
+// account is charged for the buffer and the row being read, a row that would
+// take it past its limit fails the read and ends the reader
+CDSVReader::CDSVReader(std::shared_ptr<CDataSource> src, char delimiter, std::shared_ptr<const CDSVIndex> index, std::shared_ptr<CMemoryAccount> account)
+    : DImplementation(std::make_unique<SImplementation>(src, delimiter, std::move(index), std::move(account))) {}
 
 // simple destructor
 CDSVReader::~CDSVReader() = default;
 
 // checks if all data has been read
 bool CDSVReader::End() const {
-    return DImplementation->Source->End();
+    return DImplementation->AtEnd();
 }
 
 // tries to read a row into the provided vector, each element represents a column
 bool CDSVReader::ReadRow(std::vector<std::string> &row) {
-    return DImplementation->ReadRow(row);
+    return DImplementation->ParseRow<true>(row);
+}
+
+// reads a row whose strings come from the vector's memory resource
+bool CDSVReader::ReadRow(std::pmr::vector<std::pmr::string> &row) {
+    return DImplementation->ParseRow<true>(row);
+}
+
+// replaces the block's contents with up to count rows and returns how many were
+// read, the block's rows are refilled in place so a reused block stops allocating
+std::size_t CDSVReader::ReadRows(TDSVRowBlock &block, std::size_t count) {
+    return DImplementation->ParseRows(block, count);
+}
+
+// lazily reads the remaining rows, one row buffer is reused for every step
+CGenerator<std::vector<std::string>> CDSVReader::Rows() {
+    std::vector<std::string> row;
+    while (ReadRow(row)) {
+        co_yield row;
+    }
+}
+
+// number of the next row to be read, counting from zero
+std::size_t CDSVReader::Row() const {
+    return DImplementation->RowNumber;
+}
+
+// source offset of the next unread byte
+std::size_t CDSVReader::Offset() const {
+    return DImplementation->BufferBase + DImplementation->BufferIndex;
+}
+
+// positions the reader so the next ReadRow returns the given row, requires a
+// seekable source
+bool CDSVReader::SeekRow(std::size_t row) {
+    return DImplementation->SeekRow(row);
+}
+
+// positions the reader at a known row boundary, such as one recorded by an
+// index or zone map, requires a seekable source
+bool CDSVReader::Seek(std::size_t offset, std::size_t row) {
+    return DImplementation->Seek(offset, row);
+}
+
+// the position after the last row read, cheap enough to take after every row
+SDSVCheckpoint CDSVReader::Checkpoint() const {
+    return {Offset(), Row()};
+}
+
+// continues from a checkpoint taken on the same data, requires a seekable source
+bool CDSVReader::Resume(const SDSVCheckpoint &checkpoint) {
+    return DImplementation->Seek(checkpoint.DOffset, checkpoint.DRow);
+}
+
+// counters for this reader, all zero unless built with ENABLE_IOSTATS
+SIOStats CDSVReader::Stats() const {
+    SIOStats Result = DImplementation->Stats.Snapshot();
+    Result.DKind = SIOStats::EKind::DSVReader;
+    return Result;
 }
@@ -0,0 +1,226 @@
+#include "DSVSorter.h"
+#include "DSVSpillFile.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <future>
+
+namespace {
+
+// rows per chunk when a run is sorted across the pool
+const std::size_t SortGrain = 16384;
+
+// rough heap footprint of a row, used against the memory budget
+std::size_t RowBytes(const std::vector<std::string> &row) {
+    std::size_t Bytes = sizeof(row) + row.capacity() * sizeof(std::string);
+    for (auto &Field : row) {
+        if (Field.capacity() > 15) {
+            Bytes += Field.capacity() + 1;
+        }
+    }
+    return Bytes;
+}
+
+// a row together with its numeric keys parsed once up front
+struct SSortRow {
+    std::vector<std::string> Fields;
+    std::vector<double> Numbers;
+};
+
+}
+
+struct CDSVSorter::SImplementation {
+    std::vector<SKey> Keys; // sort columns in priority order
+    std::size_t MemoryBudget; // bytes of rows held at once
+    std::string TempDir; // where runs are spilled
+    std::size_t Runs = 0; // runs produced by the last Sort
+
+    SImplementation(std::vector<SKey> keys, std::size_t memorybudget, const std::string &tempdir)
+        : Keys(std::move(keys)), MemoryBudget(std::max<std::size_t>(memorybudget, 1 << 16)), TempDir(tempdir) {}
+
+    // fills in the parsed numeric keys, fields that are not numbers become nan
+    void Prepare(SSortRow &row) const {
+        row.Numbers.clear();
+        for (auto &Key : Keys) {
+            double Value = std::nan("");
+            if (Key.DNumeric && Key.DColumn < row.Fields.size()) {
+                const std::string &Field = row.Fields[Key.DColumn];
+                auto Result = std::from_chars(Field.data(), Field.data() + Field.size(), Value);
+                if (Result.ec != std::errc() || Result.ptr != Field.data() + Field.size()) {
+                    Value = std::nan("");
+                }
+            }
+            row.Numbers.push_back(Value);
+        }
+    }
+
+    // compares by each key in turn, non numbers sort before numbers and
+    // missing columns compare as empty strings
+    int Compare(const SSortRow &left, const SSortRow &right) const {
+        static const std::string Empty;
+        for (std::size_t Index = 0; Index < Keys.size(); Index++) {
+            const SKey &Key = Keys[Index];
+            int Result = 0;
+            if (Key.DNumeric) {
+                double Left = left.Numbers[Index], Right = right.Numbers[Index];
+                bool LeftNumber = !std::isnan(Left), RightNumber = !std::isnan(Right);
+                if (LeftNumber != RightNumber) {
+                    Result = LeftNumber ? 1 : -1;
+                } else if (LeftNumber) {
+                    Result = Left < Right ? -1 : Right < Left ? 1 : 0;
+                }
+            }
+            if (!Result) {
+                const std::string &Left = Key.DColumn < left.Fields.size() ? left.Fields[Key.DColumn] : Empty;
+                const std::string &Right = Key.DColumn < right.Fields.size() ? right.Fields[Key.DColumn] : Empty;
+                Result = Left.compare(Right);
+            }
+            if (Result) {
+                return Key.DDescending ? -Result : Result;
+            }
+        }
+        return 0;
+    }
+
+    // stable sorts chunks of the run on the pool and then merges neighbours pairwise
+    void SortRun(std::vector<SSortRow> &run) const {
+        auto Less = [this](const SSortRow &left, const SSortRow &right) { return Compare(left, right) < 0; };
+        CThreadPool &Pool = CThreadPool::Shared();
+        Pool.ParallelFor(run.size(), SortGrain, [&](std::size_t begin, std::size_t end) {
+            std::stable_sort(run.begin() + begin, run.begin() + end, Less);
+        });
+        for (std::size_t Width = SortGrain; Width < run.size(); Width *= 2) {
+            std::size_t Pairs = (run.size() + 2 * Width - 1) / (2 * Width);
+            Pool.ParallelFor(Pairs, 1, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t Pair = begin; Pair < end; Pair++) {
+                    std::size_t Left = Pair * 2 * Width;
+                    std::size_t Middle = std::min(Left + Width, run.size());
+                    std::size_t Right = std::min(Left + 2 * Width, run.size());
+                    std::inplace_merge(run.begin() + Left, run.begin() + Middle, run.begin() + Right, Less);
+                }
+            });
+        }
+    }
+
+    static bool WriteRun(std::vector<SSortRow> &run, CDSVWriter &writer) {
+        for (auto &Row : run) {
+            if (!writer.WriteRow(Row.Fields)) return false;
+        }
+        return true;
+    }
+
+    // merges the spilled runs, the loser tree keeps the index of the source that
+    // lost at each internal node and the overall winner in slot zero
+    bool Merge(std::vector<std::unique_ptr<CDSVSpillFile>> &files, CDSVWriter &writer) const {
+        std::size_t Count = files.size();
+        std::vector<SSortRow> Heads(Count);
+        std::vector<bool> Live(Count);
+        for (std::size_t Index = 0; Index < Count; Index++) {
+            if (!files[Index]->Rewind()) return false;
+            Live[Index] = files[Index]->ReadRow(Heads[Index].Fields);
+            if (Live[Index]) Prepare(Heads[Index]);
+        }
+        // source a beats source b, Count stands for a sentinel that beats everything
+        auto Beats = [&](std::size_t a, std::size_t b) {
+            if (a == Count || b == Count) return a == Count;
+            if (Live[a] != Live[b]) return bool(Live[a]);
+            if (!Live[a]) return a < b;
+            int Result = Compare(Heads[a], Heads[b]);
+            return Result < 0 || (Result == 0 && a < b); // earlier runs win ties to stay stable
+        };
+        std::vector<std::size_t> Tree(Count, Count);
+        auto Adjust = [&](std::size_t source) {
+            for (std::size_t Node = (source + Count) / 2; Node > 0; Node /= 2) {
+                if (Beats(Tree[Node], source)) std::swap(Tree[Node], source);
+            }
+            Tree[0] = source;
+        };
+        for (std::size_t Index = Count; Index-- > 0;) {
+            Adjust(Index);
+        }
+        while (Count && Live[Tree[0]]) {
+            std::size_t Winner = Tree[0];
+            if (!writer.WriteRow(Heads[Winner].Fields)) return false;
+            Live[Winner] = files[Winner]->ReadRow(Heads[Winner].Fields);
+            if (Live[Winner]) Prepare(Heads[Winner]);
+            Adjust(Winner);
+        }
+        return true;
+    }
+
+    bool Sort(CDSVReader &reader, CDSVWriter &writer) {
+        // half the budget fills the next run while the previous one is sorted and spilled
+        std::size_t RunBudget = MemoryBudget / 2;
+        std::vector<std::unique_ptr<CDSVSpillFile>> Files;
+        std::future<bool> Spilling;
+        std::vector<SSortRow> Run, Spill;
+        std::size_t RunSize = 0;
+        SSortRow Row;
+        Runs = 0;
+
+        auto StartSpill = [&]() {
+            if (Spilling.valid() && !Spilling.get()) return false;
+            Spill.swap(Run);
+            Run.clear();
+            RunSize = 0;
+            Files.push_back(std::make_unique<CDSVSpillFile>(TempDir));
+            CDSVSpillFile *File = Files.back().get();
+            if (!File->IsOpen()) return false;
+            Spilling = std::async(std::launch::async, [this, File, &Spill]() {
+                SortRun(Spill);
+                for (auto &Sorted : Spill) {
+                    if (!File->WriteRow(Sorted.Fields)) return false;
+                }
+                Spill.clear();
+                return true;
+            });
+            return true;
+        };
+
+        bool Ok = true;
+        while (Ok && reader.ReadRow(Row.Fields)) {
+            Prepare(Row);
+            RunSize += RowBytes(Row.Fields) + sizeof(SSortRow) + Keys.size() * sizeof(double);
+            Run.push_back(std::move(Row));
+            Row = SSortRow();
+            if (RunSize >= RunBudget) {
+                Ok = StartSpill();
+            }
+        }
+        if (Spilling.valid() && !Spilling.get()) Ok = false;
+        if (!Ok) return false;
+
+        Runs = Files.size() + !Run.empty();
+        SortRun(Run);
+        if (Files.empty()) {
+            return WriteRun(Run, writer);
+        }
+        if (!Run.empty()) {
+            Files.push_back(std::make_unique<CDSVSpillFile>(TempDir));
+            for (auto &Sorted : Run) {
+                if (!Files.back()->WriteRow(Sorted.Fields)) return false;
+            }
+            Run.clear();
+        }
+        return Merge(Files, writer);
+    }
+};
+
+// keys are compared in order, memorybudget bounds the bytes of rows kept in
+// memory and tempdir picks where runs are spilled, empty means TMPDIR or /tmp
+CDSVSorter::CDSVSorter(std::vector<SKey> keys, std::size_t memorybudget, const std::string &tempdir)
+    : DImplementation(std::make_unique<SImplementation>(std::move(keys), memorybudget, tempdir)) {}
+
+CDSVSorter::~CDSVSorter() = default;
+
+// reads every row from reader and writes them to writer in key order, rows
+// with equal keys keep their input order
+bool CDSVSorter::Sort(CDSVReader &reader, CDSVWriter &writer) {
+    return DImplementation->Sort(reader, writer);
+}
+
+// number of sorted runs the last Sort produced, one when nothing was spilled
+std::size_t CDSVSorter::RunCount() const {
+    return DImplementation->Runs;
+}
@@ -0,0 +1,149 @@
+#include "DSVSpillFile.h"
+#include "Varint.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+// a spill file is unlinked right after creation so it disappears with the handle
+struct CDSVSpillFile::SImplementation {
+    std::FILE *File = nullptr; // handle to the unlinked temporary file
+    std::vector<char> Buffer; // pending output or buffered input
+    std::size_t BufferIndex = 0; // next byte to decode when reading
+    std::size_t RowCount = 0; // rows written
+    std::size_t ByteCount = 0; // bytes written
+    std::size_t Unread = 0; // bytes of the file not yet read into the buffer
+    bool Reading = false; // set by Rewind
+    bool Eof = false; // the file has been read to the end
+
+    // bytes gathered before each write and read
+    static constexpr std::size_t BlockSize = 1 << 20;
+
+    SImplementation(const std::string &tempdir) {
+        std::string Path = (tempdir.empty() ? DefaultTempDir() : tempdir) + "/dsvspillXXXXXX";
+        int Handle = mkstemp(&Path[0]);
+        if (Handle >= 0) {
+            unlink(Path.c_str());
+            File = fdopen(Handle, "w+b");
+            if (!File) {
+                close(Handle);
+            }
+        }
+    }
+
+    ~SImplementation() {
+        if (File) {
+            std::fclose(File);
+        }
+    }
+
+    bool FlushBuffer() {
+        if (!Buffer.empty() && std::fwrite(Buffer.data(), 1, Buffer.size(), File) != Buffer.size()) {
+            return false;
+        }
+        ByteCount += Buffer.size();
+        Buffer.clear();
+        return true;
+    }
+
+    bool WriteRow(const std::vector<std::string> &row) {
+        if (!File || Reading) return false;
+        Varint::Append(Buffer, row.size());
+        for (auto &Field : row) {
+            Varint::Append(Buffer, Field.size());
+            Buffer.insert(Buffer.end(), Field.begin(), Field.end());
+        }
+        RowCount++;
+        return Buffer.size() < BlockSize || FlushBuffer();
+    }
+
+    bool Rewind() {
+        if (!File || (!Reading && !FlushBuffer())) return false;
+        Reading = true;
+        Eof = false;
+        Unread = ByteCount;
+        Buffer.clear();
+        BufferIndex = 0;
+        return std::fflush(File) == 0 && std::fseek(File, 0, SEEK_SET) == 0;
+    }
+
+    // keeps the undecoded tail and appends the next block from the file, a
+    // small file only gets a buffer its own size
+    bool Refill() {
+        if (Eof) return false;
+        Buffer.erase(Buffer.begin(), Buffer.begin() + BufferIndex);
+        BufferIndex = 0;
+        std::size_t Old = Buffer.size();
+        std::size_t Wanted = std::min(BlockSize, Unread);
+        Buffer.resize(Old + Wanted);
+        std::size_t Length = std::fread(Buffer.data() + Old, 1, Wanted, File);
+        Buffer.resize(Old + Length);
+        Unread -= Length;
+        Eof = Length < Wanted || !Unread;
+        return Length != 0;
+    }
+
+    // decodes one row from the buffer, false if the buffer ends first
+    bool Decode(std::vector<std::string> &row) {
+        const char *Ptr = Buffer.data() + BufferIndex;
+        const char *End = Buffer.data() + Buffer.size();
+        std::uint64_t Count, Length;
+        if (!Varint::Decode(Ptr, End, Count)) return false;
+        row.resize(Count);
+        for (auto &Field : row) {
+            if (!Varint::Decode(Ptr, End, Length) || std::uint64_t(End - Ptr) < Length) return false;
+            Field.assign(Ptr, Length);
+            Ptr += Length;
+        }
+        BufferIndex = Ptr - Buffer.data();
+        return true;
+    }
+
+    bool ReadRow(std::vector<std::string> &row) {
+        if (!File || !Reading) return false;
+        while (!Decode(row)) {
+            if (!Refill()) return false;
+        }
+        return true;
+    }
+};
+
+// creates the file in tempdir, or the default temporary directory when empty
+CDSVSpillFile::CDSVSpillFile(const std::string &tempdir)
+    : DImplementation(std::make_unique<SImplementation>(tempdir)) {}
+
+CDSVSpillFile::~CDSVSpillFile() = default;
+
+bool CDSVSpillFile::IsOpen() const {
+    return DImplementation->File != nullptr;
+}
+
+std::size_t CDSVSpillFile::Rows() const {
+    return DImplementation->RowCount;
+}
+
+std::size_t CDSVSpillFile::Bytes() const {
+    return DImplementation->ByteCount + (DImplementation->Reading ? 0 : DImplementation->Buffer.size());
+}
+
+// appends a row, only valid before Rewind
+bool CDSVSpillFile::WriteRow(const std::vector<std::string> &row) {
+    return DImplementation->WriteRow(row);
+}
+
+// finishes writing and moves back to the first row
+bool CDSVSpillFile::Rewind() {
+    return DImplementation->Rewind();
+}
+
+// reads the next row, reusing the strings already in row
+bool CDSVSpillFile::ReadRow(std::vector<std::string> &row) {
+    return DImplementation->ReadRow(row);
+}
+
+// TMPDIR when set, /tmp otherwise
+std::string CDSVSpillFile::DefaultTempDir() {
+    const char *Dir = std::getenv("TMPDIR");
+    return Dir && *Dir ? Dir : "/tmp";
+}
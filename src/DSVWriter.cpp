@@ -1,65 +1,206 @@
 #include "DSVWriter.h"
 #include "DataSink.h"
+#include "Trace.h"
+#include <array>
 
 // implementation structure for CDSVWriter, which handles writing to a data sink
 struct CDSVWriter::SImplementation {
     std::shared_ptr<CDataSink> Sink; // data sink for writing
     char Delimiter; // character used as delimiter
     bool QuoteAll; // determines if all fields should be quoted
+    bool CheckPlain; // the delimiter could show up in a formatted number or boolean
+    std::vector<char> Buffer; // rows not yet passed to the sink
+    std::size_t RowStart = 0; // offset of the current row in the buffer
+    std::size_t Fields = 0; // fields written to the current row
+    std::size_t SpaceStart = 0; // offset of the field being formatted in place
+    CIOStatsTimer Timer; // started when the buffer was last empty
+    CIOStatsCounters Stats{SIOStats::EKind::DSVWriter}; // compiled out unless ENABLE_IOSTATS
+    std::shared_ptr<CMemoryAccount> Account; // charged for the buffer's capacity, may be null
+    std::size_t Charged = 0; // bytes currently charged to the account
+    bool Refused = false; // the account refused room for the current row
+    std::array<char, 64> Scratch; // where a refused field is formatted and discarded
 
     // constructor for SImplementation, initializes the data sink, delimiter, and quote
-    SImplementation(std::shared_ptr<CDataSink> sink, char delimiter, bool quoteall)
-        : Sink(sink), Delimiter(delimiter), QuoteAll(quoteall) {}
+    SImplementation(std::shared_ptr<CDataSink> sink, char delimiter, bool quoteall, std::shared_ptr<CMemoryAccount> account)
+        : Sink(sink), Delimiter(delimiter), QuoteAll(quoteall),
+          CheckPlain(std::string_view("0123456789+-.eEinfatrulsINFATRULS").find(delimiter) != std::string_view::npos),
+          Account(std::move(account)) {}
 
-    // writes a row of data to the sink
-    bool WriteRow(const std::vector<std::string>& row) {
-        // sink is valid
-        if (!Sink) return false; 
-        // write only a newline for an empty row
-        if (row.empty()) {
-            return Sink->Put('\n');
-        }
-        // iterate over each field in the row
-        for (size_t i = 0; i < row.size(); ++i) {
-            bool quote = QuoteAll || row[i].find(Delimiter) != std::string::npos ||
-                              row[i].find('"') != std::string::npos || row[i].find('\n') != std::string::npos;
-            
-            if (quote) {
-                // start quoted field
-                if (!Sink->Put('"')) return false; 
-                // iterate over each character in the field
-                for (char c : row[i]) {
-                    if (c == '"') {
-                        // escape double quotes by doubling them
-                        if (!Sink->Put('"') || !Sink->Put('"')) return false;
-                    } else {
-                        // write the character as is
-                        if (!Sink->Put(c)) return false;
-                    }
-                }
-                // end quoted field
-                if (!Sink->Put('"')) return false; 
-            // if no quoting is needed, write the field character by character
-            } else {
-                for (char c : row[i]) {
-                    if (!Sink->Put(c)) return false;
+    ~SImplementation() {
+        if (Account) {
+            Account->Credit(Charged);
+        }
+    }
+
+    // makes room for length more bytes, charging the account before the
+    // buffer grows, growth doubles but stops at the limit so a row that fits
+    // under it is never refused for the slack
+    bool Reserve(std::size_t length) {
+        if (Refused) {
+            return false;
+        }
+        std::size_t Needed = Buffer.size() + length;
+        if (!Account || Needed <= Buffer.capacity()) {
+            return true;
+        }
+        std::size_t Capacity = std::max(Buffer.capacity() * 2, Needed);
+        if (Account->Limit()) {
+            Capacity = std::max(std::min(Capacity, Account->Limit()), Needed);
+        }
+        if (!Account->Resize(Charged, Capacity)) {
+            Refused = true;
+            return false;
+        }
+        Buffer.reserve(Capacity);
+        return true;
+    }
+
+    // appends one character to the row buffer
+    bool Put(char c) {
+        if (!Reserve(1)) {
+            return false;
+        }
+        Buffer.push_back(c);
+        return true;
+    }
+
+    // starts a row after any rows still buffered
+    void BeginRow() {
+        if (Buffer.empty()) {
+            Timer = CIOStatsTimer();
+        }
+        RowStart = Buffer.size();
+        Fields = 0;
+    }
+
+    // separates a field from the one before it
+    void Separate() {
+        if (Fields++) {
+            Put(Delimiter);
+        }
+    }
+
+    // writes a field, quoting it when it holds the delimiter, a double quote or a newline
+    void AppendString(std::string_view field) {
+        Separate();
+        std::size_t quotes = std::count(field.begin(), field.end(), '"');
+        bool quote = QuoteAll || quotes || field.find(Delimiter) != std::string_view::npos || field.find('\n') != std::string_view::npos;
+        if (!Reserve(quote ? field.size() + quotes + 2 : field.size())) {
+            return;
+        }
+        Stats.AddField(field.size(), quote);
+
+        if (quote) {
+            // start quoted field
+            Put('"');
+            // escape double quotes by doubling them
+            for (char c : field) {
+                if (c == '"') {
+                    Put('"');
                 }
+                Put(c);
             }
-            // add delimiter between fields, but not after the last field
-            if (i < row.size() - 1) {
-                if (!Sink->Put(Delimiter)) return false; 
+            // end quoted field
+            Put('"');
+        // if no quoting is needed, copy the field as is
+        } else {
+            Buffer.insert(Buffer.end(), field.begin(), field.end());
+        }
+    }
+
+    // room for a field of at most maxsize bytes to be formatted in place
+    char *AppendSpace(std::size_t maxsize) {
+        Separate();
+        // room for the field and the most quotes EndSpace can add, a refused
+        // field is formatted into the scratch space, which fits any MaxChars
+        if (!Reserve(maxsize + 3)) {
+            return Scratch.data();
+        }
+        if (QuoteAll) {
+            Put('"');
+        }
+        SpaceStart = Buffer.size();
+        Buffer.resize(SpaceStart + maxsize);
+        return Buffer.data() + SpaceStart;
+    }
+
+    // trims the space to what was formatted, such fields only need quotes when
+    // the delimiter is a character numbers are written with
+    void EndSpace(char *end) {
+        if (Refused) {
+            return;
+        }
+        Buffer.resize(end - Buffer.data());
+        std::size_t size = Buffer.size() - SpaceStart;
+        bool quote = QuoteAll;
+        if (!QuoteAll && CheckPlain && std::find(Buffer.begin() + SpaceStart, Buffer.end(), Delimiter) != Buffer.end()) {
+            Buffer.insert(Buffer.begin() + SpaceStart, '"');
+            quote = true;
+        }
+        if (quote) {
+            Put('"');
+        }
+        Stats.AddField(size, quote);
+    }
+
+    // ends the row and passes the buffered rows to the sink once there are at
+    // least flushsize bytes of them
+    bool EndRow(std::size_t flushsize) {
+        Put('\n');
+        if (Refused) {
+            // only the refused row is dropped, the rows accepted before it
+            // still reach the sink and the buffer is given back
+            Refused = false;
+            Buffer.resize(RowStart);
+            if (!Buffer.empty()) {
+                Flush();
             }
+            Buffer.shrink_to_fit();
+            Account->Resize(Charged, Buffer.capacity());
+            return false;
+        }
+        Stats.AddRecord(Buffer.size() - RowStart);
+        return Buffer.size() < flushsize || Flush();
+    }
+
+    // hands the buffer to the sink with a single write and records where the time went
+    bool Flush() {
+        if (!Sink) {
+            Buffer.clear();
+            return false;
+        }
+        std::uint64_t Format = Timer.Nanoseconds();
+        CIOStatsTimer WriteTimer;
+        bool Result;
+        {
+            TRACE_SPAN("DSVWriter::SinkWrite");
+            Result = Sink->Write(Buffer);
+        }
+        Stats.AddBytes(Buffer.size());
+        Stats.AddProcessTime(Format);
+        Stats.AddIOTime(WriteTimer.Nanoseconds());
+        Buffer.clear();
+        return Result;
+    }
+
+    // writes a row of data to the sink, an empty row is only a newline
+    bool WriteRow(const std::vector<std::string>& row) {
+        // sink is valid
+        if (!Sink) return false;
+        BeginRow();
+        for (const auto &field : row) {
+            AppendString(field);
         }
-        // end the row with a newline character
-        return Sink->Put('\n'); 
+        return EndRow(0);
     }
 };
 // constructor for DSV writer, sink specifies the data destination, delimiter
 // specifies the delimiting character, and quoteall specifies if all values
 // should be quoted or only those that contain the delimiter, a double quote,
-// or a newline
-CDSVWriter::CDSVWriter(std::shared_ptr<CDataSink> sink, char delimiter, bool quoteall)
-    : DImplementation(std::make_unique<SImplementation>(sink, delimiter, quoteall)) {}
+// or a newline, the optional account is charged for the row buffer and a row
+// that would take it past its limit is not written
+CDSVWriter::CDSVWriter(std::shared_ptr<CDataSink> sink, char delimiter, bool quoteall, std::shared_ptr<CMemoryAccount> account)
+    : DImplementation(std::make_unique<SImplementation>(sink, delimiter, quoteall, std::move(account))) {}
 
 // destructor for CDSVWriter
 CDSVWriter::~CDSVWriter() = default;
@@ -69,3 +210,30 @@ CDSVWriter::~CDSVWriter() = default;
 bool CDSVWriter::WriteRow(const std::vector<std::string>& row) {
     return DImplementation->WriteRow(row);
 }
+
+void CDSVWriter::BeginRow() {
+    DImplementation->BeginRow();
+}
+
+void CDSVWriter::AppendString(std::string_view field) {
+    DImplementation->AppendString(field);
+}
+
+char *CDSVWriter::AppendSpace(std::size_t maxsize) {
+    return DImplementation->AppendSpace(maxsize);
+}
+
+void CDSVWriter::EndSpace(char *end) {
+    DImplementation->EndSpace(end);
+}
+
+bool CDSVWriter::EndRow(std::size_t flushsize) {
+    return DImplementation->EndRow(flushsize);
+}
+
+// counters for this writer, all zero unless built with ENABLE_IOSTATS
+SIOStats CDSVWriter::Stats() const {
+    SIOStats Result = DImplementation->Stats.Snapshot();
+    Result.DKind = SIOStats::EKind::DSVWriter;
+    return Result;
+}
@@ -0,0 +1,320 @@
+#include "DSVZoneMap.h"
+#include "DSVReader.h"
+#include "Varint.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// identifies a sidecar zone map file and its layout version
+const char ZoneMapMagic[4] = {'D', 'S', 'V', 'Z'};
+const char ZoneMapVersion = 2;
+
+// version 1 files had a fixed filter of this many words
+const std::size_t LegacyBloomWords = 8;
+
+// number of bloom filter bits set per value
+const int BloomHashes = 3;
+
+// parses the whole field as a number, partial matches do not count
+bool ParseNumber(const std::string &str, double &value) {
+    if (str.empty()) {
+        return false;
+    }
+    const char *Begin = str.data();
+    const char *End = str.data() + str.size();
+    if (*Begin == '+') {
+        Begin++;
+    }
+    auto Result = std::from_chars(Begin, End, value);
+    return Result.ec == std::errc() && Result.ptr == End && value == value; // rejects nan
+}
+
+// 64 bit FNV-1a, stable across builds since the filters are persisted
+std::uint64_t HashValue(const std::string &str) {
+    std::uint64_t Hash = 14695981039346656037ULL;
+    for (unsigned char c : str) {
+        Hash = (Hash ^ c) * 1099511628211ULL;
+    }
+    return Hash;
+}
+
+// visits each bloom bit for a value using double hashing over a filter of words
+template <typename TVisit>
+void VisitBloomBits(const std::string &str, std::size_t words, TVisit visit) {
+    std::uint64_t Hash = HashValue(str);
+    std::uint64_t Step = (Hash >> 32) | 1;
+    for (int Index = 0; Index < BloomHashes; Index++) {
+        std::uint64_t Bit = (Hash + Index * Step) % (words * 64);
+        visit(Bit / 64, std::uint64_t(1) << (Bit % 64));
+    }
+}
+
+void AppendDouble(std::vector<char> &buf, double value) {
+    char Bytes[sizeof(double)];
+    std::memcpy(Bytes, &value, sizeof(double));
+    buf.insert(buf.end(), Bytes, Bytes + sizeof(double));
+}
+
+bool ReadRaw(CDataSource &src, void *data, std::size_t length) {
+    std::vector<char> Bytes;
+    if (!src.Read(Bytes, length) || Bytes.size() != length) {
+        return false;
+    }
+    std::memcpy(data, Bytes.data(), length);
+    return true;
+}
+
+}
+
+// exact per row check, comparisons are numeric and never match a field that is not a number
+bool CDSVZoneMap::SPredicate::Matches(const std::vector<std::string> &row) const {
+    const std::string Empty;
+    const std::string &Field = DColumn < row.size() ? row[DColumn] : Empty;
+    double FieldValue, Value;
+    switch (DOp) {
+        case EOp::Equal: return Field == DValue;
+        case EOp::Empty: return Field.empty();
+        case EOp::NotEmpty: return !Field.empty();
+        default: break;
+    }
+    if (!ParseNumber(Field, FieldValue) || !ParseNumber(DValue, Value)) {
+        return false;
+    }
+    switch (DOp) {
+        case EOp::Less: return FieldValue < Value;
+        case EOp::LessEqual: return FieldValue <= Value;
+        case EOp::Greater: return FieldValue > Value;
+        case EOp::GreaterEqual: return FieldValue >= Value;
+        default: return false;
+    }
+}
+
+// a filter sized from blockrows keeps false positives to a few percent for
+// columns whose values are all distinct, up to MaxBloomBits
+CDSVZoneMap::CDSVZoneMap(std::size_t blockrows, std::size_t bloombits)
+    : DBlockRows(std::max<std::size_t>(blockrows, 1)) {
+    std::size_t Bits = bloombits ? bloombits : std::min(DBlockRows * BloomBitsPerRow, MaxBloomBits);
+    DBloomWords = std::max<std::size_t>((std::min(Bits, MaxBloomBits) + 63) / 64, 1);
+}
+
+std::size_t CDSVZoneMap::BlockRows() const noexcept {
+    return DBlockRows;
+}
+
+std::size_t CDSVZoneMap::BloomBits() const noexcept {
+    return DBloomWords * 64;
+}
+
+const std::vector<CDSVZoneMap::SBlock> &CDSVZoneMap::Blocks() const noexcept {
+    return DBlocks;
+}
+
+// false only when the statistics prove no row in the block satisfies every predicate
+bool CDSVZoneMap::MayMatch(std::size_t block, const std::vector<SPredicate> &preds) const {
+    const SBlock &Block = DBlocks[block];
+    for (auto &Pred : preds) {
+        if (Pred.DColumn >= Block.DColumns.size()) {
+            // the column never appears in this block so every row sees it empty
+            if (Pred.DOp == SPredicate::EOp::Empty || (Pred.DOp == SPredicate::EOp::Equal && Pred.DValue.empty())) {
+                continue;
+            }
+            return false;
+        }
+        const SColumnStats &Stats = Block.DColumns[Pred.DColumn];
+        double Value;
+        bool Numeric = ParseNumber(Pred.DValue, Value);
+        switch (Pred.DOp) {
+            case SPredicate::EOp::Empty:
+                if (!Stats.DNullCount) return false;
+                break;
+            case SPredicate::EOp::NotEmpty:
+                if (Stats.DNullCount == Block.DRowCount) return false;
+                break;
+            case SPredicate::EOp::Equal:
+                if (Pred.DValue.empty()) {
+                    if (!Stats.DNullCount) return false;
+                    break;
+                }
+                if (Numeric && (!Stats.DNumericCount || Value < Stats.DMin || Value > Stats.DMax)) return false;
+                if (!Stats.DBloom.empty()) {
+                    bool Present = true;
+                    VisitBloomBits(Pred.DValue, Stats.DBloom.size(), [&](std::size_t word, std::uint64_t mask) {
+                        Present = Present && (Stats.DBloom[word] & mask);
+                    });
+                    if (!Present) return false;
+                }
+                break;
+            case SPredicate::EOp::Less:
+                if (!Numeric || !Stats.DNumericCount || Stats.DMin >= Value) return false;
+                break;
+            case SPredicate::EOp::LessEqual:
+                if (!Numeric || !Stats.DNumericCount || Stats.DMin > Value) return false;
+                break;
+            case SPredicate::EOp::Greater:
+                if (!Numeric || !Stats.DNumericCount || Stats.DMax <= Value) return false;
+                break;
+            case SPredicate::EOp::GreaterEqual:
+                if (!Numeric || !Stats.DNumericCount || Stats.DMax < Value) return false;
+                break;
+        }
+    }
+    return true;
+}
+
+std::vector<std::size_t> CDSVZoneMap::CandidateBlocks(const std::vector<SPredicate> &preds) const {
+    std::vector<std::size_t> Result;
+    for (std::size_t Block = 0; Block < DBlocks.size(); Block++) {
+        if (MayMatch(Block, preds)) {
+            Result.push_back(Block);
+        }
+    }
+    return Result;
+}
+
+// collects the statistics with one pass of CDSVReader over the source
+bool CDSVZoneMap::Build(std::shared_ptr<CDataSource> src, char delimiter) {
+    if (!src) {
+        return false;
+    }
+    CDSVReader Reader(src, delimiter);
+    std::vector<std::string> Row;
+    DBlocks.clear();
+    while (true) {
+        std::size_t Offset = Reader.Offset();
+        if (!Reader.ReadRow(Row)) {
+            break;
+        }
+        if (DBlocks.empty() || DBlocks.back().DRowCount == DBlockRows) {
+            DBlocks.push_back({Reader.Row() - 1, 0, Offset, {}});
+        }
+        SBlock &Block = DBlocks.back();
+        if (Row.size() > Block.DColumns.size()) {
+            // rows earlier in the block did not have these columns
+            SColumnStats Missing;
+            Missing.DNullCount = Block.DRowCount;
+            Missing.DBloom.assign(DBloomWords, 0);
+            Block.DColumns.resize(Row.size(), Missing);
+        }
+        for (std::size_t Column = 0; Column < Block.DColumns.size(); Column++) {
+            SColumnStats &Stats = Block.DColumns[Column];
+            if (Column >= Row.size() || Row[Column].empty()) {
+                Stats.DNullCount++;
+                continue;
+            }
+            double Value;
+            if (ParseNumber(Row[Column], Value)) {
+                Stats.DMin = Stats.DNumericCount ? std::min(Stats.DMin, Value) : Value;
+                Stats.DMax = Stats.DNumericCount ? std::max(Stats.DMax, Value) : Value;
+                Stats.DNumericCount++;
+            }
+            VisitBloomBits(Row[Column], Stats.DBloom.size(), [&Stats](std::size_t word, std::uint64_t mask) {
+                Stats.DBloom[word] |= mask;
+            });
+        }
+        Block.DRowCount++;
+    }
+    return true;
+}
+
+// writes magic, version, block rows, filter words and then each block with its column statistics
+bool CDSVZoneMap::Save(std::shared_ptr<CDataSink> sink) const {
+    std::vector<char> Buffer(ZoneMapMagic, ZoneMapMagic + sizeof(ZoneMapMagic));
+    Buffer.push_back(ZoneMapVersion);
+    Varint::Append(Buffer, DBlockRows);
+    Varint::Append(Buffer, DBloomWords);
+    Varint::Append(Buffer, DBlocks.size());
+    for (auto &Block : DBlocks) {
+        Varint::Append(Buffer, Block.DRow);
+        Varint::Append(Buffer, Block.DRowCount);
+        Varint::Append(Buffer, Block.DOffset);
+        Varint::Append(Buffer, Block.DColumns.size());
+        for (auto &Stats : Block.DColumns) {
+            Varint::Append(Buffer, Stats.DNullCount);
+            Varint::Append(Buffer, Stats.DNumericCount);
+            if (Stats.DNumericCount) {
+                AppendDouble(Buffer, Stats.DMin);
+                AppendDouble(Buffer, Stats.DMax);
+            }
+            const char *Bloom = reinterpret_cast<const char *>(Stats.DBloom.data());
+            Buffer.insert(Buffer.end(), Bloom, Bloom + Stats.DBloom.size() * sizeof(std::uint64_t));
+        }
+    }
+    return sink && sink->Write(Buffer);
+}
+
+// reads a zone map written by Save, including the fixed size filters of
+// version 1, leaves this map untouched on failure
+bool CDSVZoneMap::Load(std::shared_ptr<CDataSource> src) {
+    char Header[sizeof(ZoneMapMagic) + 1];
+    if (!src || !ReadRaw(*src, Header, sizeof(Header)) || std::memcmp(Header, ZoneMapMagic, sizeof(ZoneMapMagic)) != 0 ||
+        (Header[sizeof(ZoneMapMagic)] != ZoneMapVersion && Header[sizeof(ZoneMapMagic)] != 1)) {
+        return false;
+    }
+    std::uint64_t BlockRows, BloomWords = LegacyBloomWords, BlockCount, Row, RowCount, Offset, ColumnCount, NullCount, NumericCount;
+    if (!Varint::Read(*src, BlockRows) || !BlockRows) {
+        return false;
+    }
+    if (Header[sizeof(ZoneMapMagic)] == ZoneMapVersion && (!Varint::Read(*src, BloomWords) || !BloomWords || BloomWords > MaxBloomBits / 64)) {
+        return false;
+    }
+    if (!Varint::Read(*src, BlockCount)) {
+        return false;
+    }
+    std::vector<SBlock> Blocks;
+    for (std::uint64_t Index = 0; Index < BlockCount; Index++) {
+        if (!Varint::Read(*src, Row) || !Varint::Read(*src, RowCount) || !Varint::Read(*src, Offset) ||
+            !Varint::Read(*src, ColumnCount)) {
+            return false;
+        }
+        SBlock Block{Row, RowCount, Offset, {}};
+        for (std::uint64_t Column = 0; Column < ColumnCount; Column++) {
+            SColumnStats Stats;
+            if (!Varint::Read(*src, NullCount) || !Varint::Read(*src, NumericCount)) {
+                return false;
+            }
+            Stats.DNullCount = NullCount;
+            Stats.DNumericCount = NumericCount;
+            if (NumericCount && (!ReadRaw(*src, &Stats.DMin, sizeof(double)) || !ReadRaw(*src, &Stats.DMax, sizeof(double)))) {
+                return false;
+            }
+            Stats.DBloom.resize(BloomWords);
+            if (!ReadRaw(*src, Stats.DBloom.data(), BloomWords * sizeof(std::uint64_t))) {
+                return false;
+            }
+            Block.DColumns.push_back(Stats);
+        }
+        Blocks.push_back(std::move(Block));
+    }
+    DBlockRows = BlockRows;
+    DBloomWords = BloomWords;
+    DBlocks = std::move(Blocks);
+    return true;
+}
+
+// reads only the blocks that may match, seeking over the rest, and passes each
+// row satisfying every predicate to callback until it returns false
+bool CDSVZoneMap::Scan(std::shared_ptr<CSeekableDataSource> src, char delimiter, const std::vector<SPredicate> &preds, const std::function<bool(const std::vector<std::string> &)> &callback) const {
+    if (!src) {
+        return false;
+    }
+    CDSVReader Reader(src, delimiter);
+    std::vector<std::string> Row;
+    for (auto Block : CandidateBlocks(preds)) {
+        const SBlock &Current = DBlocks[Block];
+        if (Reader.Offset() != Current.DOffset && !Reader.Seek(Current.DOffset, Current.DRow)) {
+            return false;
+        }
+        for (std::size_t Index = 0; Index < Current.DRowCount && Reader.ReadRow(Row); Index++) {
+            bool Match = true;
+            for (auto &Pred : preds) {
+                Match = Match && Pred.Matches(Row);
+            }
+            if (Match && !callback(Row)) {
+                return true;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,419 @@
+#include "EncodingDataSource.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+enum class ESequence{Valid, Invalid, Truncated};
+
+// checks the sequence starting at data, on success length is its size and
+// otherwise the bytes that began a valid sequence, which is the maximal
+// subpart Unicode recommends replacing with a single U+FFFD
+ESequence CheckSequence(const unsigned char *data, std::size_t available, std::size_t &length) {
+    unsigned char Lead = data[0];
+    unsigned char Low = 0x80, High = 0xBF; // range of the second byte
+    std::size_t Need; // continuation bytes after the lead
+    if (Lead < 0x80) {
+        length = 1;
+        return ESequence::Valid;
+    } else if (Lead >= 0xC2 && Lead <= 0xDF) {
+        Need = 1;
+    } else if (Lead == 0xE0) { // no overlong forms
+        Need = 2;
+        Low = 0xA0;
+    } else if (Lead == 0xED) { // no surrogates
+        Need = 2;
+        High = 0x9F;
+    } else if (Lead >= 0xE1 && Lead <= 0xEF) {
+        Need = 2;
+    } else if (Lead == 0xF0) { // no overlong forms
+        Need = 3;
+        Low = 0x90;
+    } else if (Lead == 0xF4) { // nothing past U+10FFFF
+        Need = 3;
+        High = 0x8F;
+    } else if (Lead >= 0xF1 && Lead <= 0xF3) {
+        Need = 3;
+    } else {
+        length = 1;
+        return ESequence::Invalid;
+    }
+    for (std::size_t Index = 1; Index <= Need; Index++) {
+        if (Index >= available) {
+            length = Index;
+            return ESequence::Truncated;
+        }
+        if (data[Index] < Low || data[Index] > High) {
+            length = Index;
+            return ESequence::Invalid;
+        }
+        Low = 0x80;
+        High = 0xBF;
+    }
+    length = Need + 1;
+    return ESequence::Valid;
+}
+
+// number of leading bytes below 0x80, sixteen at a time where SSE2 is available
+std::size_t AsciiLength(const unsigned char *data, std::size_t length) {
+    std::size_t Index = 0;
+#ifdef __SSE2__
+    while (Index + 16 <= length) {
+        int Mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + Index)));
+        if (Mask) {
+            return Index + __builtin_ctz(Mask);
+        }
+        Index += 16;
+    }
+#endif
+    while (Index < length && data[Index] < 0x80) {
+        Index++;
+    }
+    return Index;
+}
+
+// length of the well formed prefix, skipping ASCII runs in bulk
+std::size_t ValidPrefix(const unsigned char *data, std::size_t length) {
+    std::size_t Index = 0;
+    while (Index < length) {
+        Index += AsciiLength(data + Index, length - Index);
+        if (Index == length) {
+            break;
+        }
+        std::size_t Length;
+        if (CheckSequence(data + Index, length - Index, Length) != ESequence::Valid) {
+            break;
+        }
+        Index += Length;
+    }
+    return Index;
+}
+
+char *PutCodePoint(char *out, std::uint32_t code) {
+    if (code < 0x80) {
+        *out++ = static_cast<char>(code);
+    } else if (code < 0x800) {
+        *out++ = static_cast<char>(0xC0 | (code >> 6));
+        *out++ = static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        *out++ = static_cast<char>(0xE0 | (code >> 12));
+        *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        *out++ = static_cast<char>(0xF0 | (code >> 18));
+        *out++ = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (code & 0x3F));
+    }
+    return out;
+}
+
+const std::uint32_t Replacement = 0xFFFD;
+
+}
+
+struct CEncodingDataSource::SImplementation {
+    std::shared_ptr<CDataSource> Source; // source of the encoded bytes
+    EEncoding Encoding; // encoding being read, Auto until sniffed
+    EInvalidPolicy Policy; // handling of malformed sequences
+    std::size_t BlockSize; // bytes requested from the source per read
+    std::vector<char> Block; // last block read from the source
+    std::vector<char> Raw; // bytes to convert, starting with any carried over
+    std::vector<char> Carry; // incomplete sequence left at the end of the last block
+    std::vector<char> Output; // converted bytes not yet read
+    std::size_t OutputIndex = 0; // next unread byte of the output
+    bool Sniffed = false; // the start of the input has been checked for a byte order mark
+    bool SourceDone = false; // the source has nothing more
+    bool Failed = false; // Reject stopped the output
+    std::size_t Invalid = 0; // sequences replaced or passed through
+
+    SImplementation(std::shared_ptr<CDataSource> src, EEncoding encoding, EInvalidPolicy policy, std::size_t blocksize)
+        : Source(std::move(src)), Encoding(encoding), Policy(policy), BlockSize(blocksize ? blocksize : 1) {}
+
+    // appends the next source block to the carried bytes, the block is taken
+    // over without copying when nothing was carried
+    void ReadBlock() {
+        if (SourceDone || !Source || !Source->Read(Block, BlockSize)) {
+            SourceDone = true;
+            Block.clear();
+        }
+        if (Raw.empty()) {
+            Raw.swap(Block);
+        } else {
+            Raw.insert(Raw.end(), Block.begin(), Block.end());
+        }
+    }
+
+    // strips a byte order mark and picks the encoding when it is Auto
+    void Sniff() {
+        while (Raw.size() < 4 && !SourceDone) {
+            ReadBlock();
+        }
+        Sniffed = true;
+        const unsigned char *Data = reinterpret_cast<const unsigned char *>(Raw.data());
+        std::size_t Length = Raw.size();
+        std::size_t Mark = 0;
+        EEncoding Found = EEncoding::Auto;
+        if (Length >= 3 && Data[0] == 0xEF && Data[1] == 0xBB && Data[2] == 0xBF) {
+            Found = EEncoding::UTF8;
+            Mark = 3;
+        } else if (Length >= 2 && Data[0] == 0xFF && Data[1] == 0xFE) {
+            Found = EEncoding::UTF16LE;
+            Mark = 2;
+        } else if (Length >= 2 && Data[0] == 0xFE && Data[1] == 0xFF) {
+            Found = EEncoding::UTF16BE;
+            Mark = 2;
+        }
+        // a mark for another encoding than the one asked for is left as data
+        if (Encoding == EEncoding::Auto || Encoding == Found) {
+            Raw.erase(Raw.begin(), Raw.begin() + Mark);
+        }
+        if (Encoding != EEncoding::Auto) {
+            return;
+        }
+        if (Found != EEncoding::Auto) {
+            Encoding = Found;
+        } else if (Length >= 2 && Data[0] && !Data[1] && (Length < 4 || (Data[2] && !Data[3]))) {
+            Encoding = EEncoding::UTF16LE; // ASCII text in UTF-16 has every other byte zero
+        } else if (Length >= 2 && !Data[0] && Data[1] && (Length < 4 || (!Data[2] && Data[3]))) {
+            Encoding = EEncoding::UTF16BE;
+        } else {
+            // valid UTF-8 or else Latin-1, reading on while a sequence is cut off by the block end
+            std::size_t Valid = ValidPrefix(Data, Length);
+            std::size_t SequenceLength;
+            while (Valid < Length && !SourceDone && CheckSequence(Data + Valid, Length - Valid, SequenceLength) == ESequence::Truncated) {
+                ReadBlock();
+                Data = reinterpret_cast<const unsigned char *>(Raw.data());
+                Length = Raw.size();
+                Valid += ValidPrefix(Data + Valid, Length - Valid);
+            }
+            Encoding = Valid == Length ? EEncoding::UTF8 : EEncoding::Latin1;
+        }
+    }
+
+    // deals with a malformed sequence, PassThrough keeps the UTF-8 bytes or the
+    // UTF-16 unit it came from, false when Reject ends the output
+    bool Malformed(char *&out, const char *begin, const char *end, std::uint32_t unit = Replacement) {
+        if (Policy == EInvalidPolicy::Reject) {
+            Failed = true;
+            return false;
+        }
+        Invalid++;
+        if (Policy == EInvalidPolicy::PassThrough && begin != end) {
+            out = std::copy(begin, end, out);
+        } else {
+            out = PutCodePoint(out, Policy == EInvalidPolicy::PassThrough ? unit : Replacement);
+        }
+        return true;
+    }
+
+    // validates the raw bytes, handing them over untouched when they are well formed
+    void ConvertUTF8(bool final) {
+        const unsigned char *Data = reinterpret_cast<const unsigned char *>(Raw.data());
+        std::size_t Length = Raw.size();
+        std::size_t Index = ValidPrefix(Data, Length);
+        if (Index == Length) {
+            Output.swap(Raw);
+            return;
+        }
+        Output.resize(Length * 3);
+        char *Out = std::copy(Raw.data(), Raw.data() + Index, Output.data());
+        while (Index < Length) {
+            std::size_t Valid = ValidPrefix(Data + Index, Length - Index);
+            Out = std::copy(Raw.data() + Index, Raw.data() + Index + Valid, Out);
+            Index += Valid;
+            if (Index == Length) {
+                break;
+            }
+            std::size_t Bad;
+            if (CheckSequence(Data + Index, Length - Index, Bad) == ESequence::Truncated && !final) {
+                Carry.assign(Raw.begin() + Index, Raw.end());
+                break;
+            }
+            if (!Malformed(Out, Raw.data() + Index, Raw.data() + Index + Bad)) {
+                break;
+            }
+            Index += Bad;
+        }
+        Output.resize(Out - Output.data());
+    }
+
+    // every Latin-1 byte is a code point, ASCII runs are copied in bulk
+    void ConvertLatin1() {
+        const unsigned char *Data = reinterpret_cast<const unsigned char *>(Raw.data());
+        std::size_t Length = Raw.size();
+        Output.resize(Length * 2);
+        char *Out = Output.data();
+        std::size_t Index = 0;
+        while (Index < Length) {
+            std::size_t Ascii = AsciiLength(Data + Index, Length - Index);
+            std::memcpy(Out, Data + Index, Ascii);
+            Out += Ascii;
+            Index += Ascii;
+            while (Index < Length && Data[Index] >= 0x80) {
+                *Out++ = static_cast<char>(0xC0 | (Data[Index] >> 6));
+                *Out++ = static_cast<char>(0x80 | (Data[Index] & 0x3F));
+                Index++;
+            }
+        }
+        Output.resize(Out - Output.data());
+    }
+
+    // joins surrogate pairs and narrows runs of ASCII units eight at a time
+    template <bool BigEndian>
+    void ConvertUTF16(bool final) {
+        const unsigned char *Data = reinterpret_cast<const unsigned char *>(Raw.data());
+        std::size_t Length = Raw.size();
+        auto Unit = [Data](std::size_t index) -> std::uint32_t {
+            return BigEndian ? (Data[index] << 8) | Data[index + 1] : (Data[index + 1] << 8) | Data[index];
+        };
+        Output.resize(Length / 2 * 3 + 3);
+        char *Out = Output.data();
+        std::size_t Index = 0;
+        while (Index + 2 <= Length) {
+            std::uint32_t Code = Unit(Index);
+            if (Code < 0x80) {
+                *Out++ = static_cast<char>(Code);
+                Index += 2;
+#ifdef __SSE2__
+                // ASCII tends to come in runs, so try the following units in bulk
+                while (Index + 16 <= Length) {
+                    __m128i Units = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Data + Index));
+                    if (BigEndian) {
+                        Units = _mm_or_si128(_mm_slli_epi16(Units, 8), _mm_srli_epi16(Units, 8));
+                    }
+                    __m128i High = _mm_and_si128(Units, _mm_set1_epi16(static_cast<short>(0xFF80)));
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi16(High, _mm_setzero_si128())) != 0xFFFF) {
+                        break;
+                    }
+                    _mm_storel_epi64(reinterpret_cast<__m128i *>(Out), _mm_packus_epi16(Units, Units));
+                    Out += 8;
+                    Index += 16;
+                }
+#endif
+                continue;
+            }
+            if (Code >= 0xD800 && Code <= 0xDBFF) {
+                if (Index + 4 > Length && !final) {
+                    break; // the low surrogate is in the next block
+                }
+                if (Index + 4 <= Length) {
+                    std::uint32_t Low = Unit(Index + 2);
+                    if (Low >= 0xDC00 && Low <= 0xDFFF) {
+                        Out = PutCodePoint(Out, 0x10000 + ((Code - 0xD800) << 10) + (Low - 0xDC00));
+                        Index += 4;
+                        continue;
+                    }
+                }
+                if (!Malformed(Out, nullptr, nullptr, Code)) {
+                    break;
+                }
+            } else if (Code >= 0xDC00 && Code <= 0xDFFF) {
+                if (!Malformed(Out, nullptr, nullptr, Code)) {
+                    break;
+                }
+            } else {
+                Out = PutCodePoint(Out, Code);
+            }
+            Index += 2;
+        }
+        if (Index < Length && !Failed) {
+            if (!final) {
+                Carry.assign(Raw.begin() + Index, Raw.end());
+            } else {
+                Malformed(Out, nullptr, nullptr); // an odd byte at the end
+            }
+        }
+        Output.resize(Out - Output.data());
+    }
+
+    // converts blocks until there is output or the input is used up
+    bool Fill() {
+        while (OutputIndex >= Output.size()) {
+            if (SourceDone && Raw.empty() && Carry.empty()) {
+                return false;
+            }
+            if (Failed) {
+                return false;
+            }
+            Output.clear();
+            OutputIndex = 0;
+            Raw.swap(Carry);
+            Carry.clear();
+            ReadBlock();
+            if (!Sniffed) {
+                Sniff();
+            }
+            switch (Encoding) {
+                case EEncoding::Latin1: ConvertLatin1(); break;
+                case EEncoding::UTF16LE: ConvertUTF16<false>(SourceDone); break;
+                case EEncoding::UTF16BE: ConvertUTF16<true>(SourceDone); break;
+                default: ConvertUTF8(SourceDone); break;
+            }
+            Raw.clear();
+        }
+        return true;
+    }
+};
+
+CEncodingDataSource::CEncodingDataSource(std::shared_ptr<CDataSource> src, EEncoding encoding, EInvalidPolicy policy, std::size_t blocksize)
+    : DImplementation(std::make_unique<SImplementation>(std::move(src), encoding, policy, blocksize)) {}
+
+CEncodingDataSource::~CEncodingDataSource() = default;
+
+EEncoding CEncodingDataSource::Encoding() const noexcept {
+    return DImplementation->Encoding;
+}
+
+bool CEncodingDataSource::Failed() const noexcept {
+    return DImplementation->Failed;
+}
+
+std::size_t CEncodingDataSource::InvalidSequences() const noexcept {
+    return DImplementation->Invalid;
+}
+
+bool CEncodingDataSource::End() const noexcept {
+    return !DImplementation->Fill();
+}
+
+bool CEncodingDataSource::Get(char &ch) noexcept {
+    if (!DImplementation->Fill()) {
+        return false;
+    }
+    ch = DImplementation->Output[DImplementation->OutputIndex++];
+    return true;
+}
+
+bool CEncodingDataSource::Peek(char &ch) noexcept {
+    if (!DImplementation->Fill()) {
+        return false;
+    }
+    ch = DImplementation->Output[DImplementation->OutputIndex];
+    return true;
+}
+
+// a whole converted block that fits is handed over by swapping buffers
+bool CEncodingDataSource::Read(std::vector<char> &buf, std::size_t count) noexcept {
+    auto &Impl = *DImplementation;
+    buf.clear();
+    while (buf.size() < count && Impl.Fill()) {
+        std::size_t Count = std::min(count - buf.size(), Impl.Output.size() - Impl.OutputIndex);
+        if (buf.empty() && !Impl.OutputIndex && Count == Impl.Output.size()) {
+            buf.swap(Impl.Output);
+            Impl.Output.clear();
+            continue;
+        }
+        buf.insert(buf.end(), Impl.Output.data() + Impl.OutputIndex, Impl.Output.data() + Impl.OutputIndex + Count);
+        Impl.OutputIndex += Count;
+    }
+    return !buf.empty();
+}
+
+std::size_t CEncodingDataSource::ValidUTF8Length(std::string_view data) noexcept {
+    return ValidPrefix(reinterpret_cast<const unsigned char *>(data.data()), data.size());
+}
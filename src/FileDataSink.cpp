@@ -0,0 +1,98 @@
+#include "FileDataSink.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+CFileDataSink::CFileDataSink(const std::string &path, std::size_t buffersize) : DOwned(true), DBuffer(std::max<std::size_t>(buffersize, 1)), DLength(0), DWritten(0){
+    DHandle = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+}
+
+CFileDataSink::CFileDataSink(SResume, const std::string &path, std::size_t resumeoffset, std::size_t buffersize) : DOwned(true), DBuffer(std::max<std::size_t>(buffersize, 1)), DLength(0), DWritten(resumeoffset){
+    DHandle = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if(DHandle < 0){
+        return;
+    }
+    struct stat Status;
+    if(fstat(DHandle, &Status) || static_cast<std::size_t>(Status.st_size) < resumeoffset || ftruncate(DHandle, resumeoffset) || lseek(DHandle, resumeoffset, SEEK_SET) < 0){
+        close(DHandle);
+        DHandle = -1;
+    }
+}
+
+std::shared_ptr<CFileDataSink> CFileDataSink::Resume(const std::string &path, std::size_t resumeoffset, std::size_t buffersize){
+    return std::shared_ptr<CFileDataSink>(new CFileDataSink(SResume(), path, resumeoffset, buffersize));
+}
+
+// writes to an already open descriptor such as standard output
+CFileDataSink::CFileDataSink(int fd, bool owned, std::size_t buffersize) : DHandle(fd), DOwned(owned), DBuffer(std::max<std::size_t>(buffersize, 1)), DLength(0), DWritten(0){
+
+}
+
+CFileDataSink::~CFileDataSink(){
+    Flush();
+    if(DOwned && DHandle >= 0){
+        close(DHandle);
+    }
+}
+
+bool CFileDataSink::IsOpen() const noexcept{
+    return DHandle >= 0;
+}
+
+bool CFileDataSink::WriteAll(const char *data, std::size_t length) noexcept{
+    if(DHandle < 0){
+        return false;
+    }
+    while(length){
+        ssize_t Written = write(DHandle, data, length);
+        if(Written < 0){
+            if(errno == EINTR){
+                continue;
+            }
+            return false;
+        }
+        data += Written;
+        length -= Written;
+        DWritten += Written;
+    }
+    return true;
+}
+
+// writes out any buffered bytes
+bool CFileDataSink::Flush() noexcept{
+    std::size_t Length = DLength;
+    DLength = 0;
+    return WriteAll(DBuffer.data(), Length);
+}
+
+std::size_t CFileDataSink::Offset() const noexcept{
+    return DWritten + DLength;
+}
+
+bool CFileDataSink::Put(const char &ch) noexcept{
+    if(DLength == DBuffer.size() && !Flush()){
+        return false;
+    }
+    DBuffer[DLength++] = ch;
+    return true;
+}
+
+// writes larger than the buffer go straight to the file
+bool CFileDataSink::Write(const std::vector<char> &buf) noexcept{
+    if(DLength + buf.size() > DBuffer.size()){
+        if(!Flush()){
+            return false;
+        }
+        if(buf.size() >= DBuffer.size()){
+            return WriteAll(buf.data(), buf.size());
+        }
+    }
+    if(!buf.empty()){
+        std::memcpy(DBuffer.data() + DLength, buf.data(), buf.size());
+    }
+    DLength += buf.size();
+    return DHandle >= 0;
+}
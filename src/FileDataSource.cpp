@@ -0,0 +1,107 @@
+#include "FileDataSource.h"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+CFileDataSource::CFileDataSource(const std::string &path, std::size_t buffersize) : DSize(0), DBuffer(std::max<std::size_t>(buffersize, 1)), DBufferOffset(0), DBufferIndex(0), DBufferLength(0){
+    DHandle = open(path.c_str(), O_RDONLY);
+    struct stat Status;
+    if(DHandle >= 0 && fstat(DHandle, &Status) == 0 && S_ISREG(Status.st_mode)){
+        DSize = Status.st_size;
+    }
+}
+
+CFileDataSource::~CFileDataSource(){
+    if(DHandle >= 0){
+        close(DHandle);
+    }
+}
+
+bool CFileDataSource::IsOpen() const noexcept{
+    return DHandle >= 0;
+}
+
+// refills the buffer once it has been consumed, false at end of file or on error
+bool CFileDataSource::Fill() const noexcept{
+    if(DBufferIndex < DBufferLength){
+        return true;
+    }
+    if(DHandle < 0){
+        return false;
+    }
+    ssize_t Length;
+    do{
+        Length = read(DHandle, DBuffer.data(), DBuffer.size());
+    }while(Length < 0 && errno == EINTR);
+    DBufferOffset += DBufferLength;
+    DBufferIndex = 0;
+    DBufferLength = Length > 0 ? Length : 0;
+    return DBufferLength != 0;
+}
+
+bool CFileDataSource::End() const noexcept{
+    return !Fill();
+}
+
+bool CFileDataSource::Get(char &ch) noexcept{
+    if(!Fill()){
+        return false;
+    }
+    ch = DBuffer[DBufferIndex++];
+    return true;
+}
+
+bool CFileDataSource::Peek(char &ch) noexcept{
+    if(!Fill()){
+        return false;
+    }
+    ch = DBuffer[DBufferIndex];
+    return true;
+}
+
+bool CFileDataSource::Read(std::vector<char> &buf, std::size_t count) noexcept{
+    buf.clear();
+    while(buf.size() < count && Fill()){
+        std::size_t Count = std::min(count - buf.size(), DBufferLength - DBufferIndex);
+        buf.insert(buf.end(), DBuffer.data() + DBufferIndex, DBuffer.data() + DBufferIndex + Count);
+        DBufferIndex += Count;
+    }
+    return !buf.empty();
+}
+
+// repositions within the file, reusing the buffer when the target is already loaded
+bool CFileDataSource::Seek(std::size_t offset) noexcept{
+    if(DHandle < 0){
+        return false;
+    }
+    if(offset >= DBufferOffset && offset <= DBufferOffset + DBufferLength){
+        DBufferIndex = offset - DBufferOffset;
+        return true;
+    }
+    if(lseek(DHandle, offset, SEEK_SET) < 0){
+        return false;
+    }
+    DBufferOffset = offset;
+    DBufferIndex = 0;
+    DBufferLength = 0;
+    return true;
+}
+
+std::size_t CFileDataSource::Tell() const noexcept{
+    return DBufferOffset + DBufferIndex;
+}
+
+std::size_t CFileDataSource::Size() const noexcept{
+    return DSize;
+}
+
+std::future<std::unique_ptr<CFileDataSource>> CFileDataSource::OpenAhead(const std::string &path, std::size_t buffersize){
+    return std::async(std::launch::async, [path, buffersize](){
+        auto Source = std::make_unique<CFileDataSource>(path, buffersize);
+        char Ch;
+        Source->Peek(Ch);
+        return Source;
+    });
+}
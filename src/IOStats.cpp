@@ -0,0 +1,82 @@
+#include "IOStats.h"
+#include <algorithm>
+#include <mutex>
+
+namespace {
+
+// the set of live counters, only touched when instances come and go or on snapshot
+struct SRegistry {
+    std::mutex Mutex;
+    std::vector<const CIOStatsCounters *> Counters;
+};
+
+SRegistry &Registry() {
+    static SRegistry Instance;
+    return Instance;
+}
+
+#ifdef ENABLE_IOSTATS
+std::atomic<std::uint64_t> NextId{1};
+#endif
+
+}
+
+#ifdef ENABLE_IOSTATS
+
+CIOStatsCounters::CIOStatsCounters(SIOStats::EKind kind) : DKind(kind), DId(NextId++) {
+    CIOStatsRegistry::Register(this);
+}
+
+CIOStatsCounters::~CIOStatsCounters() {
+    CIOStatsRegistry::Unregister(this);
+}
+
+SIOStats CIOStatsCounters::Snapshot() const {
+    SIOStats Stats;
+    Stats.DKind = DKind;
+    Stats.DId = DId;
+    Stats.DBytes = DBytes.load(std::memory_order_relaxed);
+    Stats.DRecords = DRecords.load(std::memory_order_relaxed);
+    Stats.DMaxFieldSize = DMaxFieldSize.load(std::memory_order_relaxed);
+    Stats.DMaxRecordSize = DMaxRecordSize.load(std::memory_order_relaxed);
+    Stats.DQuotedFields = DQuotedFields.load(std::memory_order_relaxed);
+    Stats.DParseCalls = DParseCalls.load(std::memory_order_relaxed);
+    Stats.DQueueHighWater = DQueueHighWater.load(std::memory_order_relaxed);
+    Stats.DIONanoseconds = DIONanoseconds.load(std::memory_order_relaxed);
+    Stats.DProcessNanoseconds = DProcessNanoseconds.load(std::memory_order_relaxed);
+    return Stats;
+}
+
+#else
+
+CIOStatsCounters::CIOStatsCounters(SIOStats::EKind) {}
+
+CIOStatsCounters::~CIOStatsCounters() {}
+
+// statistics are compiled out so there is nothing to report
+SIOStats CIOStatsCounters::Snapshot() const {
+    return SIOStats();
+}
+
+#endif
+
+void CIOStatsRegistry::Register(const CIOStatsCounters *counters) {
+    std::lock_guard<std::mutex> Lock(Registry().Mutex);
+    Registry().Counters.push_back(counters);
+}
+
+void CIOStatsRegistry::Unregister(const CIOStatsCounters *counters) {
+    std::lock_guard<std::mutex> Lock(Registry().Mutex);
+    auto &Counters = Registry().Counters;
+    Counters.erase(std::remove(Counters.begin(), Counters.end(), counters), Counters.end());
+}
+
+// copies the counters of every live reader and writer, empty when statistics are compiled out
+std::vector<SIOStats> CIOStatsRegistry::Snapshot() {
+    std::lock_guard<std::mutex> Lock(Registry().Mutex);
+    std::vector<SIOStats> Result;
+    for (auto Counters : Registry().Counters) {
+        Result.push_back(Counters->Snapshot());
+    }
+    return Result;
+}
@@ -0,0 +1,124 @@
+#include "MemoryAccount.h"
+#include <algorithm>
+#include <mutex>
+#include <new>
+
+namespace {
+
+// the set of live accounts, only touched when accounts come and go or on snapshot
+struct SRegistry {
+    std::mutex Mutex;
+    std::vector<const CMemoryAccount *> Accounts;
+};
+
+SRegistry &Registry() {
+    static SRegistry Instance;
+    return Instance;
+}
+
+}
+
+CMemoryAccount::CMemoryAccount(std::string name, std::size_t limit, std::pmr::memory_resource *upstream)
+    : DName(std::move(name)), DLimit(limit), DUpstream(upstream ? upstream : std::pmr::get_default_resource()) {
+    std::lock_guard<std::mutex> Lock(Registry().Mutex);
+    Registry().Accounts.push_back(this);
+}
+
+CMemoryAccount::~CMemoryAccount() {
+    std::lock_guard<std::mutex> Lock(Registry().Mutex);
+    auto &Accounts = Registry().Accounts;
+    Accounts.erase(std::remove(Accounts.begin(), Accounts.end(), this), Accounts.end());
+}
+
+void *CMemoryAccount::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if (!Charge(bytes)) {
+        throw std::bad_alloc();
+    }
+    try {
+        return DUpstream->allocate(bytes, alignment);
+    } catch (...) {
+        Credit(bytes);
+        throw;
+    }
+}
+
+void CMemoryAccount::do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) {
+    DUpstream->deallocate(ptr, bytes, alignment);
+    Credit(bytes);
+}
+
+// only the same account can free what it handed out, so its counts stay right
+bool CMemoryAccount::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+const std::string &CMemoryAccount::Name() const noexcept {
+    return DName;
+}
+
+std::size_t CMemoryAccount::Live() const noexcept {
+    return DLive.load(std::memory_order_relaxed);
+}
+
+std::size_t CMemoryAccount::Peak() const noexcept {
+    return DPeak.load(std::memory_order_relaxed);
+}
+
+std::size_t CMemoryAccount::Limit() const noexcept {
+    return DLimit;
+}
+
+bool CMemoryAccount::Exceeded() const noexcept {
+    return DRefused.load(std::memory_order_relaxed) != 0;
+}
+
+SMemoryStats CMemoryAccount::Stats() const {
+    SMemoryStats Result;
+    Result.DName = DName;
+    Result.DLive = Live();
+    Result.DPeak = Peak();
+    Result.DLimit = DLimit;
+    Result.DRefused = DRefused.load(std::memory_order_relaxed);
+    return Result;
+}
+
+// adds the bytes first and backs them out if that passed the limit, so
+// concurrent charges can never both slip under it
+bool CMemoryAccount::Charge(std::size_t bytes) noexcept {
+    std::size_t Live = DLive.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (DLimit && Live > DLimit) {
+        DLive.fetch_sub(bytes, std::memory_order_relaxed);
+        DRefused.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    std::size_t Peak = DPeak.load(std::memory_order_relaxed);
+    while (Live > Peak && !DPeak.compare_exchange_weak(Peak, Live, std::memory_order_relaxed)) {
+    }
+    return true;
+}
+
+void CMemoryAccount::Credit(std::size_t bytes) noexcept {
+    DLive.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+bool CMemoryAccount::Resize(std::size_t &charged, std::size_t bytes) noexcept {
+    if (bytes > charged) {
+        if (!Charge(bytes - charged)) {
+            return false;
+        }
+    } else {
+        Credit(charged - bytes);
+    }
+    charged = bytes;
+    return true;
+}
+
+// copies every live account
+std::vector<SMemoryStats> CMemoryAccount::Snapshot() {
+    std::lock_guard<std::mutex> Lock(Registry().Mutex);
+    std::vector<SMemoryStats> Result;
+    for (auto Account : Registry().Accounts) {
+        Result.push_back(Account->Stats());
+    }
+    return Result;
+}
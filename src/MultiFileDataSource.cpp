@@ -0,0 +1,225 @@
+#include "MultiFileDataSource.h"
+#include "FileDataSource.h"
+#include <algorithm>
+#include <dirent.h>
+#include <future>
+#include <glob.h>
+#include <string_view>
+#include <sys/stat.h>
+
+namespace {
+
+bool IsRegularFile(const std::string &path) {
+    struct stat Status;
+    return stat(path.c_str(), &Status) == 0 && S_ISREG(Status.st_mode);
+}
+
+}
+
+struct CMultiFileDataSource::SImplementation {
+    std::vector<std::string> Paths; // files in the order they are read
+    bool DSVHeader; // drop repeated header rows and end every file with a newline
+    std::size_t BufferSize; // read size for each file
+    std::size_t Next = 0; // index of the next file to open
+    std::unique_ptr<CFileDataSource> Current; // file being drained
+    std::future<std::unique_ptr<CFileDataSource>> Prefetch; // open of file Next, if any
+    std::string Pending; // bytes to hand out before the rest of the current file
+    std::size_t PendingIndex = 0; // next byte of Pending
+    std::string Header; // first row of the first file, without its line ending
+    bool HaveHeader = false; // set once a file with a first row has been read
+    char Last = '\n'; // last byte handed out
+    bool Ended = false; // all files read, or one failed to open
+    bool Failed = false;
+    std::size_t HeaderMismatches = 0;
+
+    SImplementation(std::vector<std::string> paths, bool dsvheader, std::size_t buffersize)
+        : Paths(std::move(paths)), DSVHeader(dsvheader), BufferSize(buffersize) {
+        if (!Paths.empty()) {
+            Prefetch = CFileDataSource::OpenAhead(Paths[0], BufferSize);
+        }
+        Settle();
+    }
+
+    // reads the first row of the file just opened, quoted line breaks included
+    std::string ReadRow() {
+        std::string Row;
+        bool Quoted = false;
+        char Ch;
+        while (Current->Get(Ch)) {
+            Row += Ch;
+            if (Ch == '"') {
+                Quoted = !Quoted;
+            } else if (Ch == '\n' && !Quoted) {
+                break;
+            }
+        }
+        return Row;
+    }
+
+    static std::string_view Trimmed(std::string_view row) {
+        if (!row.empty() && row.back() == '\n') {
+            row.remove_suffix(1);
+        }
+        if (!row.empty() && row.back() == '\r') {
+            row.remove_suffix(1);
+        }
+        return row;
+    }
+
+    bool HasPending() const {
+        return PendingIndex < Pending.size();
+    }
+
+    // moves on to the next file until a byte is available or the files run out
+    void Settle() {
+        while (!Ended && !HasPending() && (!Current || Current->End())) {
+            if (Current && DSVHeader && Last != '\n') {
+                Pending.assign(1, '\n');
+                PendingIndex = 0;
+                return;
+            }
+            Current.reset();
+            if (Next == Paths.size()) {
+                Ended = true;
+                return;
+            }
+            Current = Prefetch.get();
+            Next++;
+            if (Next < Paths.size()) {
+                Prefetch = CFileDataSource::OpenAhead(Paths[Next], BufferSize);
+            }
+            if (!Current->IsOpen()) {
+                Current.reset();
+                Ended = Failed = true;
+                return;
+            }
+            if (DSVHeader) {
+                std::string Row = ReadRow();
+                if (!HaveHeader) {
+                    Header = Trimmed(Row);
+                    HaveHeader = !Row.empty();
+                } else if (Row.empty() || Trimmed(Row) == Header) {
+                    continue;
+                } else {
+                    HeaderMismatches++;
+                }
+                Pending = std::move(Row);
+                PendingIndex = 0;
+            }
+        }
+    }
+
+    bool Get(char &ch) {
+        if (Ended) {
+            return false;
+        }
+        if (HasPending()) {
+            ch = Pending[PendingIndex++];
+        } else {
+            Current->Get(ch);
+        }
+        Last = ch;
+        Settle();
+        return true;
+    }
+
+    bool Peek(char &ch) {
+        if (Ended) {
+            return false;
+        }
+        if (HasPending()) {
+            ch = Pending[PendingIndex];
+            return true;
+        }
+        return Current->Peek(ch);
+    }
+
+    // reads across file boundaries until count bytes are gathered
+    bool Read(std::vector<char> &buf, std::size_t count) {
+        buf.clear();
+        std::vector<char> Block;
+        while (buf.size() < count && !Ended) {
+            std::size_t Wanted = count - buf.size();
+            if (HasPending()) {
+                std::size_t Count = std::min(Wanted, Pending.size() - PendingIndex);
+                buf.insert(buf.end(), Pending.begin() + PendingIndex, Pending.begin() + PendingIndex + Count);
+                PendingIndex += Count;
+            } else if (buf.empty()) {
+                Current->Read(buf, Wanted);
+            } else {
+                Current->Read(Block, Wanted);
+                buf.insert(buf.end(), Block.begin(), Block.end());
+            }
+            if (!buf.empty()) {
+                Last = buf.back();
+            }
+            Settle();
+        }
+        return !buf.empty();
+    }
+};
+
+CMultiFileDataSource::CMultiFileDataSource(std::vector< std::string > paths, bool dsvheader, std::size_t buffersize)
+    : DImplementation(std::make_unique<SImplementation>(std::move(paths), dsvheader, buffersize)){
+
+}
+
+CMultiFileDataSource::~CMultiFileDataSource() = default;
+
+std::size_t CMultiFileDataSource::FileIndex() const noexcept{
+    return DImplementation->Next ? DImplementation->Next - 1 : 0;
+}
+
+bool CMultiFileDataSource::Failed() const noexcept{
+    return DImplementation->Failed;
+}
+
+std::size_t CMultiFileDataSource::HeaderMismatches() const noexcept{
+    return DImplementation->HeaderMismatches;
+}
+
+bool CMultiFileDataSource::End() const noexcept{
+    return DImplementation->Ended;
+}
+
+bool CMultiFileDataSource::Get(char &ch) noexcept{
+    return DImplementation->Get(ch);
+}
+
+bool CMultiFileDataSource::Peek(char &ch) noexcept{
+    return DImplementation->Peek(ch);
+}
+
+bool CMultiFileDataSource::Read(std::vector<char> &buf, std::size_t count) noexcept{
+    return DImplementation->Read(buf, count);
+}
+
+// a directory lists its regular files, anything else is expanded as a glob
+std::vector< std::string > CMultiFileDataSource::Glob(const std::string &pattern){
+    std::vector<std::string> Result;
+    struct stat Status;
+    if(stat(pattern.c_str(), &Status) == 0 && S_ISDIR(Status.st_mode)){
+        if(DIR *Directory = opendir(pattern.c_str())){
+            std::string Prefix = pattern.empty() || pattern.back() == '/' ? pattern : pattern + "/";
+            while(dirent *Entry = readdir(Directory)){
+                std::string Path = Prefix + Entry->d_name;
+                if(IsRegularFile(Path)){
+                    Result.push_back(std::move(Path));
+                }
+            }
+            closedir(Directory);
+        }
+        std::sort(Result.begin(), Result.end());
+        return Result;
+    }
+    glob_t Matches{};
+    if(glob(pattern.c_str(), 0, nullptr, &Matches) == 0){
+        for(std::size_t Index = 0; Index < Matches.gl_pathc; Index++){
+            if(IsRegularFile(Matches.gl_pathv[Index])){
+                Result.push_back(Matches.gl_pathv[Index]);
+            }
+        }
+    }
+    globfree(&Matches);
+    return Result;
+}
@@ -0,0 +1,189 @@
+#include "ParallelFileReader.h"
+#include "DSVReader.h"
+#include "FileDataSource.h"
+#include "XMLReader.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <numeric>
+#include <sys/stat.h>
+
+struct CParallelFileReader::SImplementation {
+    // a file waiting on a worker's queue, Open is set once it is being opened ahead
+    struct SItem {
+        std::size_t File;
+        std::future<std::unique_ptr<CFileDataSource>> Open;
+    };
+
+    // files dealt to one worker, the owner takes from the front, thieves from the back
+    struct SQueue {
+        std::mutex Mutex;
+        std::deque<SItem> Items;
+        std::size_t Bytes = 0; // total size of Items
+    };
+
+    std::vector<std::string> Paths;
+    std::vector<std::size_t> Sizes; // file sizes at construction, zero if missing
+    std::size_t Workers;
+    CThreadPool &Pool;
+    std::size_t BufferSize;
+    std::atomic<std::size_t> Stolen{0};
+    std::mutex FailedMutex; // guards Failed while a run is going
+    std::vector<std::size_t> Failed;
+
+    SImplementation(std::vector<std::string> paths, std::size_t workers, CThreadPool *pool, std::size_t buffersize)
+        : Paths(std::move(paths)), Pool(pool ? *pool : CThreadPool::Shared()), BufferSize(buffersize) {
+        Workers = std::max<std::size_t>(workers ? workers : Pool.ThreadCount(), 1);
+        for (const auto &Path : Paths) {
+            struct stat Status;
+            Sizes.push_back(stat(Path.c_str(), &Status) == 0 ? Status.st_size : 0);
+        }
+    }
+
+    // longest processing time first, each file goes to the worker with the least bytes so far
+    void Deal(std::vector<SQueue> &queues) {
+        std::vector<std::size_t> Order(Paths.size());
+        std::iota(Order.begin(), Order.end(), 0);
+        std::stable_sort(Order.begin(), Order.end(), [this](std::size_t left, std::size_t right) {
+            return Sizes[left] > Sizes[right];
+        });
+        std::vector<std::size_t> Load(queues.size());
+        for (std::size_t File : Order) {
+            std::size_t Worker = std::min_element(Load.begin(), Load.end()) - Load.begin();
+            queues[Worker].Items.push_back({File, {}});
+            queues[Worker].Bytes += Sizes[File];
+            // empty files still count so they spread out
+            Load[Worker] += Sizes[File] + 1;
+        }
+    }
+
+    // next file for a worker, its own first and otherwise the smallest from the busiest queue
+    bool Take(std::vector<SQueue> &queues, std::size_t worker, SItem &item) {
+        {
+            std::lock_guard<std::mutex> Lock(queues[worker].Mutex);
+            auto &Own = queues[worker];
+            if (!Own.Items.empty()) {
+                item = std::move(Own.Items.front());
+                Own.Items.pop_front();
+                Own.Bytes -= Sizes[item.File];
+                return true;
+            }
+        }
+        while (true) {
+            std::size_t Victim = queues.size(), VictimBytes = 0, VictimItems = 0;
+            for (std::size_t Index = 0; Index < queues.size(); Index++) {
+                std::lock_guard<std::mutex> Lock(queues[Index].Mutex);
+                std::size_t Items = queues[Index].Items.size();
+                std::size_t Bytes = queues[Index].Bytes;
+                if (Items && (Victim == queues.size() || Bytes > VictimBytes || (Bytes == VictimBytes && Items > VictimItems))) {
+                    Victim = Index;
+                    VictimBytes = Bytes;
+                    VictimItems = Items;
+                }
+            }
+            if (Victim == queues.size()) {
+                return false;
+            }
+            std::lock_guard<std::mutex> Lock(queues[Victim].Mutex);
+            auto &Queue = queues[Victim];
+            if (!Queue.Items.empty()) {
+                item = std::move(Queue.Items.back());
+                Queue.Items.pop_back();
+                Queue.Bytes -= Sizes[item.File];
+                Stolen++;
+                return true;
+            }
+        }
+    }
+
+    // starts opening the file at the front of a worker's queue
+    void OpenNext(std::vector<SQueue> &queues, std::size_t worker) {
+        std::lock_guard<std::mutex> Lock(queues[worker].Mutex);
+        auto &Own = queues[worker];
+        if (!Own.Items.empty() && !Own.Items.front().Open.valid()) {
+            Own.Items.front().Open = CFileDataSource::OpenAhead(Paths[Own.Items.front().File], BufferSize);
+        }
+    }
+
+    void Work(std::vector<SQueue> &queues, std::size_t worker, const TFileCallback &callback) {
+        SItem Item;
+        while (Take(queues, worker, Item)) {
+            std::shared_ptr<CFileDataSource> Source;
+            if (Item.Open.valid()) {
+                Source = Item.Open.get();
+            } else {
+                Source = std::make_shared<CFileDataSource>(Paths[Item.File], BufferSize);
+            }
+            OpenNext(queues, worker);
+            if (!Source->IsOpen() || !callback(worker, Item.File, Source)) {
+                std::lock_guard<std::mutex> Lock(FailedMutex);
+                Failed.push_back(Item.File);
+            }
+        }
+    }
+
+    bool ForEachFile(const TFileCallback &callback) {
+        Stolen = 0;
+        Failed.clear();
+        std::vector<SQueue> Queues(std::min(Workers, std::max<std::size_t>(Paths.size(), 1)));
+        Deal(Queues);
+        Pool.ParallelFor(Queues.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t Worker = begin; Worker < end; Worker++) {
+                Work(Queues, Worker, callback);
+            }
+        });
+        std::sort(Failed.begin(), Failed.end());
+        return Failed.empty();
+    }
+};
+
+CParallelFileReader::CParallelFileReader(std::vector< std::string > paths, std::size_t workers, CThreadPool *pool, std::size_t buffersize)
+    : DImplementation(std::make_unique<SImplementation>(std::move(paths), workers, pool, buffersize)){
+
+}
+
+CParallelFileReader::~CParallelFileReader() = default;
+
+std::size_t CParallelFileReader::WorkerCount() const noexcept{
+    return DImplementation->Workers;
+}
+
+std::size_t CParallelFileReader::StolenFiles() const noexcept{
+    return DImplementation->Stolen;
+}
+
+std::vector< std::size_t > CParallelFileReader::FailedFiles() const{
+    return DImplementation->Failed;
+}
+
+bool CParallelFileReader::ForEachFile(const TFileCallback &callback){
+    return DImplementation->ForEachFile(callback);
+}
+
+bool CParallelFileReader::ReadDSV(char delimiter, bool skipheader, const TDSVRowCallback &callback){
+    return ForEachFile([&](std::size_t worker, std::size_t file, std::shared_ptr<CDataSource> source){
+        CDSVReader Reader(std::move(source), delimiter);
+        std::vector<std::string> Row;
+        if(skipheader && !Reader.ReadRow(Row)){
+            return true;
+        }
+        while(Reader.ReadRow(Row)){
+            callback(worker, file, Row);
+        }
+        return true;
+    });
+}
+
+// a file that is not well formed XML is marked failed
+bool CParallelFileReader::ReadXML(bool skipcdata, const TXMLEntityCallback &callback){
+    return ForEachFile([&](std::size_t worker, std::size_t file, std::shared_ptr<CDataSource> source){
+        CXMLReader Reader(std::move(source));
+        SXMLEntity Entity;
+        while(Reader.ReadEntity(Entity, skipcdata)){
+            callback(worker, file, Entity);
+        }
+        return Reader.End();
+    });
+}
@@ -0,0 +1,59 @@
+#include "RingDataSink.h"
+#include <algorithm>
+#include <cstring>
+
+CRingDataSink::CRingDataSink(std::shared_ptr< CSPSCRing > ring) : DRing(std::move(ring)), DSpan(nullptr), DSpanLength(0), DClosed(false){
+
+}
+
+CRingDataSink::~CRingDataSink(){
+    Close();
+}
+
+bool CRingDataSink::Put(const char &ch) noexcept{
+    return Write(&ch, 1);
+}
+
+bool CRingDataSink::Write(const std::vector<char> &buf) noexcept{
+    return Write(buf.data(), buf.size());
+}
+
+// copies straight into reserved ring space, the ring publishes in batches
+bool CRingDataSink::Write(const char *data, std::size_t length) noexcept{
+    if(DClosed){
+        return false;
+    }
+    while(length){
+        if(!DSpanLength){
+            DSpanLength = DRing->Reserve(DSpan);
+            if(!DSpanLength){
+                return false;
+            }
+        }
+        std::size_t Count = std::min(length, DSpanLength);
+        std::memcpy(DSpan, data, Count);
+        DRing->Produce(Count);
+        DSpan += Count;
+        DSpanLength -= Count;
+        data += Count;
+        length -= Count;
+    }
+    return true;
+}
+
+// makes everything written so far visible to the reader
+bool CRingDataSink::Flush() noexcept{
+    if(DClosed){
+        return false;
+    }
+    DRing->Flush();
+    return true;
+}
+
+// signals end of stream, the reader sees End() once it drains the ring
+void CRingDataSink::Close() noexcept{
+    if(!DClosed){
+        DClosed = true;
+        DRing->CloseProducer();
+    }
+}
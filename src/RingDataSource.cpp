@@ -0,0 +1,55 @@
+#include "RingDataSource.h"
+#include <algorithm>
+
+CRingDataSource::CRingDataSource(std::shared_ptr< CSPSCRing > ring) : DRing(std::move(ring)), DSpan(nullptr), DSpanLength(0){
+
+}
+
+CRingDataSource::~CRingDataSource(){
+    DRing->CloseConsumer();
+}
+
+// waits for the next readable span, false once the writer has closed and the ring is drained
+bool CRingDataSource::Fill() const noexcept{
+    if(!DSpanLength){
+        DSpanLength = DRing->Acquire(DSpan);
+    }
+    return DSpanLength != 0;
+}
+
+bool CRingDataSource::End() const noexcept{
+    return !Fill();
+}
+
+bool CRingDataSource::Get(char &ch) noexcept{
+    if(!Fill()){
+        return false;
+    }
+    ch = *DSpan++;
+    DSpanLength--;
+    DRing->Consume(1);
+    return true;
+}
+
+bool CRingDataSource::Peek(char &ch) noexcept{
+    if(!Fill()){
+        return false;
+    }
+    ch = *DSpan;
+    return true;
+}
+
+// returns whatever the current span holds, up to count bytes, so a reader
+// refilling its buffer is not held up waiting for a full block
+bool CRingDataSource::Read(std::vector<char> &buf, std::size_t count) noexcept{
+    buf.clear();
+    if(!count || !Fill()){
+        return false;
+    }
+    std::size_t Count = std::min(count, DSpanLength);
+    buf.assign(DSpan, DSpan + Count);
+    DSpan += Count;
+    DSpanLength -= Count;
+    DRing->Consume(Count);
+    return true;
+}
@@ -0,0 +1,220 @@
+#include "SPSCRing.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// keeps each side's hot fields on its own cache line
+const std::size_t CacheLine = 64;
+
+// number of polls before a blocked side goes to sleep
+const int SpinCount = 2048;
+
+// sleeps while word still holds value, spurious wakeups are fine for callers
+void FutexWait(std::atomic<std::uint32_t> &word, std::uint32_t value) noexcept {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAIT_PRIVATE, value, nullptr, nullptr, 0);
+#else
+    if (word.load() == value) {
+        std::this_thread::yield();
+    }
+#endif
+}
+
+void FutexWake(std::atomic<std::uint32_t> &word) noexcept {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+}
+
+// positions are free running counters, the slot is the counter masked by the capacity
+struct CSPSCRing::SImplementation {
+    // one blocked side waits on Epoch after raising Waiting, the other side bumps
+    // Epoch and wakes it only when it sees Waiting set
+    struct alignas(CacheLine) SWaiter {
+        std::atomic<std::uint32_t> Epoch{0};
+        std::atomic<std::uint32_t> Waiting{0};
+    };
+
+    std::vector<char> Data; // the ring storage
+    std::size_t Mask; // capacity minus one
+    std::size_t Batch; // bytes a side advances before publishing
+
+    alignas(CacheLine) std::atomic<std::size_t> Tail{0}; // published by the producer
+    std::atomic<bool> ProducerClosed{false};
+    alignas(CacheLine) std::atomic<std::size_t> Head{0}; // published by the consumer
+    std::atomic<bool> ConsumerClosed{false};
+
+    alignas(CacheLine) std::size_t WritePos = 0; // producer local
+    std::size_t CachedHead = 0; // producer's last view of Head
+    alignas(CacheLine) std::size_t ReadPos = 0; // consumer local
+    std::size_t CachedTail = 0; // consumer's last view of Tail
+
+    SWaiter DataWaiter; // the consumer sleeps here
+    SWaiter SpaceWaiter; // the producer sleeps here
+
+    SImplementation(std::size_t capacity, std::size_t batch) {
+        std::size_t Size = 64;
+        while (Size < capacity) {
+            Size <<= 1;
+        }
+        Data.resize(Size);
+        Mask = Size - 1;
+        Batch = batch ? std::min(batch, Size / 2) : Size / 8;
+    }
+
+    // wakes the other side if it announced that it is going to sleep
+    static void Signal(SWaiter &waiter) noexcept {
+        if (waiter.Waiting.load()) {
+            waiter.Epoch.fetch_add(1);
+            FutexWake(waiter.Epoch);
+        }
+    }
+
+    // spins and then sleeps until ready() holds, ready must read the state with
+    // sequentially consistent loads so it pairs with Signal
+    template <typename TReady>
+    static void Block(SWaiter &waiter, TReady ready) noexcept {
+        for (int Spin = 0; Spin < SpinCount; Spin++) {
+            if (ready()) {
+                return;
+            }
+        }
+        while (!ready()) {
+            waiter.Waiting.store(1);
+            std::uint32_t Epoch = waiter.Epoch.load();
+            if (!ready()) {
+                FutexWait(waiter.Epoch, Epoch);
+            }
+            waiter.Waiting.store(0);
+        }
+    }
+
+    void PublishTail() noexcept {
+        if (Tail.load(std::memory_order_relaxed) != WritePos) {
+            Tail.store(WritePos);
+            Signal(DataWaiter);
+        }
+    }
+
+    void PublishHead() noexcept {
+        if (Head.load(std::memory_order_relaxed) != ReadPos) {
+            Head.store(ReadPos);
+            Signal(SpaceWaiter);
+        }
+    }
+
+    std::size_t Reserve(char *&ptr) noexcept {
+        if (WritePos - CachedHead > Mask) {
+            CachedHead = Head.load(std::memory_order_acquire);
+            if (WritePos - CachedHead > Mask) {
+                PublishTail(); // make sure the consumer can drain what we already wrote
+                Block(SpaceWaiter, [this] { return WritePos - Head.load() <= Mask || ConsumerClosed.load(); });
+                CachedHead = Head.load(std::memory_order_acquire);
+                if (WritePos - CachedHead > Mask) {
+                    return 0;
+                }
+            }
+        }
+        if (ConsumerClosed.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+        std::size_t Offset = WritePos & Mask;
+        ptr = Data.data() + Offset;
+        return std::min(Data.size() - (WritePos - CachedHead), Data.size() - Offset);
+    }
+
+    void Produce(std::size_t count) noexcept {
+        WritePos += count;
+        if (WritePos - Tail.load(std::memory_order_relaxed) >= Batch) {
+            PublishTail();
+        }
+    }
+
+    std::size_t Acquire(const char *&ptr) noexcept {
+        if (ReadPos == CachedTail) {
+            CachedTail = Tail.load(std::memory_order_acquire);
+            if (ReadPos == CachedTail) {
+                PublishHead(); // hand back space before we wait on more data
+                Block(DataWaiter, [this] { return ReadPos != Tail.load() || ProducerClosed.load(); });
+                CachedTail = Tail.load(std::memory_order_acquire);
+                if (ReadPos == CachedTail) {
+                    return 0;
+                }
+            }
+        }
+        std::size_t Offset = ReadPos & Mask;
+        ptr = Data.data() + Offset;
+        return std::min(CachedTail - ReadPos, Data.size() - Offset);
+    }
+
+    void Consume(std::size_t count) noexcept {
+        ReadPos += count;
+        if (ReadPos - Head.load(std::memory_order_relaxed) >= Batch) {
+            PublishHead();
+        }
+    }
+};
+
+// creates a ring of at least capacity bytes, rounded up to a power of two, that
+// publishes after every batch bytes, zero picks an eighth of the ring
+CSPSCRing::CSPSCRing(std::size_t capacity, std::size_t batch)
+    : DImplementation(std::make_unique<SImplementation>(capacity, batch)) {}
+
+CSPSCRing::~CSPSCRing() = default;
+
+std::size_t CSPSCRing::Capacity() const noexcept {
+    return DImplementation->Data.size();
+}
+
+// returns a writable span, blocking while the ring is full, zero once the consumer has closed
+std::size_t CSPSCRing::Reserve(char *&ptr) noexcept {
+    return DImplementation->Reserve(ptr);
+}
+
+// marks count bytes of the reserved span as written
+void CSPSCRing::Produce(std::size_t count) noexcept {
+    DImplementation->Produce(count);
+}
+
+// publishes everything produced so far to the consumer
+void CSPSCRing::Flush() noexcept {
+    DImplementation->PublishTail();
+}
+
+// publishes the remaining bytes and signals end of stream
+void CSPSCRing::CloseProducer() noexcept {
+    DImplementation->PublishTail();
+    DImplementation->ProducerClosed.store(true);
+    DImplementation->DataWaiter.Epoch.fetch_add(1);
+    FutexWake(DImplementation->DataWaiter.Epoch);
+}
+
+// returns a readable span, blocking while the ring is empty, zero at end of stream
+std::size_t CSPSCRing::Acquire(const char *&ptr) noexcept {
+    return DImplementation->Acquire(ptr);
+}
+
+// marks count bytes of the acquired span as read
+void CSPSCRing::Consume(std::size_t count) noexcept {
+    DImplementation->Consume(count);
+}
+
+// tells the producer nobody will read any more so it stops blocking
+void CSPSCRing::CloseConsumer() noexcept {
+    DImplementation->ConsumerClosed.store(true);
+    DImplementation->SpaceWaiter.Epoch.fetch_add(1);
+    FutexWake(DImplementation->SpaceWaiter.Epoch);
+}
@@ -0,0 +1,86 @@
+#include "SegmentedDataSink.h"
+#include <algorithm>
+
+CSegmentedDataSink::CSegmentedDataSink(std::size_t chunksize, std::shared_ptr<CMemoryAccount> account)
+    : DChunkSize(std::max<std::size_t>(chunksize, 1)), DSize(0), DAccount(std::move(account)){
+
+}
+
+CSegmentedDataSink::~CSegmentedDataSink(){
+    if(DAccount){
+        DAccount->Credit(DCharged);
+    }
+}
+
+// the chunk being filled, starting a new one once the last is full, null when
+// the account refuses a new chunk
+std::string *CSegmentedDataSink::Tail(){
+    if(DChunks.empty() || DChunks.back()->size() == DChunkSize){
+        if(DAccount && !DAccount->Resize(DCharged, DCharged + DChunkSize)){
+            return nullptr;
+        }
+        DChunks.push_back(std::make_shared<std::string>());
+        DChunks.back()->reserve(DChunkSize);
+    }
+    return DChunks.back().get();
+}
+
+std::size_t CSegmentedDataSink::Size() const noexcept{
+    return DSize;
+}
+
+std::size_t CSegmentedDataSink::ChunkCount() const noexcept{
+    return DChunks.size();
+}
+
+// copies everything written into one string
+std::string CSegmentedDataSink::String() const{
+    std::string Result;
+    Result.reserve(DSize);
+    for(auto &Chunk : DChunks){
+        Result += *Chunk;
+    }
+    return Result;
+}
+
+// passes ownership of the chunks on without copying and leaves the sink
+// empty, the chunks stop counting against the account
+std::vector< CSegmentedDataSink::TChunk > CSegmentedDataSink::TakeChunks(){
+    std::vector< TChunk > Result(DChunks.begin(), DChunks.end());
+    DChunks.clear();
+    DSize = 0;
+    if(DAccount){
+        DAccount->Resize(DCharged, 0);
+    }
+    return Result;
+}
+
+bool CSegmentedDataSink::Put(const char &ch) noexcept{
+    std::string *Chunk = Tail();
+    if(!Chunk){
+        return false;
+    }
+    *Chunk += ch;
+    DSize++;
+    return true;
+}
+
+bool CSegmentedDataSink::Write(const std::vector<char> &buf) noexcept{
+    return Write(buf.data(), buf.size());
+}
+
+// fills the current chunk and continues into new ones
+bool CSegmentedDataSink::Write(const char *data, std::size_t length) noexcept{
+    while(length){
+        std::string *Chunk = Tail();
+        if(!Chunk){
+            return false;
+        }
+        std::size_t Count = std::min(length, DChunkSize - Chunk->size());
+        Chunk->append(data, Count);
+        DSize += Count;
+        data += Count;
+        length -= Count;
+    }
+    return true;
+}
@@ -0,0 +1,76 @@
+#include "SegmentedDataSource.h"
+#include <algorithm>
+
+// empty and null chunks are dropped so the current chunk always has a byte left until the end
+CSegmentedDataSource::CSegmentedDataSource(std::vector< TChunk > chunks) : DSize(0), DChunk(0), DIndex(0){
+    for(auto &Chunk : chunks){
+        if(Chunk && !Chunk->empty()){
+            DStarts.push_back(DSize);
+            DSize += Chunk->size();
+            DChunks.push_back(std::move(Chunk));
+        }
+    }
+}
+
+// moves to the next chunk once the current one is used up
+void CSegmentedDataSource::Settle() noexcept{
+    if(DChunk < DChunks.size() && DIndex == DChunks[DChunk]->size()){
+        DChunk++;
+        DIndex = 0;
+    }
+}
+
+bool CSegmentedDataSource::End() const noexcept{
+    return DChunk >= DChunks.size();
+}
+
+bool CSegmentedDataSource::Get(char &ch) noexcept{
+    if(End()){
+        return false;
+    }
+    ch = (*DChunks[DChunk])[DIndex++];
+    Settle();
+    return true;
+}
+
+bool CSegmentedDataSource::Peek(char &ch) noexcept{
+    if(End()){
+        return false;
+    }
+    ch = (*DChunks[DChunk])[DIndex];
+    return true;
+}
+
+bool CSegmentedDataSource::Read(std::vector<char> &buf, std::size_t count) noexcept{
+    buf.clear();
+    while(buf.size() < count && !End()){
+        const std::string &Chunk = *DChunks[DChunk];
+        std::size_t Count = std::min(count - buf.size(), Chunk.size() - DIndex);
+        buf.insert(buf.end(), Chunk.data() + DIndex, Chunk.data() + DIndex + Count);
+        DIndex += Count;
+        Settle();
+    }
+    return !buf.empty();
+}
+
+bool CSegmentedDataSource::Seek(std::size_t offset) noexcept{
+    if(offset > DSize){
+        return false;
+    }
+    DIndex = 0;
+    if(offset == DSize){
+        DChunk = DChunks.size();
+        return true;
+    }
+    DChunk = std::upper_bound(DStarts.begin(), DStarts.end(), offset) - DStarts.begin() - 1;
+    DIndex = offset - DStarts[DChunk];
+    return true;
+}
+
+std::size_t CSegmentedDataSource::Tell() const noexcept{
+    return End() ? DSize : DStarts[DChunk] + DIndex;
+}
+
+std::size_t CSegmentedDataSource::Size() const noexcept{
+    return DSize;
+}
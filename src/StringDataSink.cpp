@@ -1,15 +1,45 @@
 #include "StringDataSink.h"
+#include <algorithm>
+
+CStringDataSink::CStringDataSink(std::shared_ptr<CMemoryAccount> account) : DAccount(std::move(account)){
+
+}
+
+CStringDataSink::~CStringDataSink(){
+    if(DAccount){
+        DAccount->Credit(DCharged);
+    }
+}
+
+// grows the string the way appending would, charging the account first
+bool CStringDataSink::Reserve(std::size_t length) noexcept{
+    if(!DAccount || DString.size() + length <= DString.capacity()){
+        return true;
+    }
+    std::size_t Capacity = std::max(DString.capacity() * 2, DString.size() + length);
+    if(!DAccount->Resize(DCharged, Capacity)){
+        return false;
+    }
+    DString.reserve(Capacity);
+    return true;
+}
 
 const std::string &CStringDataSink::String() const{
     return DString;
 }
 
 bool CStringDataSink::Put(const char &ch) noexcept{
-    DString += std::string(1,ch);
+    if(!Reserve(1)){
+        return false;
+    }
+    DString += ch;
     return true;
 }
 
 bool CStringDataSink::Write(const std::vector<char> &buf) noexcept{
-    DString += std::string(buf.data(),buf.size());
+    if(!Reserve(buf.size())){
+        return false;
+    }
+    DString.append(buf.data(), buf.size());
     return true;
 }
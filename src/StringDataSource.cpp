@@ -1,6 +1,28 @@
 #include "StringDataSource.h"
+#include <algorithm>
 
-CStringDataSource::CStringDataSource(const std::string &str) : DString(str), DIndex(0){
+CStringDataSource::CStringDataSource(const std::string &str) : CStringDataSource(std::make_shared<const std::string>(str)){
+
+}
+
+// takes over the string's buffer without copying it
+CStringDataSource::CStringDataSource(std::string &&str) : CStringDataSource(std::make_shared<const std::string>(std::move(str))){
+
+}
+
+CStringDataSource::CStringDataSource(const char *str) : CStringDataSource(std::make_shared<const std::string>(str)){
+
+}
+
+// shares an immutable buffer with its other owners
+CStringDataSource::CStringDataSource(std::shared_ptr< const std::string > str) : DOwner(std::move(str)), DIndex(0){
+    if(DOwner){
+        DString = *DOwner;
+    }
+}
+
+// borrows the viewed bytes, which must outlive the source
+CStringDataSource::CStringDataSource(std::string_view str) : DString(str), DIndex(0){
 
 }
 
@@ -26,15 +48,24 @@ bool CStringDataSource::Peek(char &ch) noexcept{
 }
 
 bool CStringDataSource::Read(std::vector<char> &buf, std::size_t count) noexcept{
-    buf.clear();
-    while(buf.size() < count){
-        char TempChar;
-        if(Get(TempChar)){
-            buf.push_back(TempChar);
-        }
-        else{
-            break;
-        }
-    }
+    std::size_t Count = std::min(count, DString.length() - DIndex);
+    buf.assign(DString.data() + DIndex, DString.data() + DIndex + Count);
+    DIndex += Count;
     return !buf.empty();
 }
+
+bool CStringDataSource::Seek(std::size_t offset) noexcept{
+    if(offset > DString.length()){
+        return false;
+    }
+    DIndex = offset;
+    return true;
+}
+
+std::size_t CStringDataSource::Tell() const noexcept{
+    return DIndex;
+}
+
+std::size_t CStringDataSource::Size() const noexcept{
+    return DString.length();
+}
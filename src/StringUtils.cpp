@@ -1,6 +1,9 @@
 #include "StringUtils.h"
+#include "ThreadPool.h"
 #include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <string_view>
 #include <vector>
 
 namespace StringUtils{
@@ -234,4 +237,246 @@ int EditDistance(const std::string &left, const std::string &right, bool ignorec
     return distance[strLeft.length()][strRight.length()]; // returns the distance between the strings
 }
 
+namespace{
+
+// number of fields handed to each pool task in the column transforms
+const std::size_t ColumnGrain = 2048;
+
+// runs a column transform in two passes, the first sizes every output field so
+// the arena is allocated exactly once, the second writes each field in place
+template <typename TField, typename TSize, typename TWrite>
+SStringColumn TransformColumn(std::size_t count, TField field, TSize size, TWrite write) noexcept{
+    SStringColumn Result;
+    Result.DOffsets.assign(count + 1, 0);
+    CThreadPool &Pool = CThreadPool::Shared();
+    Pool.ParallelFor(count, ColumnGrain, [&](std::size_t begin, std::size_t end){
+        for (std::size_t i = begin; i < end; i++) {
+            Result.DOffsets[i + 1] = size(field(i)); // each task only touches its own slots
+        }
+    });
+    for (std::size_t i = 1; i <= count; i++) {
+        Result.DOffsets[i] += Result.DOffsets[i - 1]; // turn sizes into offsets
+    }
+    Result.DData.resize(Result.DOffsets[count]);
+    Pool.ParallelFor(count, ColumnGrain, [&](std::size_t begin, std::size_t end){
+        for (std::size_t i = begin; i < end; i++) {
+            write(field(i), Result.DData.data() + Result.DOffsets[i]);
+        }
+    });
+    return Result;
+}
+
+// trims whitespace off the requested ends without copying
+std::string_view StripView(std::string_view str, bool left, bool right) noexcept{
+    std::size_t start = 0;
+    std::size_t end = str.size();
+    while (left && start < end && std::isspace(static_cast<unsigned char>(str[start]))) {
+        start++;
+    }
+    while (right && end > start && std::isspace(static_cast<unsigned char>(str[end - 1]))) {
+        end--;
+    }
+    return str.substr(start, end - start);
+}
+
+template <typename TField>
+SStringColumn CaseColumn(std::size_t count, TField field, int (*convert)(int)) noexcept{
+    return TransformColumn(count, field,
+        [](std::string_view str){ return str.size(); },
+        [convert](std::string_view str, char *out){
+            for (char c : str) {
+                *out++ = convert(static_cast<unsigned char>(c));
+            }
+        });
+}
+
+template <typename TField>
+SStringColumn StripColumn(std::size_t count, TField field, bool left, bool right) noexcept{
+    return TransformColumn(count, field,
+        [left, right](std::string_view str){ return StripView(str, left, right).size(); },
+        [left, right](std::string_view str, char *out){
+            std::string_view stripped = StripView(str, left, right);
+            std::memcpy(out, stripped.data(), stripped.size());
+        });
+}
+
+// pads each field out to width, the fill is split by the caller supplied left share
+template <typename TField, typename TLeft>
+SStringColumn JustifyColumn(std::size_t count, TField field, int width, char fill, TLeft leftpad) noexcept{
+    std::size_t target = width > 0 ? width : 0;
+    return TransformColumn(count, field,
+        [target](std::string_view str){ return std::max(str.size(), target); },
+        [target, fill, leftpad](std::string_view str, char *out){
+            std::size_t padding = str.size() < target ? target - str.size() : 0;
+            std::size_t left = leftpad(padding);
+            std::memset(out, fill, left);
+            std::memcpy(out + left, str.data(), str.size());
+            std::memset(out + left + str.size(), fill, padding - left);
+        });
+}
+
+template <typename TField>
+SStringColumn ReplaceColumn(std::size_t count, TField field, const std::string &old, const std::string &rep) noexcept{
+    return TransformColumn(count, field,
+        [&old, &rep](std::string_view str){
+            if (old.empty()) {
+                return str.size();
+            }
+            std::size_t matches = 0;
+            std::size_t position = 0;
+            while ((position = str.find(old, position)) != std::string_view::npos) {
+                matches++;
+                position += old.size(); // matches never overlap, same as the scalar version
+            }
+            return str.size() - matches * old.size() + matches * rep.size();
+        },
+        [&old, &rep](std::string_view str, char *out){
+            std::size_t position = 0;
+            std::size_t found;
+            while (!old.empty() && (found = str.find(old, position)) != std::string_view::npos) {
+                std::memcpy(out, str.data() + position, found - position);
+                out += found - position;
+                std::memcpy(out, rep.data(), rep.size());
+                out += rep.size();
+                position = found + old.size();
+            }
+            std::memcpy(out, str.data() + position, str.size() - position);
+        });
+}
+
+// walks a field the way ExpandTabs does, calling emit(ch, repeat) for each run
+template <typename TEmit>
+void ExpandTabsWalk(std::string_view str, int tabsize, TEmit emit) noexcept{
+    std::size_t currentColumn = 0;
+    for (char c : str) {
+        if (c == '\t') {
+            std::size_t spaces = tabsize > 0 ? tabsize - (currentColumn % tabsize) : 0;
+            emit(' ', spaces);
+            currentColumn += spaces;
+        } else {
+            emit(c, 1);
+            currentColumn++;
+        }
+    }
+}
+
+template <typename TField>
+SStringColumn ExpandTabsColumn(std::size_t count, TField field, int tabsize) noexcept{
+    return TransformColumn(count, field,
+        [tabsize](std::string_view str){
+            std::size_t length = 0;
+            ExpandTabsWalk(str, tabsize, [&length](char, std::size_t repeat){ length += repeat; });
+            return length;
+        },
+        [tabsize](std::string_view str, char *out){
+            ExpandTabsWalk(str, tabsize, [&out](char ch, std::size_t repeat){
+                std::memset(out, ch, repeat);
+                out += repeat;
+            });
+        });
+}
+
+// field accessors so both column layouts share the same transforms
+auto ColumnField(const SStringColumn &col){
+    return [&col](std::size_t index){ return col.Field(index); };
+}
+
+auto ColumnField(const std::vector< std::string > &col){
+    return [&col](std::size_t index){ return std::string_view(col[index]); };
+}
+
+std::size_t CenterLeft(std::size_t padding){
+    return padding / 2;
+}
+
+std::size_t LJustLeft(std::size_t){
+    return 0;
+}
+
+std::size_t RJustLeft(std::size_t padding){
+    return padding;
+}
+
+}
+
+SStringColumn Upper(const SStringColumn &col) noexcept{
+    return CaseColumn(col.Size(), ColumnField(col), ::toupper);
+}
+
+SStringColumn Lower(const SStringColumn &col) noexcept{
+    return CaseColumn(col.Size(), ColumnField(col), ::tolower);
+}
+
+SStringColumn LStrip(const SStringColumn &col) noexcept{
+    return StripColumn(col.Size(), ColumnField(col), true, false);
+}
+
+SStringColumn RStrip(const SStringColumn &col) noexcept{
+    return StripColumn(col.Size(), ColumnField(col), false, true);
+}
+
+SStringColumn Strip(const SStringColumn &col) noexcept{
+    return StripColumn(col.Size(), ColumnField(col), true, true);
+}
+
+SStringColumn Center(const SStringColumn &col, int width, char fill) noexcept{
+    return JustifyColumn(col.Size(), ColumnField(col), width, fill, CenterLeft);
+}
+
+SStringColumn LJust(const SStringColumn &col, int width, char fill) noexcept{
+    return JustifyColumn(col.Size(), ColumnField(col), width, fill, LJustLeft);
+}
+
+SStringColumn RJust(const SStringColumn &col, int width, char fill) noexcept{
+    return JustifyColumn(col.Size(), ColumnField(col), width, fill, RJustLeft);
+}
+
+SStringColumn Replace(const SStringColumn &col, const std::string &old, const std::string &rep) noexcept{
+    return ReplaceColumn(col.Size(), ColumnField(col), old, rep);
+}
+
+SStringColumn ExpandTabs(const SStringColumn &col, int tabsize) noexcept{
+    return ExpandTabsColumn(col.Size(), ColumnField(col), tabsize);
+}
+
+SStringColumn Upper(const std::vector< std::string > &col) noexcept{
+    return CaseColumn(col.size(), ColumnField(col), ::toupper);
+}
+
+SStringColumn Lower(const std::vector< std::string > &col) noexcept{
+    return CaseColumn(col.size(), ColumnField(col), ::tolower);
+}
+
+SStringColumn LStrip(const std::vector< std::string > &col) noexcept{
+    return StripColumn(col.size(), ColumnField(col), true, false);
+}
+
+SStringColumn RStrip(const std::vector< std::string > &col) noexcept{
+    return StripColumn(col.size(), ColumnField(col), false, true);
+}
+
+SStringColumn Strip(const std::vector< std::string > &col) noexcept{
+    return StripColumn(col.size(), ColumnField(col), true, true);
+}
+
+SStringColumn Center(const std::vector< std::string > &col, int width, char fill) noexcept{
+    return JustifyColumn(col.size(), ColumnField(col), width, fill, CenterLeft);
+}
+
+SStringColumn LJust(const std::vector< std::string > &col, int width, char fill) noexcept{
+    return JustifyColumn(col.size(), ColumnField(col), width, fill, LJustLeft);
+}
+
+SStringColumn RJust(const std::vector< std::string > &col, int width, char fill) noexcept{
+    return JustifyColumn(col.size(), ColumnField(col), width, fill, RJustLeft);
+}
+
+SStringColumn Replace(const std::vector< std::string > &col, const std::string &old, const std::string &rep) noexcept{
+    return ReplaceColumn(col.size(), ColumnField(col), old, rep);
+}
+
+SStringColumn ExpandTabs(const std::vector< std::string > &col, int tabsize) noexcept{
+    return ExpandTabsColumn(col.size(), ColumnField(col), tabsize);
+}
+
 };
\ No newline at end of file
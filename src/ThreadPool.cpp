@@ -0,0 +1,155 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// fixed set of worker threads pulling tasks off a shared queue
+struct CThreadPool::SImplementation {
+    std::vector<std::thread> Workers; // the worker threads
+    std::queue<std::function<void()>> Tasks; // tasks waiting for a worker
+    std::mutex Mutex; // guards the task queue and counters
+    std::condition_variable TaskReady; // signaled when a task is queued or we are stopping
+    std::condition_variable AllDone; // signaled when the last pending task finishes
+    std::size_t Pending = 0; // tasks queued or running
+    bool Stopping = false; // set by the destructor to release the workers
+
+    SImplementation(std::size_t threads) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (std::size_t i = 0; i < threads; i++) {
+            Workers.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    ~SImplementation() {
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            Stopping = true;
+        }
+        TaskReady.notify_all();
+        for (auto &Worker : Workers) {
+            Worker.join();
+        }
+    }
+
+    // runs tasks until the pool is stopped and the queue is drained
+    void WorkerLoop() {
+        while (true) {
+            std::function<void()> Task;
+            {
+                std::unique_lock<std::mutex> Lock(Mutex);
+                TaskReady.wait(Lock, [this] { return Stopping || !Tasks.empty(); });
+                if (Tasks.empty()) {
+                    return;
+                }
+                Task = std::move(Tasks.front());
+                Tasks.pop();
+            }
+            Task();
+            std::lock_guard<std::mutex> Lock(Mutex);
+            if (--Pending == 0) {
+                AllDone.notify_all();
+            }
+        }
+    }
+
+    void Submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            Tasks.push(std::move(task));
+            Pending++;
+        }
+        TaskReady.notify_one();
+    }
+
+    void Wait() {
+        std::unique_lock<std::mutex> Lock(Mutex);
+        AllDone.wait(Lock, [this] { return Pending == 0; });
+    }
+};
+
+// shared bookkeeping for one ParallelFor call, kept alive by any helper still queued
+struct SParallelForState {
+    std::atomic<std::size_t> Next{0}; // next chunk to claim
+    std::atomic<std::size_t> Done{0}; // chunks finished
+    std::size_t Chunks; // total number of chunks
+    std::size_t Count; // total number of items
+    std::size_t Grain; // items per chunk
+    const std::function<void(std::size_t, std::size_t)> *Func; // only touched while chunks remain
+    std::mutex Mutex;
+    std::condition_variable Finished;
+
+    // claims and runs chunks until none are left
+    void Run() {
+        std::size_t Chunk;
+        while ((Chunk = Next.fetch_add(1)) < Chunks) {
+            std::size_t Begin = Chunk * Grain;
+            (*Func)(Begin, std::min(Begin + Grain, Count));
+            if (Done.fetch_add(1) + 1 == Chunks) {
+                std::lock_guard<std::mutex> Lock(Mutex);
+                Finished.notify_all();
+            }
+        }
+    }
+};
+
+// creates a pool with the given number of workers, zero means one per hardware thread
+CThreadPool::CThreadPool(std::size_t threads)
+    : DImplementation(std::make_unique<SImplementation>(threads)) {}
+
+// joins all workers after the remaining tasks are run
+CThreadPool::~CThreadPool() = default;
+
+// returns the number of worker threads
+std::size_t CThreadPool::ThreadCount() const noexcept {
+    return DImplementation->Workers.size();
+}
+
+// queues a task to be run on one of the workers
+void CThreadPool::Submit(std::function<void()> task) {
+    DImplementation->Submit(std::move(task));
+}
+
+// blocks until every submitted task has finished
+void CThreadPool::Wait() {
+    DImplementation->Wait();
+}
+
+// splits [0, count) into chunks of grain items and runs func(begin, end) on each,
+// the calling thread claims chunks too so nested calls from a worker cannot deadlock
+void CThreadPool::ParallelFor(std::size_t count, std::size_t grain, const std::function<void(std::size_t, std::size_t)> &func) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<std::size_t>(grain, 1);
+    std::size_t Chunks = (count + grain - 1) / grain;
+    if (Chunks == 1 || ThreadCount() == 1) {
+        func(0, count);
+        return;
+    }
+    auto State = std::make_shared<SParallelForState>();
+    State->Chunks = Chunks;
+    State->Count = count;
+    State->Grain = grain;
+    State->Func = &func;
+
+    std::size_t Helpers = std::min(Chunks - 1, ThreadCount());
+    for (std::size_t i = 0; i < Helpers; i++) {
+        Submit([State] { State->Run(); });
+    }
+    State->Run();
+
+    std::unique_lock<std::mutex> Lock(State->Mutex);
+    State->Finished.wait(Lock, [&State] { return State->Done.load() == State->Chunks; });
+}
+
+// process wide pool sized to the hardware, created on first use
+CThreadPool &CThreadPool::Shared() {
+    static CThreadPool Pool;
+    return Pool;
+}
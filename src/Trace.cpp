@@ -0,0 +1,137 @@
+#include "Trace.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+// events kept per thread, later events are dropped once a buffer is full
+const std::size_t BufferEvents = 1 << 18;
+
+struct SEvent {
+    const char *Name;
+    std::uint64_t Begin;
+    std::uint64_t End;
+};
+
+// written only by its thread, Count is published with release so a dump on
+// another thread sees complete events
+struct SThreadBuffer {
+    std::vector<SEvent> Events = std::vector<SEvent>(BufferEvents);
+    std::atomic<std::size_t> Count{0};
+    std::atomic<std::size_t> Dropped{0};
+    std::uint64_t ThreadId;
+};
+
+// every thread buffer ever created, kept after the thread exits so its spans can be written
+struct SBuffers {
+    std::mutex Mutex;
+    std::vector<std::shared_ptr<SThreadBuffer>> Buffers;
+};
+
+SBuffers &Buffers() {
+    static SBuffers Instance;
+    return Instance;
+}
+
+#ifdef ENABLE_TRACE
+// the calling thread's buffer, registered on first use
+SThreadBuffer &LocalBuffer() {
+    thread_local std::shared_ptr<SThreadBuffer> Local;
+    if (!Local) {
+        Local = std::make_shared<SThreadBuffer>();
+        std::lock_guard<std::mutex> Lock(Buffers().Mutex);
+        Local->ThreadId = Buffers().Buffers.size() + 1;
+        Buffers().Buffers.push_back(Local);
+    }
+    return *Local;
+}
+#endif
+
+// escapes a span name for a JSON string
+std::string JSONEscape(const char *name) {
+    std::string Result;
+    for (const char *Ch = name; *Ch; Ch++) {
+        if (*Ch == '"' || *Ch == '\\') {
+            Result += '\\';
+        }
+        Result += *Ch;
+    }
+    return Result;
+}
+
+}
+
+#ifdef ENABLE_TRACE
+
+// nanoseconds on the steady clock
+std::uint64_t CTrace::Now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// appends a completed span to the calling thread's buffer without locking
+void CTrace::Record(const char *name, std::uint64_t begin, std::uint64_t end) noexcept {
+    SThreadBuffer &Buffer = LocalBuffer();
+    std::size_t Index = Buffer.Count.load(std::memory_order_relaxed);
+    if (Index >= Buffer.Events.size()) {
+        Buffer.Dropped.store(Buffer.Dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    Buffer.Events[Index] = {name, begin, end};
+    Buffer.Count.store(Index + 1, std::memory_order_release);
+}
+
+#endif
+
+// writes every recorded span as Chrome trace event JSON, which loads in
+// chrome://tracing and Perfetto, timestamps are microseconds
+bool CTrace::WriteChromeTrace(std::shared_ptr<CDataSink> sink) {
+    if (!sink) {
+        return false;
+    }
+    std::string Out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool First = true;
+    std::string Pid = std::to_string(getpid());
+    std::lock_guard<std::mutex> Lock(Buffers().Mutex);
+    for (auto &Buffer : Buffers().Buffers) {
+        std::size_t Count = Buffer->Count.load(std::memory_order_acquire);
+        std::string Tid = std::to_string(Buffer->ThreadId);
+        for (std::size_t Index = 0; Index < Count; Index++) {
+            const SEvent &Event = Buffer->Events[Index];
+            Out += First ? "\n" : ",\n";
+            First = false;
+            Out += "{\"name\":\"" + JSONEscape(Event.Name) + "\",\"ph\":\"X\",\"pid\":" + Pid + ",\"tid\":" + Tid;
+            Out += ",\"ts\":" + std::to_string(Event.Begin / 1000) + "." + std::to_string(Event.Begin % 1000 + 1000).substr(1);
+            Out += ",\"dur\":" + std::to_string((Event.End - Event.Begin) / 1000) + "." + std::to_string((Event.End - Event.Begin) % 1000 + 1000).substr(1) + "}";
+        }
+        if (Buffer->Dropped.load(std::memory_order_relaxed)) {
+            Out += First ? "\n" : ",\n";
+            First = false;
+            Out += "{\"name\":\"dropped\",\"ph\":\"C\",\"pid\":" + Pid + ",\"tid\":" + Tid + ",\"ts\":0,\"args\":{\"events\":" + std::to_string(Buffer->Dropped.load()) + "}}";
+        }
+    }
+    Out += "\n]}\n";
+    return sink->Write(std::vector<char>(Out.begin(), Out.end()));
+}
+
+// forgets recorded spans, only safe while no other thread is recording
+void CTrace::Clear() {
+    std::lock_guard<std::mutex> Lock(Buffers().Mutex);
+    for (auto &Buffer : Buffers().Buffers) {
+        Buffer->Count.store(0);
+        Buffer->Dropped.store(0);
+    }
+}
+
+// number of spans recorded across all threads
+std::size_t CTrace::EventCount() {
+    std::lock_guard<std::mutex> Lock(Buffers().Mutex);
+    std::size_t Count = 0;
+    for (auto &Buffer : Buffers().Buffers) {
+        Count += Buffer->Count.load(std::memory_order_acquire);
+    }
+    return Count;
+}
@@ -0,0 +1,243 @@
+#include "XMLBinaryReader.h"
+#include "XMLBinaryFormat.h"
+#include "Varint.h"
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct CXMLBinaryReader::SImplementation {
+    struct SBlock {
+        std::size_t Offset;
+        std::size_t Entities;
+    };
+
+    const char *Data = nullptr; // start of the stream
+    std::size_t Size = 0; // bytes in the stream
+    void *Mapping = nullptr; // set when Data is a mapped file
+    std::shared_ptr<const std::string> Owned; // set when Data is an in-memory string
+    std::vector<SBlock> Blocks; // block table from the footer
+    std::size_t BlockEnd = 0; // offset where the block table starts
+    bool Valid = false; // the header, trailer and block table are intact
+
+    std::size_t Block = 0; // index of the next block to decode
+    std::size_t LastBlock = 0; // one past the last block to replay
+    const char *Ptr = nullptr; // next byte in the current block
+    const char *Stop = nullptr; // end of the current block
+    std::size_t Remaining = 0; // entities left in the current block
+    std::vector<std::string_view> Dictionary; // names and keys of the current block
+    bool Failed = false; // a block was corrupt
+
+    ~SImplementation() {
+        if (Mapping) {
+            munmap(Mapping, Size);
+        }
+    }
+
+    bool Map(const std::string &path) {
+        int Handle = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (Handle < 0) return false;
+        struct stat Status;
+        if (fstat(Handle, &Status) == 0 && Status.st_size > 0) {
+            void *Address = mmap(nullptr, Status.st_size, PROT_READ, MAP_PRIVATE, Handle, 0);
+            if (Address != MAP_FAILED) {
+                madvise(Address, Status.st_size, MADV_SEQUENTIAL);
+                Mapping = Address;
+                Data = static_cast<const char *>(Address);
+                Size = Status.st_size;
+            }
+        }
+        close(Handle);
+        return Mapping != nullptr;
+    }
+
+    // checks the header and trailer and loads the block table
+    bool Open() {
+        if (Size < XMLBinary::HeaderSize + XMLBinary::TrailerSize ||
+            std::memcmp(Data, XMLBinary::Magic, sizeof(XMLBinary::Magic)) != 0 ||
+            Data[sizeof(XMLBinary::Magic)] != XMLBinary::Version ||
+            std::memcmp(Data + Size - sizeof(XMLBinary::Magic), XMLBinary::Magic, sizeof(XMLBinary::Magic)) != 0) {
+            return false;
+        }
+        std::uint64_t FooterOffset = 0;
+        const char *Trailer = Data + Size - XMLBinary::TrailerSize;
+        for (int Byte = 0; Byte < 8; Byte++) {
+            FooterOffset |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(Trailer[Byte])) << (8 * Byte);
+        }
+        if (FooterOffset < XMLBinary::HeaderSize || FooterOffset > Size - XMLBinary::TrailerSize) return false;
+        const char *Footer = Data + FooterOffset;
+        std::uint64_t Count, Delta, Entities;
+        if (!Varint::Decode(Footer, Trailer, Count)) return false;
+        std::size_t Offset = 0;
+        for (std::uint64_t Index = 0; Index < Count; Index++) {
+            if (!Varint::Decode(Footer, Trailer, Delta) || !Varint::Decode(Footer, Trailer, Entities)) return false;
+            Offset += Delta;
+            if (Offset < XMLBinary::HeaderSize || Offset >= FooterOffset) return false;
+            Blocks.push_back({Offset, Entities});
+        }
+        BlockEnd = FooterOffset;
+        LastBlock = Blocks.size();
+        return Valid = true;
+    }
+
+    bool DecodeString(std::string_view &str) {
+        std::uint64_t Length;
+        if (!Varint::Decode(Ptr, Stop, Length) || Length > static_cast<std::size_t>(Stop - Ptr)) return false;
+        str = std::string_view(Ptr, Length);
+        Ptr += Length;
+        return true;
+    }
+
+    bool DecodeId(std::string_view &str) {
+        std::uint64_t Id;
+        if (!Varint::Decode(Ptr, Stop, Id) || Id >= Dictionary.size()) return false;
+        str = Dictionary[Id];
+        return true;
+    }
+
+    // positions at the start of the next block and reads its dictionary,
+    // false at the end of the range or when the block is corrupt
+    bool NextBlock() {
+        while (Remaining == 0) {
+            if (Block >= LastBlock) return false;
+            Ptr = Data + Blocks[Block].Offset;
+            Stop = Data + (Block + 1 < Blocks.size() ? Blocks[Block + 1].Offset : BlockEnd);
+            Block++;
+            std::uint64_t Entities, Words;
+            if (!Varint::Decode(Ptr, Stop, Entities) || !Varint::Decode(Ptr, Stop, Words) ||
+                Entities != Blocks[Block - 1].Entities || Words > static_cast<std::size_t>(Stop - Ptr)) {
+                Failed = true;
+                return false;
+            }
+            Dictionary.resize(Words);
+            for (auto &Word : Dictionary) {
+                if (!DecodeString(Word)) {
+                    Failed = true;
+                    return false;
+                }
+            }
+            Remaining = Entities;
+        }
+        return true;
+    }
+
+    bool DecodeEntity(SXMLEntity &entity) {
+        if (Ptr >= Stop) return false;
+        std::uint8_t Type = static_cast<std::uint8_t>(*Ptr++);
+        std::string_view Name;
+        std::uint64_t Count;
+        entity.DAttributes.clear();
+        switch (Type) {
+            case static_cast<std::uint8_t>(SXMLEntity::EType::StartElement):
+            case static_cast<std::uint8_t>(SXMLEntity::EType::CompleteElement):
+                if (!DecodeId(Name) || !Varint::Decode(Ptr, Stop, Count) || Count > static_cast<std::size_t>(Stop - Ptr)) return false;
+                entity.DAttributes.resize(Count);
+                for (auto &Attribute : entity.DAttributes) {
+                    std::string_view Key, Value;
+                    if (!DecodeId(Key) || !DecodeString(Value)) return false;
+                    Attribute.first.assign(Key);
+                    Attribute.second.assign(Value);
+                }
+                break;
+            case static_cast<std::uint8_t>(SXMLEntity::EType::EndElement):
+                if (!DecodeId(Name)) return false;
+                break;
+            case static_cast<std::uint8_t>(SXMLEntity::EType::CharData):
+                if (!DecodeString(Name)) return false;
+                break;
+            default:
+                return false;
+        }
+        entity.DType = static_cast<SXMLEntity::EType>(Type);
+        entity.DNameData.assign(Name);
+        return true;
+    }
+
+    bool AtEnd() const {
+        return Failed || (Remaining == 0 && Block >= LastBlock);
+    }
+
+    bool ReadEntity(SXMLEntity &entity, bool skipcdata) {
+        while (!Failed) {
+            if (!NextBlock()) {
+                return false;
+            }
+            if (!DecodeEntity(entity)) {
+                Failed = true;
+                return false;
+            }
+            Remaining--;
+            if (!(skipcdata && entity.DType == SXMLEntity::EType::CharData)) return true;
+        }
+        return false;
+    }
+
+    bool SeekBlock(std::size_t block, std::size_t count) {
+        if (!Valid || block > Blocks.size()) return false;
+        Block = block;
+        LastBlock = block + std::min(count, Blocks.size() - block);
+        Remaining = 0;
+        Failed = false;
+        return true;
+    }
+};
+
+// maps a file written by CXMLBinaryWriter
+CXMLBinaryReader::CXMLBinaryReader(const std::string &path) : DImplementation(std::make_unique<SImplementation>()) {
+    if (DImplementation->Map(path)) {
+        DImplementation->Open();
+    }
+}
+
+// replays a stream already in memory
+CXMLBinaryReader::CXMLBinaryReader(std::shared_ptr<const std::string> data) : DImplementation(std::make_unique<SImplementation>()) {
+    if (data) {
+        DImplementation->Owned = std::move(data);
+        DImplementation->Data = DImplementation->Owned->data();
+        DImplementation->Size = DImplementation->Owned->size();
+        DImplementation->Open();
+    }
+}
+
+CXMLBinaryReader::~CXMLBinaryReader() = default;
+
+// true when the stream was found and its block table is intact
+bool CXMLBinaryReader::IsOpen() const {
+    return DImplementation->Valid;
+}
+
+std::size_t CXMLBinaryReader::BlockCount() const {
+    return DImplementation->Blocks.size();
+}
+
+std::size_t CXMLBinaryReader::BlockEntities(std::size_t block) const {
+    return block < DImplementation->Blocks.size() ? DImplementation->Blocks[block].Entities : 0;
+}
+
+// replays from the start of a block, stopping after count blocks, elements
+// can span blocks so a range on its own may not be balanced
+bool CXMLBinaryReader::SeekBlock(std::size_t block, std::size_t count) {
+    return DImplementation->SeekBlock(block, count);
+}
+
+// returns true once every entity in the range has been read, or the stream is corrupt
+bool CXMLBinaryReader::End() const {
+    return DImplementation->AtEnd();
+}
+
+// reads the next entity, with an option to skip character data
+bool CXMLBinaryReader::ReadEntity(SXMLEntity &entity, bool skipcdata) {
+    return DImplementation->ReadEntity(entity, skipcdata);
+}
+
+// lazily reads the remaining entities, one entity buffer is reused for every step
+CGenerator<SXMLEntity> CXMLBinaryReader::Entities(bool skipcdata) {
+    SXMLEntity entity;
+    while (ReadEntity(entity, skipcdata)) {
+        co_yield entity;
+    }
+}
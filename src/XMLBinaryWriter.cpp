@@ -0,0 +1,128 @@
+#include "XMLBinaryWriter.h"
+#include "XMLBinaryFormat.h"
+#include "Varint.h"
+#include <cstring>
+#include <unordered_map>
+
+struct CXMLBinaryWriter::SImplementation {
+    std::shared_ptr<CDataSink> Sink; // where the stream is written
+    std::size_t BlockEntities; // entities per block
+    std::vector<char> Payload; // encoded entities of the current block
+    std::size_t Entities = 0; // entities in the current block
+    std::unordered_map<std::string, std::uint64_t> Ids; // dictionary of the current block
+    std::vector<const std::string *> Dictionary; // dictionary strings in id order
+    std::vector<char> Footer; // offset delta and entity count of each finished block
+    std::size_t Blocks = 0; // finished blocks
+    std::size_t Offset = 0; // bytes written so far
+    std::size_t PreviousBlock = 0; // offset of the last finished block
+    bool Started = false; // the header has been written
+    bool Done = false; // Flush has written the footer
+
+    SImplementation(std::shared_ptr<CDataSink> sink, std::size_t blockentities)
+        : Sink(std::move(sink)), BlockEntities(blockentities ? blockentities : 1) {}
+
+    bool Write(const std::vector<char> &buf) {
+        Offset += buf.size();
+        return Sink->Write(buf);
+    }
+
+    static void AppendString(std::vector<char> &buf, const std::string &str) {
+        Varint::Append(buf, str.size());
+        buf.insert(buf.end(), str.begin(), str.end());
+    }
+
+    // the dictionary id of a name or key, adding it on first use in the block
+    std::uint64_t Id(const std::string &str) {
+        auto Found = Ids.try_emplace(str, Ids.size());
+        if (Found.second) {
+            Dictionary.push_back(&Found.first->first);
+        }
+        return Found.first->second;
+    }
+
+    bool Start() {
+        if (Started) return true;
+        Started = true;
+        std::vector<char> Header(XMLBinary::Magic, XMLBinary::Magic + sizeof(XMLBinary::Magic));
+        Header.push_back(XMLBinary::Version);
+        return Write(Header);
+    }
+
+    // writes the current block with its dictionary in front
+    bool FinishBlock() {
+        if (!Entities) return true;
+        std::vector<char> Block;
+        Varint::Append(Block, Entities);
+        Varint::Append(Block, Dictionary.size());
+        for (auto String : Dictionary) {
+            AppendString(Block, *String);
+        }
+        Varint::Append(Footer, Offset - PreviousBlock);
+        Varint::Append(Footer, Entities);
+        PreviousBlock = Offset;
+        Blocks++;
+        bool Result = Write(Block) && Write(Payload);
+        Payload.clear();
+        Entities = 0;
+        Ids.clear();
+        Dictionary.clear();
+        return Result;
+    }
+
+    bool WriteEntity(const SXMLEntity &entity) {
+        if (Done || !Sink || !Start()) return false;
+        Payload.push_back(static_cast<char>(entity.DType));
+        switch (entity.DType) {
+            case SXMLEntity::EType::StartElement:
+            case SXMLEntity::EType::CompleteElement:
+                Varint::Append(Payload, Id(entity.DNameData));
+                Varint::Append(Payload, entity.DAttributes.size());
+                for (auto &Attribute : entity.DAttributes) {
+                    Varint::Append(Payload, Id(Attribute.first));
+                    AppendString(Payload, Attribute.second);
+                }
+                break;
+            case SXMLEntity::EType::EndElement:
+                Varint::Append(Payload, Id(entity.DNameData));
+                break;
+            case SXMLEntity::EType::CharData:
+                AppendString(Payload, entity.DNameData);
+                break;
+        }
+        return ++Entities < BlockEntities || FinishBlock();
+    }
+
+    bool Flush() {
+        if (Done || !Sink || !Start() || !FinishBlock()) return false;
+        Done = true;
+        std::size_t FooterOffset = Offset;
+        std::vector<char> Tail;
+        Varint::Append(Tail, Blocks);
+        Tail.insert(Tail.end(), Footer.begin(), Footer.end());
+        for (int Byte = 0; Byte < 8; Byte++) {
+            Tail.push_back(static_cast<char>((static_cast<std::uint64_t>(FooterOffset) >> (8 * Byte)) & 0xFF));
+        }
+        Tail.insert(Tail.end(), XMLBinary::Magic, XMLBinary::Magic + sizeof(XMLBinary::Magic));
+        return Write(Tail);
+    }
+};
+
+// blockentities is the number of entities per block, the unit of seeking and parallel replay
+CXMLBinaryWriter::CXMLBinaryWriter(std::shared_ptr<CDataSink> sink, std::size_t blockentities)
+    : DImplementation(std::make_unique<SImplementation>(std::move(sink), blockentities)) {}
+
+CXMLBinaryWriter::~CXMLBinaryWriter() = default;
+
+bool CXMLBinaryWriter::WriteEntity(const SXMLEntity &entity) {
+    return DImplementation->WriteEntity(entity);
+}
+
+// writes the last block and the block table, the stream is unreadable until this is called
+bool CXMLBinaryWriter::Flush() {
+    return DImplementation->Flush();
+}
+
+// blocks written so far
+std::size_t CXMLBinaryWriter::BlockCount() const {
+    return DImplementation->Blocks;
+}
@@ -0,0 +1,471 @@
+#include "XMLDSVTranscoder.h"
+#include "BoundedQueue.h"
+#include "DSVReader.h"
+#include "DSVWriter.h"
+#include "XMLReader.h"
+#include "XMLWriter.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+namespace {
+
+using TClock = std::chrono::steady_clock;
+
+std::uint64_t Since(TClock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(TClock::now() - start).count();
+}
+
+// passes reads through while counting the bytes the reader stage consumed
+class CCountingDataSource : public CDataSource {
+    private:
+        std::shared_ptr<CDataSource> DSource;
+        std::uint64_t DBytes = 0;
+
+    public:
+        CCountingDataSource(std::shared_ptr<CDataSource> src) : DSource(std::move(src)) {}
+
+        std::uint64_t Bytes() const noexcept { return DBytes; }
+
+        bool End() const noexcept override { return DSource->End(); }
+        bool Get(char &ch) noexcept override {
+            bool Result = DSource->Get(ch);
+            DBytes += Result;
+            return Result;
+        }
+        bool Peek(char &ch) noexcept override { return DSource->Peek(ch); }
+        bool Read(std::vector<char> &buf, std::size_t count) noexcept override {
+            bool Result = DSource->Read(buf, count);
+            DBytes += Result ? buf.size() : 0;
+            return Result;
+        }
+};
+
+// passes writes through while counting the bytes the writer stage produced
+class CCountingDataSink : public CDataSink {
+    private:
+        std::shared_ptr<CDataSink> DSink;
+        std::uint64_t DBytes = 0;
+
+    public:
+        CCountingDataSink(std::shared_ptr<CDataSink> sink) : DSink(std::move(sink)) {}
+
+        std::uint64_t Bytes() const noexcept { return DBytes; }
+
+        bool Put(const char &ch) noexcept override {
+            DBytes++;
+            return DSink->Put(ch);
+        }
+        bool Write(const std::vector<char> &buf) noexcept override {
+            DBytes += buf.size();
+            return DSink->Write(buf);
+        }
+};
+
+// a field path split into what it selects
+struct SPath {
+    enum class EKind {Text, Attribute, Child, ChildAttribute};
+    EKind Kind = EKind::Text;
+    std::string Child;
+    std::string Attribute;
+};
+
+bool ParsePath(const std::string &path, SPath &result) {
+    result = SPath();
+    if (path == ".") {
+        result.Kind = SPath::EKind::Text;
+        return true;
+    }
+    if (path.size() > 1 && path[0] == '@') {
+        result.Kind = SPath::EKind::Attribute;
+        result.Attribute = path.substr(1);
+        return true;
+    }
+    std::size_t Split = path.find("/@");
+    if (Split == std::string::npos) {
+        result.Kind = SPath::EKind::Child;
+        result.Child = path;
+        return !path.empty() && path.find_first_of("/@") == std::string::npos;
+    }
+    result.Kind = SPath::EKind::ChildAttribute;
+    result.Child = path.substr(0, Split);
+    result.Attribute = path.substr(Split + 2);
+    return !result.Child.empty() && !result.Attribute.empty() && result.Child.find('@') == std::string::npos;
+}
+
+// turns the entity stream into one row per record element, the first
+// occurrence of a child wins when a record repeats it
+class CRowBuilder {
+    private:
+        const std::string &DRecord;
+        const std::vector<SPath> &DPaths;
+        int DDepth = 0;
+        int DRecordDepth = -1;
+        std::vector<std::string> DRow;
+        std::vector<char> DCollecting;
+        std::vector<char> DDone;
+
+    public:
+        CRowBuilder(const std::string &record, const std::vector<SPath> &paths)
+            : DRecord(record), DPaths(paths), DRow(paths.size()), DCollecting(paths.size()), DDone(paths.size()) {}
+
+        // true when entity completed a row, which is then copied into row
+        bool Add(const SXMLEntity &entity, std::vector<std::string> &row) {
+            switch (entity.DType) {
+                case SXMLEntity::EType::StartElement:
+                    DDepth++;
+                    if (DRecordDepth < 0 && entity.DNameData == DRecord) {
+                        DRecordDepth = DDepth;
+                        for (std::size_t Index = 0; Index < DPaths.size(); Index++) {
+                            DRow[Index].clear();
+                            DCollecting[Index] = DDone[Index] = false;
+                            if (DPaths[Index].Kind == SPath::EKind::Attribute) {
+                                DRow[Index] = entity.AttributeValue(DPaths[Index].Attribute);
+                            }
+                        }
+                    } else if (DRecordDepth >= 0 && DDepth == DRecordDepth + 1) {
+                        for (std::size_t Index = 0; Index < DPaths.size(); Index++) {
+                            if (DDone[Index] || DPaths[Index].Child != entity.DNameData) {
+                                continue;
+                            }
+                            if (DPaths[Index].Kind == SPath::EKind::ChildAttribute) {
+                                DRow[Index] = entity.AttributeValue(DPaths[Index].Attribute);
+                                DDone[Index] = true;
+                            } else if (DPaths[Index].Kind == SPath::EKind::Child) {
+                                DCollecting[Index] = true;
+                            }
+                        }
+                    }
+                    return false;
+                case SXMLEntity::EType::CharData:
+                    if (DRecordDepth < 0) {
+                        return false;
+                    }
+                    for (std::size_t Index = 0; Index < DPaths.size(); Index++) {
+                        if (DCollecting[Index] || (DDepth == DRecordDepth && DPaths[Index].Kind == SPath::EKind::Text)) {
+                            DRow[Index] += entity.DNameData;
+                        }
+                    }
+                    return false;
+                case SXMLEntity::EType::EndElement:
+                    if (DDepth == DRecordDepth + 1) {
+                        for (std::size_t Index = 0; Index < DPaths.size(); Index++) {
+                            if (DCollecting[Index]) {
+                                DCollecting[Index] = false;
+                                DDone[Index] = true;
+                            }
+                        }
+                    }
+                    if (DDepth-- == DRecordDepth) {
+                        DRecordDepth = -1;
+                        row = DRow;
+                        return true;
+                    }
+                    return false;
+                case SXMLEntity::EType::CompleteElement:
+                    return false;
+            }
+            return false;
+        }
+};
+
+// a child element written for each row with the fields it carries
+struct SChildGroup {
+    std::string Name;
+    std::vector<std::size_t> Text;
+    std::vector<std::size_t> Attributes;
+};
+
+// pushes and pops batches while adding the time spent blocked to wait, a
+// pushed batch is left empty for refilling
+template <typename T>
+bool TimedPush(CBoundedQueue<T> &queue, T &batch, std::uint64_t &wait) {
+    auto Start = TClock::now();
+    bool Result = queue.Push(std::move(batch));
+    wait += Since(Start);
+    batch.clear();
+    return Result;
+}
+
+template <typename T>
+bool TimedPop(CBoundedQueue<T> &queue, T &item, std::uint64_t &wait) {
+    auto Start = TClock::now();
+    bool Result = queue.Pop(item);
+    wait += Since(Start);
+    return Result;
+}
+
+}
+
+struct CXMLDSVTranscoder::SImplementation {
+    SSpec Spec; // record element, fields and format options
+    std::vector<SPath> Paths; // parsed DPath of each field
+    bool Valid = true; // every field path parsed
+    std::size_t BatchSize; // items per queue entry
+    std::size_t QueueDepth; // batches each queue holds
+    std::vector<SStageStats> Stages; // stats of the last run
+
+    SImplementation(SSpec spec, std::size_t batchsize, std::size_t queuedepth)
+        : Spec(std::move(spec)), BatchSize(batchsize ? batchsize : 1), QueueDepth(queuedepth ? queuedepth : 1) {
+        for (auto &Field : Spec.DFields) {
+            Paths.emplace_back();
+            Valid = ParsePath(Field.DPath, Paths.back()) && Valid;
+        }
+        Valid = Valid && !Spec.DRecordElement.empty();
+    }
+
+    // runs body on a thread and records its wall and busy time once it returns
+    std::thread Launch(SStageStats &stats, std::function<void(std::uint64_t &)> body) {
+        return std::thread([&stats, body = std::move(body)] {
+            auto Start = TClock::now();
+            std::uint64_t Wait = 0;
+            body(Wait);
+            stats.DWallNanoseconds = Since(Start);
+            stats.DBusyNanoseconds = stats.DWallNanoseconds > Wait ? stats.DWallNanoseconds - Wait : 0;
+        });
+    }
+
+    void ResetStages(const char *read, const char *map, const char *write) {
+        Stages.assign(3, SStageStats());
+        Stages[0].DName = read;
+        Stages[1].DName = map;
+        Stages[2].DName = write;
+    }
+
+    bool XMLToDSV(std::shared_ptr<CDataSource> src, std::shared_ptr<CDataSink> sink) {
+        ResetStages("xml read", "map", "dsv write");
+        if (!Valid || !src || !sink) return false;
+        auto Source = std::make_shared<CCountingDataSource>(std::move(src));
+        auto Sink = std::make_shared<CCountingDataSink>(std::move(sink));
+        CBoundedQueue<std::vector<SXMLEntity>> Entities(QueueDepth);
+        CBoundedQueue<std::vector<std::vector<std::string>>> Rows(QueueDepth);
+        std::atomic<bool> Failed{false};
+        auto Fail = [&] {
+            Failed = true;
+            Entities.Close();
+            Rows.Close();
+        };
+
+        std::thread Reader = Launch(Stages[0], [&](std::uint64_t &wait) {
+            CXMLReader Reader(Source);
+            std::vector<SXMLEntity> Batch;
+            SXMLEntity Entity;
+            while (Reader.ReadEntity(Entity)) {
+                Batch.push_back(std::move(Entity));
+                Stages[0].DItems++;
+                if (Batch.size() == BatchSize && !TimedPush(Entities, Batch, wait)) return;
+            }
+            if (!Reader.End()) {
+                Fail(); // malformed xml
+                return;
+            }
+            if (!Batch.empty()) TimedPush(Entities, Batch, wait);
+            Stages[0].DBytes = Source->Bytes();
+            Entities.Close();
+        });
+
+        std::thread Mapper = Launch(Stages[1], [&](std::uint64_t &wait) {
+            CRowBuilder Builder(Spec.DRecordElement, Paths);
+            std::vector<SXMLEntity> Batch;
+            std::vector<std::vector<std::string>> Out;
+            std::vector<std::string> Row;
+            while (TimedPop(Entities, Batch, wait)) {
+                for (auto &Entity : Batch) {
+                    if (!Builder.Add(Entity, Row)) continue;
+                    Out.push_back(std::move(Row));
+                    Stages[1].DItems++;
+                    if (Out.size() == BatchSize && !TimedPush(Rows, Out, wait)) return;
+                }
+            }
+            if (!Out.empty()) TimedPush(Rows, Out, wait);
+            Rows.Close();
+        });
+
+        std::thread Writer = Launch(Stages[2], [&](std::uint64_t &wait) {
+            CDSVWriter Writer(Sink, Spec.DDelimiter);
+            if (Spec.DHeader) {
+                std::vector<std::string> Header;
+                for (auto &Field : Spec.DFields) {
+                    Header.push_back(Field.DColumn);
+                }
+                if (!Writer.WriteRow(Header)) return Fail();
+            }
+            std::vector<std::vector<std::string>> Batch;
+            while (TimedPop(Rows, Batch, wait)) {
+                for (auto &Row : Batch) {
+                    if (!Writer.WriteRow(Row)) return Fail();
+                }
+                Stages[2].DItems += Batch.size();
+            }
+            Stages[2].DBytes = Sink->Bytes();
+        });
+
+        Reader.join();
+        Mapper.join();
+        Writer.join();
+        Stages[1].DQueueHighWater = Entities.HighWater();
+        Stages[2].DQueueHighWater = Rows.HighWater();
+        return !Failed;
+    }
+
+    bool DSVToXML(std::shared_ptr<CDataSource> src, std::shared_ptr<CDataSink> sink) {
+        ResetStages("dsv read", "map", "xml write");
+        if (!Valid || !src || !sink) return false;
+        auto Source = std::make_shared<CCountingDataSource>(std::move(src));
+        auto Sink = std::make_shared<CCountingDataSink>(std::move(sink));
+        CBoundedQueue<std::vector<std::vector<std::string>>> Rows(QueueDepth);
+        CBoundedQueue<std::vector<SXMLEntity>> Entities(QueueDepth);
+        std::atomic<bool> Failed{false};
+        auto Fail = [&] {
+            Failed = true;
+            Rows.Close();
+            Entities.Close();
+        };
+
+        std::thread Reader = Launch(Stages[0], [&](std::uint64_t &wait) {
+            CDSVReader Reader(Source, Spec.DDelimiter);
+            std::vector<std::vector<std::string>> Batch;
+            std::vector<std::string> Row;
+            while (Reader.ReadRow(Row)) {
+                Batch.push_back(std::move(Row));
+                Stages[0].DItems++;
+                if (Batch.size() == BatchSize && !TimedPush(Rows, Batch, wait)) return;
+            }
+            if (!Batch.empty()) TimedPush(Rows, Batch, wait);
+            Stages[0].DBytes = Source->Bytes();
+            Rows.Close();
+        });
+
+        std::thread Mapper = Launch(Stages[1], [&](std::uint64_t &wait) {
+            // columns are found by header name, or by position without a header
+            std::vector<std::size_t> Columns(Paths.size());
+            for (std::size_t Index = 0; Index < Columns.size(); Index++) {
+                Columns[Index] = Index;
+            }
+            bool NeedHeader = Spec.DHeader;
+            std::vector<std::size_t> Text;
+            std::vector<std::size_t> Attributes;
+            std::vector<SChildGroup> Children;
+            for (std::size_t Index = 0; Index < Paths.size(); Index++) {
+                if (Paths[Index].Kind == SPath::EKind::Text) {
+                    Text.push_back(Index);
+                } else if (Paths[Index].Kind == SPath::EKind::Attribute) {
+                    Attributes.push_back(Index);
+                } else {
+                    auto Group = Children.begin();
+                    while (Group != Children.end() && Group->Name != Paths[Index].Child) Group++;
+                    if (Group == Children.end()) {
+                        Children.push_back({Paths[Index].Child, {}, {}});
+                        Group = Children.end() - 1;
+                    }
+                    (Paths[Index].Kind == SPath::EKind::Child ? Group->Text : Group->Attributes).push_back(Index);
+                }
+            }
+
+            std::vector<std::vector<std::string>> Batch;
+            std::vector<SXMLEntity> Out;
+            while (TimedPop(Rows, Batch, wait)) {
+                for (auto &Row : Batch) {
+                    if (NeedHeader) {
+                        NeedHeader = false;
+                        for (std::size_t Index = 0; Index < Columns.size(); Index++) {
+                            Columns[Index] = Row.size();
+                            for (std::size_t Column = 0; Column < Row.size(); Column++) {
+                                if (Row[Column] == Spec.DFields[Index].DColumn) {
+                                    Columns[Index] = Column;
+                                    break;
+                                }
+                            }
+                        }
+                        continue;
+                    }
+                    auto Value = [&](std::size_t field) -> const std::string & {
+                        static const std::string Empty;
+                        return Columns[field] < Row.size() ? Row[Columns[field]] : Empty;
+                    };
+                    auto Emit = [&](SXMLEntity::EType type, const std::string &name) -> SXMLEntity & {
+                        Out.push_back({type, name, {}});
+                        return Out.back();
+                    };
+
+                    SXMLEntity &Record = Emit(SXMLEntity::EType::StartElement, Spec.DRecordElement);
+                    for (auto Field : Attributes) {
+                        Record.DAttributes.emplace_back(Paths[Field].Attribute, Value(Field));
+                    }
+                    for (auto Field : Text) {
+                        if (!Value(Field).empty()) Emit(SXMLEntity::EType::CharData, Value(Field));
+                    }
+                    for (auto &Group : Children) {
+                        SXMLEntity &Child = Emit(SXMLEntity::EType::StartElement, Group.Name);
+                        for (auto Field : Group.Attributes) {
+                            Child.DAttributes.emplace_back(Paths[Field].Attribute, Value(Field));
+                        }
+                        for (auto Field : Group.Text) {
+                            if (!Value(Field).empty()) Emit(SXMLEntity::EType::CharData, Value(Field));
+                        }
+                        Emit(SXMLEntity::EType::EndElement, Group.Name);
+                    }
+                    Emit(SXMLEntity::EType::EndElement, Spec.DRecordElement);
+                    Stages[1].DItems++;
+                    if (Out.size() >= BatchSize && !TimedPush(Entities, Out, wait)) return;
+                }
+            }
+            if (!Out.empty()) TimedPush(Entities, Out, wait);
+            Entities.Close();
+        });
+
+        std::thread Writer = Launch(Stages[2], [&](std::uint64_t &wait) {
+            CXMLWriter Writer(Sink);
+            if (!Writer.WriteEntity({SXMLEntity::EType::StartElement, Spec.DRootElement, {}})) return Fail();
+            std::vector<SXMLEntity> Batch;
+            while (TimedPop(Entities, Batch, wait)) {
+                for (auto &Entity : Batch) {
+                    if (!Writer.WriteEntity(Entity)) return Fail();
+                }
+                Stages[2].DItems += Batch.size();
+            }
+            if (!Failed && !Writer.Flush()) return Fail();
+            Stages[2].DBytes = Sink->Bytes();
+        });
+
+        Reader.join();
+        Mapper.join();
+        Writer.join();
+        Stages[1].DQueueHighWater = Rows.HighWater();
+        Stages[2].DQueueHighWater = Entities.HighWater();
+        return !Failed;
+    }
+};
+
+// batchsize is the number of entities or rows passed between stages at once
+// and queuedepth the number of batches each queue holds
+CXMLDSVTranscoder::CXMLDSVTranscoder(SSpec spec, std::size_t batchsize, std::size_t queuedepth)
+    : DImplementation(std::make_unique<SImplementation>(std::move(spec), batchsize, queuedepth)) {}
+
+CXMLDSVTranscoder::~CXMLDSVTranscoder() = default;
+
+// writes one row per record element, preceded by the column names when the spec has a header
+bool CXMLDSVTranscoder::XMLToDSV(std::shared_ptr<CDataSource> src, std::shared_ptr<CDataSink> sink) {
+    return DImplementation->XMLToDSV(std::move(src), std::move(sink));
+}
+
+// writes one record element per row inside the root element, with a header
+// the first row names the columns, otherwise columns follow the field order
+bool CXMLDSVTranscoder::DSVToXML(std::shared_ptr<CDataSource> src, std::shared_ptr<CDataSink> sink) {
+    return DImplementation->DSVToXML(std::move(src), std::move(sink));
+}
+
+// reader, mapper and writer stats from the last conversion
+const std::vector<CXMLDSVTranscoder::SStageStats> &CXMLDSVTranscoder::Stages() const {
+    return DImplementation->Stages;
+}
+
+// parses "column=path", or a bare name used as both the column and a child element path
+bool CXMLDSVTranscoder::ParseField(const std::string &arg, SField &field) {
+    std::size_t Equals = arg.find('=');
+    field.DColumn = arg.substr(0, Equals);
+    field.DPath = Equals == std::string::npos ? arg : arg.substr(Equals + 1);
+    SPath Path;
+    return !field.DColumn.empty() && ParsePath(field.DPath, Path);
+}
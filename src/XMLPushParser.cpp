@@ -0,0 +1,202 @@
+#include "XMLPushParser.h"
+#include <expat.h>
+#include <new>
+#include <string>
+
+struct CXMLPushParser::SImplementation {
+    XML_Parser Parser; // parser object from the Expat library
+    TEntityCallback Callback; // receives each entity
+    TPmrEntityCallback PmrCallback; // receives each entity when built from a memory resource
+    std::string Buffer; // buffer to accumulate text data between XML tags
+    std::pmr::string PmrBuffer; // the same for entities built from a memory resource
+    bool Done = false; // Finish has been called
+    bool TextStarted = false; // character data has begun since the last element
+    std::size_t TextStart = 0; // byte index where that character data began
+    std::size_t Offset = 0; // byte index of the markup behind the entity being emitted
+    bool OutOfMemory = false; // an allocation in a handler failed and parsing was stopped
+
+    // builds and emits a start or end element along with the text before it
+    template <typename TEntity, typename TCallback>
+    void EmitElement(TCallback &callback, typename TEntity::TString &text, const char *name, const char **element, bool isStart) {
+        FlushCharData<TEntity>(callback, text);  // flush out any accumulated character data
+
+        // expat places the end of an empty element tag just past the tag with
+        // no bytes of its own, it keeps the offset of the tag like the start
+        if (isStart || XML_GetCurrentByteCount(Parser)) {
+            Offset = XML_GetCurrentByteIndex(Parser);
+        }
+        TEntity entity(text.get_allocator());
+        entity.DType = isStart ? SXMLEntity::EType::StartElement : SXMLEntity::EType::EndElement;
+        entity.DNameData = name;
+
+        // if it is a start element and it has attributes, parse them
+        if (isStart && element) {
+            for (int i = 0; element[i] != nullptr; i += 2) {
+                if (element[i + 1] != nullptr) {
+                    entity.DAttributes.emplace_back(element[i], element[i + 1]);
+                }
+            }
+        }
+
+        if (callback) {
+            callback(entity);
+        }
+    }
+
+    // emits accumulated character data as an entity
+    template <typename TEntity, typename TCallback>
+    void FlushCharData(TCallback &callback, typename TEntity::TString &text) {
+        TextStarted = false;
+        if (!text.empty()) {
+            Offset = TextStart;
+            TEntity entity(text.get_allocator());
+            entity.DType = SXMLEntity::EType::CharData;
+            entity.DNameData = std::move(text);
+            text.clear();
+            if (callback) {
+                callback(entity);
+            }
+        }
+    }
+
+    // runs a handler body, an allocation failing inside it, as one from a
+    // limited memory resource does, must not unwind through expat, so it
+    // stops the parser instead and Feed reports the failure
+    template <typename TBody>
+    void Guard(TBody &&body) {
+        if (OutOfMemory) return;
+        try {
+            body();
+        } catch (const std::bad_alloc &) {
+            OutOfMemory = true;
+            XML_StopParser(Parser, XML_FALSE);
+        }
+    }
+
+    // handles both start and end element events in one unified function
+    static void ElementHandler(void *userData, const char *name, const char **element, bool isStart) {
+        auto *impl = static_cast<SImplementation *>(userData);
+        impl->Guard([&]() {
+            if (impl->PmrCallback) {
+                impl->EmitElement<SPmrXMLEntity>(impl->PmrCallback, impl->PmrBuffer, name, element, isStart);
+            } else {
+                impl->EmitElement<SXMLEntity>(impl->Callback, impl->Buffer, name, element, isStart);
+            }
+        });
+    }
+
+    // wrapper to handle the start of an XML element
+    static void StartElementHandler(void *userData, const char *name, const char **element) {
+        ElementHandler(userData, name, element, true);
+    }
+
+    // wrapper to handle the end of an XML element
+    static void EndElementHandler(void *userData, const char *name) {
+        ElementHandler(userData, name, nullptr, false);
+    }
+
+    // remembers where the character data for the next entity began
+    void StartText() {
+        if (!TextStarted) {
+            TextStarted = true;
+            TextStart = XML_GetCurrentByteIndex(Parser);
+        }
+    }
+
+    // a CDATA section's text starts at its opening markup
+    static void StartCdataHandler(void *userData) {
+        static_cast<SImplementation *>(userData)->StartText();
+    }
+
+    // processes character data found within XML elements
+    static void CharDataHandler(void *userData, const char *j, int len) {
+        if (j && len > 0) {
+            auto *impl = static_cast<SImplementation *>(userData);
+            impl->Guard([&]() {
+                impl->StartText();
+                if (impl->PmrCallback) {
+                    impl->PmrBuffer.append(j, len);
+                } else {
+                    impl->Buffer.append(j, len);
+                }
+            });
+        }
+    }
+
+    // sets up the parser and registers handlers for parsing events
+    SImplementation(TEntityCallback callback, TPmrEntityCallback pmrcallback, std::pmr::memory_resource *resource)
+        : Callback(std::move(callback)), PmrCallback(std::move(pmrcallback)), PmrBuffer(resource) {
+        Parser = XML_ParserCreate(nullptr);
+        SetHandlers();
+    }
+
+    void SetHandlers() {
+        XML_SetUserData(Parser, this);
+        XML_SetElementHandler(Parser, StartElementHandler, EndElementHandler);
+        XML_SetCharacterDataHandler(Parser, CharDataHandler);
+        XML_SetCdataSectionHandler(Parser, StartCdataHandler, nullptr);
+    }
+
+    // starts over on a new document, keeping the callback
+    void Reset() {
+        XML_ParserReset(Parser, nullptr);
+        SetHandlers();
+        Buffer.clear();
+        PmrBuffer.clear();
+        Done = false;
+        TextStarted = false;
+        TextStart = 0;
+        Offset = 0;
+        OutOfMemory = false;
+    }
+
+    ~SImplementation() {
+        XML_ParserFree(Parser);
+    }
+};
+
+// the callback is called from inside Feed and Finish
+CXMLPushParser::CXMLPushParser(TEntityCallback callback)
+    : DImplementation(std::make_unique<SImplementation>(std::move(callback), nullptr, std::pmr::get_default_resource())) {}
+
+// entities are built with the resource's allocator, so the callback can move
+// them into containers using the same resource without copying
+CXMLPushParser::CXMLPushParser(TPmrEntityCallback callback, std::pmr::memory_resource *resource)
+    : DImplementation(std::make_unique<SImplementation>(nullptr, std::move(callback), resource ? resource : std::pmr::get_default_resource())) {}
+
+CXMLPushParser::~CXMLPushParser() = default;
+
+// parses the next chunk of input, fails on malformed XML or once Finish has been called
+bool CXMLPushParser::Feed(const char *data, std::size_t length) {
+    if (DImplementation->Done) return false;
+    return XML_Parse(DImplementation->Parser, data, static_cast<int>(length), 0) != XML_STATUS_ERROR && !DImplementation->OutOfMemory;
+}
+
+// marks the end of input, fails if the document is incomplete
+bool CXMLPushParser::Finish() {
+    if (DImplementation->Done) return false;
+    DImplementation->Done = true;
+    return XML_Parse(DImplementation->Parser, nullptr, 0, 1) != XML_STATUS_ERROR && !DImplementation->OutOfMemory;
+}
+
+// drops the state of the current document so a new one can be fed
+void CXMLPushParser::Reset() {
+    DImplementation->Reset();
+}
+
+bool CXMLPushParser::Finished() const {
+    return DImplementation->Done;
+}
+
+// true once an entity could not be allocated, the document cannot be fed further until Reset
+bool CXMLPushParser::OutOfMemory() const {
+    return DImplementation->OutOfMemory;
+}
+
+// while in the callback, the byte index counted from the first byte fed since
+// construction or Reset of the markup the entity came from, character data
+// counts from where its text began and both halves of an empty element tag
+// report the tag itself
+std::size_t CXMLPushParser::EntityOffset() const {
+    return DImplementation->Offset;
+}
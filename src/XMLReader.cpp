@@ -1,113 +1,255 @@
 #include "XMLReader.h"
-#include <expat.h>
-#include <queue>
+#include "SeekableDataSource.h"
+#include "Trace.h"
+#include "XMLPushParser.h"
+#include <deque>
 #include <memory>
 #include <vector>
 
 struct CXMLReader::SImplementation {
+    // where a queued entity came from, Ordinal counts the entities before it
+    // that came from the same markup, as the end of an empty element tag does
+    struct SMark {
+        std::size_t Offset;
+        std::size_t Ordinal;
+    };
+
     std::shared_ptr<CDataSource> Source;  // source for XML data stream
-    XML_Parser Parser; // parser object from the Expat library
-    std::queue<SXMLEntity> Queue; // queue to hold parsed XML entities
+    std::shared_ptr<CSeekableDataSource> Seekable; // same source when it supports seeking
+    std::shared_ptr<CMemoryAccount> Account; // resource of the queue and parser when accounted, outlives both
+    std::size_t Charged = 0; // bytes of Buffer charged to the account
+    std::pmr::deque<SPmrXMLEntity> Queue; // queue to hold parsed XML entities, carved from the resource
+    std::deque<SMark> Marks; // source position of each queued entity
+    CXMLPushParser Parser; // turns each chunk into entities
+    std::size_t Start = 0; // source offset of the first byte fed to the parser after any prefix
+    std::size_t PrefixLength = 0; // bytes of synthetic open elements fed before resuming
+    SMark Last{SIZE_MAX, 0}; // mark of the entity the parser emitted last
+    std::size_t ResumeSkip = 0; // entities to drop after resuming, they were returned before
+    std::vector<std::string> Stack; // names of the open elements, valid up to Depth
+    std::size_t Depth = 0; // open elements after the entities returned so far
+    std::size_t MarkDepth = 0; // open elements before the markup of the last entity returned
+    SMark Mark{0, 0}; // markup of the last entity returned and how many came from it
+    std::vector<char> Buffer; // block of bytes pulled from the source, reused for every refill
     bool Data; // flag to check if data parsing is complete
-    std::string Buffer; // buffer to accumulate text data between XML tags
-
-    // handles both start and end element events in one unified function
-    static void ElementHandler(void *userData, const char *name, const char **element, bool isStart) {
-        auto *impl = static_cast<SImplementation *>(userData);
-        impl->FlushCharData();  // flush out any accumulated character data
-
-        SXMLEntity entity;
-        entity.DType = isStart ? SXMLEntity::EType::StartElement : SXMLEntity::EType::EndElement;
-        entity.DNameData = name;
-
-        // if it is a start element and it has attributes, parse them
-        if (isStart && element) {
-            for (int i = 0; element[i] != nullptr; i += 2) {
-                if (element[i + 1] != nullptr) {
-                    entity.DAttributes.emplace_back(element[i], element[i + 1]);
-                }
-            }
-        }
-
-        impl->Queue.push(entity);  // add the constructed entity to the queue
-    }
-
-    // wrapper to handle the start of an XML element
-    static void StartElementHandler(void *userData, const char *name, const char **element) {
-        ElementHandler(userData, name, element, true);
-    }
+    CIOStatsCounters Stats{SIOStats::EKind::XMLReader}; // compiled out unless ENABLE_IOSTATS
+    std::uint64_t DrainStart = 0; // trace time the queue was last refilled
 
-    // wrapper to handle the end of an XML element
-    static void EndElementHandler(void *userData, const char *name) {
-        ElementHandler(userData, name, nullptr, false);
+    SImplementation(std::shared_ptr<CDataSource> src, std::pmr::memory_resource *resource, std::shared_ptr<CMemoryAccount> account = nullptr)
+        : Source(std::move(src)), Account(std::move(account)), Queue(resource),
+          Parser([this](SPmrXMLEntity &entity) { Queued(entity); }, resource), Data(false) {
+        Seekable = std::dynamic_pointer_cast<CSeekableDataSource>(Source);
+        Start = Seekable ? Seekable->Tell() : 0;
+        Mark.Offset = Start;
     }
 
-    // processes character data found within XML elements
-    static void CharDataHandler(void *userData, const char *j, int len) {
-        if (j && len > 0) {
-            static_cast<SImplementation *>(userData)->Buffer.append(j, len);  // Append text to the buffer.
+    ~SImplementation() {
+        if (Account) {
+            Account->Credit(Charged);
         }
     }
 
-    // constructor sets up the parser and registers handlers for parsing events
-    SImplementation(std::shared_ptr<CDataSource> src) : Source(std::move(src)), Data(false) {
-        Parser = XML_ParserCreate(nullptr);
-        XML_SetUserData(Parser, this);
-        XML_SetElementHandler(Parser, StartElementHandler, EndElementHandler);
-        XML_SetCharacterDataHandler(Parser, CharDataHandler);
+    // ends the document early once the account refuses memory, the queued
+    // entities are released since the reader cannot continue past them
+    bool Refuse() {
+        Data = true;
+        Queue.clear();
+        Marks.clear();
+        return false;
     }
 
-    // destructor cleans up the parser to prevent memory leaks
-    ~SImplementation() {
-        XML_ParserFree(Parser);
+    // queues an entity with the source position of its markup, entities from
+    // the synthetic prefix of a resume were returned before and are dropped
+    void Queued(SPmrXMLEntity &entity) {
+        std::size_t offset = Parser.EntityOffset();
+        if (offset < PrefixLength) {
+            return;
+        }
+        offset = Start + (offset - PrefixLength);
+        Last = {offset, offset == Last.Offset ? Last.Ordinal + 1 : 0};
+        Queue.push_back(std::move(entity));
+        Marks.push_back(Last);
     }
 
-    // flushes accumulated character data into the queue as an entity
-    void FlushCharData() {
-        if (!Buffer.empty()) {
-            Queue.push({SXMLEntity::EType::CharData, Buffer, {}});
-            Buffer.clear();  // Clear the buffer for new data.
+    // counts a returned entity, its fields are the character data or attribute values
+    void RecordEntity(const SPmrXMLEntity &entity) {
+        if (!CIOStatsCounters::Enabled) return;
+        std::size_t size = entity.DNameData.size();
+        Stats.AddField(entity.DNameData.size(), false);
+        for (const auto &attr : entity.DAttributes) {
+            size += attr.first.size() + attr.second.size();
+            Stats.AddField(attr.second.size(), false);
         }
+        Stats.AddRecord(size);
     }
 
-    // reads and parses XML data from the source, processing entities into the queue
-    bool ReadEntity(SXMLEntity &entity, bool skipcdata) {
-        while (Queue.empty() && !Data) {
-            std::vector<char> buffer(4096);
-            size_t length = 0;
-            while (length < buffer.size() && !Source->End()) {
-                char ch;
-                if (Source->Get(ch)) {
-                    buffer[length++] = ch;  // fill buffer with data from the source
-                } else {
+    // reads and parses XML data from the source until an entity is queued,
+    // dropping character data when asked to skip it
+    bool Fill(bool skipcdata) {
+        while (true) {
+            while (Queue.empty() && !Data) {
+                CIOStatsTimer readTimer;
+                {
+                    TRACE_SPAN("XMLReader::Refill");
+                    if (Source->End() || !Source->Read(Buffer, 4096)) {
+                        Buffer.clear();  // fill buffer with a block from the source
+                    }
+                }
+                size_t length = Buffer.size();
+                Stats.AddIOTime(readTimer.Nanoseconds());
+                if (Account && !Account->Resize(Charged, Buffer.capacity())) {
+                    return Refuse();
+                }
+
+                if (length == 0) {  // no more data to read indicates the end of the data source
+                    Data = true;
+                    Parser.Finish();  // signal the parser that parsing is complete
                     break;
                 }
+
+                CIOStatsTimer parseTimer;
+                bool parsed;
+                {
+                    TRACE_SPAN("XMLReader::XML_Parse");
+                    parsed = Parser.Feed(Buffer.data(), length);
+                }
+                DrainStart = CTrace::Now();
+                Stats.AddProcessTime(parseTimer.Nanoseconds());
+                Stats.AddParseCall();
+                Stats.AddBytes(length);
+                Stats.QueueDepth(Queue.size());
+                if (Parser.OutOfMemory()) {
+                    return Refuse();
+                }
+                if (!parsed) {
+                    return false;  // handle parsing errors
+                }
             }
 
-            if (length == 0) {  // no more data to read indicates the end of the data source
-                Data = true;
-                XML_Parse(Parser, nullptr, 0, 1);  // signal the parser that parsing is complete
-                break;
+            if (Queue.empty()) {
+                return false;  // return false if no more entities are available
+            }
+            if (ResumeSkip) {
+                ResumeSkip--;
+                Pop();
+                continue;
+            }
+            RecordEntity(Queue.front());
+            if (!(skipcdata && Queue.front().DType == SXMLEntity::EType::CharData)) {
+                return true;
             }
+            Pop();
+        }
+    }
 
-            if (XML_Parse(Parser, buffer.data(), length, 0) == XML_STATUS_ERROR) {
-                return false;  // handle parsing errors
+    // drops the front entity once it has been handed out, or moves it into
+    // entity, tracking the open elements and the markup it came from for checkpoints
+    void Pop(SPmrXMLEntity *entity = nullptr) {
+        SPmrXMLEntity &front = Queue.front();
+        const SMark &mark = Marks.front();
+        if (!mark.Ordinal) {
+            MarkDepth = Depth;
+        }
+        Mark = {mark.Offset, mark.Ordinal + 1};
+        if (front.DType == SXMLEntity::EType::StartElement) {
+            if (Depth == Stack.size()) {
+                Stack.emplace_back();
             }
+            Stack[Depth++].assign(front.DNameData);
+        } else if (front.DType == SXMLEntity::EType::EndElement && Depth) {
+            Depth--;
         }
+        if (entity) {
+            *entity = std::move(front);
+        }
+        Marks.pop_front();
+        Queue.pop_front();
+        if (Queue.empty() && DrainStart) {
+            CTrace::Record("XMLReader::QueueDrain", DrainStart, CTrace::Now());
+            DrainStart = 0;
+        }
+    }
 
-        if (!Queue.empty()) {
-            entity = Queue.front();
-            Queue.pop();
-            return !(skipcdata && entity.DType == SXMLEntity::EType::CharData) || ReadEntity(entity, skipcdata);
+    // copies the front entity into a heap entity, refilling its strings in place
+    bool ReadEntity(SXMLEntity &entity, bool skipcdata) {
+        if (!Fill(skipcdata)) return false;
+        const SPmrXMLEntity &front = Queue.front();
+        entity.DType = front.DType;
+        entity.DNameData.assign(front.DNameData);
+        entity.DAttributes.resize(front.DAttributes.size());
+        for (std::size_t index = 0; index < front.DAttributes.size(); index++) {
+            entity.DAttributes[index].first.assign(front.DAttributes[index].first);
+            entity.DAttributes[index].second.assign(front.DAttributes[index].second);
         }
+        Pop();
+        return true;
+    }
+
+    // moves the front entity out, which only copies when the entity's resource
+    // differs from the reader's
+    bool ReadEntity(SPmrXMLEntity &entity, bool skipcdata) {
+        if (!Fill(skipcdata)) return false;
+        Pop(&entity);
+        return true;
+    }
+
+    // fills the block with up to count entities, starting it afresh
+    std::size_t ReadEntities(TXMLEntityBlock &block, std::size_t count, bool skipcdata) {
+        block.Clear();
+        while (block.Size() < count && ReadEntity(block.Next(), skipcdata)) {
+            block.Commit();
+        }
+        return block.Size();
+    }
 
-        return false;  // return false if no more entities are available
+    SXMLCheckpoint Checkpoint() const {
+        SXMLCheckpoint Result;
+        Result.DOffset = Mark.Offset;
+        Result.DSkip = Mark.Ordinal;
+        Result.DOpenElements.assign(Stack.begin(), Stack.begin() + MarkDepth);
+        return Result;
+    }
+
+    // restarts the parser at the checkpoint's markup, the open elements are fed
+    // first as start tags so the rest of the document stays well formed
+    bool Resume(const SXMLCheckpoint &checkpoint) {
+        if (!Seekable || !Seekable->Seek(checkpoint.DOffset)) {
+            return false;
+        }
+        Queue.clear();
+        Marks.clear();
+        Parser.Reset();
+        Data = false;
+        DrainStart = 0;
+        Start = checkpoint.DOffset;
+        Last = {SIZE_MAX, 0};
+        std::string prefix;
+        for (const auto &name : checkpoint.DOpenElements) {
+            prefix += '<';
+            prefix += name;
+            prefix += '>';
+        }
+        PrefixLength = prefix.size();
+        if (!Parser.Feed(prefix.data(), prefix.size())) {
+            return false;
+        }
+        Stack.assign(checkpoint.DOpenElements.begin(), checkpoint.DOpenElements.end());
+        Depth = MarkDepth = Stack.size();
+        Mark = {checkpoint.DOffset, checkpoint.DSkip};
+        ResumeSkip = checkpoint.DSkip;
+        return true;
     }
 };
 
-// interface for creating an XML reader with a specific data source
-CXMLReader::CXMLReader(std::shared_ptr<CDataSource> src)
-    : DImplementation(std::make_unique<SImplementation>(std::move(src))) {}
+// interface for creating an XML reader with a specific data source, queued
+// entities are allocated from the resource, which must outlive the reader
+CXMLReader::CXMLReader(std::shared_ptr<CDataSource> src, std::pmr::memory_resource *resource)
+    : DImplementation(std::make_unique<SImplementation>(std::move(src), resource ? resource : std::pmr::get_default_resource())) {}
+
+// queued entities and pending character data are allocated from the account,
+// which is kept alive by the reader, an entity that would take the account past
+// its limit fails the read and ends the reader
+CXMLReader::CXMLReader(std::shared_ptr<CDataSource> src, std::shared_ptr<CMemoryAccount> account)
+    : DImplementation(std::make_unique<SImplementation>(std::move(src), account ? account.get() : std::pmr::get_default_resource(), account)) {}
 
 CXMLReader::~CXMLReader() = default; // destructor is straightforward because the unique_ptr takes care of cleanup
 
@@ -121,3 +263,40 @@ bool CXMLReader::ReadEntity(SXMLEntity &entity, bool skipcdata) {
     return DImplementation->ReadEntity(entity, skipcdata);
 }
 
+// reads an entity whose strings come from its own memory resource
+bool CXMLReader::ReadEntity(SPmrXMLEntity &entity, bool skipcdata) {
+    return DImplementation->ReadEntity(entity, skipcdata);
+}
+
+// replaces the block's contents with up to count entities and returns how many
+// were read, entities land in the block's resource
+std::size_t CXMLReader::ReadEntities(TXMLEntityBlock &block, std::size_t count, bool skipcdata) {
+    return DImplementation->ReadEntities(block, count, skipcdata);
+}
+
+// position just past the last entity returned, entities skipped as character
+// data count as returned
+SXMLCheckpoint CXMLReader::Checkpoint() const {
+    return DImplementation->Checkpoint();
+}
+
+// continues from a checkpoint of a reader over the same document, the source
+// must be seekable, returns false if it cannot be positioned
+bool CXMLReader::Resume(const SXMLCheckpoint &checkpoint) {
+    return DImplementation->Resume(checkpoint);
+}
+
+// lazily reads the remaining entities, one entity buffer is reused for every step
+CGenerator<SXMLEntity> CXMLReader::Entities(bool skipcdata) {
+    SXMLEntity entity;
+    while (ReadEntity(entity, skipcdata)) {
+        co_yield entity;
+    }
+}
+
+// counters for this reader, all zero unless built with ENABLE_IOSTATS
+SIOStats CXMLReader::Stats() const {
+    SIOStats Result = DImplementation->Stats.Snapshot();
+    Result.DKind = SIOStats::EKind::XMLReader;
+    return Result;
+}
@@ -1,15 +1,65 @@
 #include "XMLWriter.h"
-#include <stack>
+#include "Trace.h"
+#include <algorithm>
 #include <string>
+#include <vector>
 
 // internal implementation of the CXMLWriter using a stack to manage open XML elements
 struct CXMLWriter::SImplementation {
     std::shared_ptr<CDataSink> Sink;  // destination for XML output
-    std::stack<std::string> Stack;    // stack to manage the tags for proper nesting and closure
+    std::vector<std::string> Stack;   // stack to manage the tags for proper nesting and closure
+    std::vector<char> Buffer;         // output of the current call, handed to the sink in one write
+    CIOStatsCounters Stats{SIOStats::EKind::XMLWriter}; // compiled out unless ENABLE_IOSTATS
+    std::shared_ptr<CMemoryAccount> Account; // charged for the buffer's capacity, may be null
+    std::size_t Charged = 0; // bytes currently charged to the account
 
     // constructor that takes a data sink
-    explicit SImplementation(std::shared_ptr<CDataSink> sink) 
-        : Sink(std::move(sink)) {}
+    explicit SImplementation(std::shared_ptr<CDataSink> sink, std::vector<std::string> openelements = {}, std::shared_ptr<CMemoryAccount> account = nullptr)
+        : Sink(std::move(sink)), Stack(std::move(openelements)), Account(std::move(account)) {}
+
+    ~SImplementation() {
+        if (Account) {
+            Account->Credit(Charged);
+        }
+    }
+
+    // gives back the buffer of an entity the account refused, so a smaller
+    // one can still be written
+    bool Release() {
+        Buffer.clear();
+        Buffer.shrink_to_fit();
+        if (Account) {
+            Account->Resize(Charged, 0);
+        }
+        return false;
+    }
+
+    // appends one character to the output buffer, charging the account before
+    // the buffer grows, growth doubles but stops at the limit
+    bool Put(char c) {
+        if (Account && Buffer.size() == Buffer.capacity()) {
+            std::size_t Capacity = std::max<std::size_t>(Buffer.capacity() * 2, 64);
+            if (Account->Limit()) {
+                Capacity = std::max(std::min(Capacity, Account->Limit()), Buffer.size() + 1);
+            }
+            if (!Account->Resize(Charged, Capacity)) {
+                return false;
+            }
+            Buffer.reserve(Capacity);
+        }
+        Buffer.push_back(c);
+        return true;
+    }
+
+    // passes the buffered output to the sink in one write
+    bool WriteBuffer() {
+        TRACE_SPAN("XMLWriter::SinkWrite");
+        CIOStatsTimer timer;
+        bool result = Sink->Write(Buffer);
+        Stats.AddIOTime(timer.Nanoseconds());
+        Stats.AddBytes(Buffer.size());
+        return result;
+    }
 
     // writes a string to the output possibly escaping XML special characters
     bool WriteText(const std::string &str, bool escape) {
@@ -22,28 +72,52 @@ struct CXMLWriter::SImplementation {
                     case '&':  if (!WriteText("&amp;", false)) return false; break;
                     case '\'': if (!WriteText("&apos;", false)) return false; break;
                     case '"':  if (!WriteText("&quot;", false)) return false; break;
-                    default:   if (!Sink->Put(c)) return false;
+                    default:   if (!Put(c)) return false;
                 }
             } else {
-                if (!Sink->Put(c)) return false;
+                if (!Put(c)) return false;
             }
         }
         return true;
     }
 
-    // closes all open xml elements ensuring proper xml structure before ending the document
+    // closes all open xml elements and writes them out, the elements stay open
+    // if the account refuses room for their end tags
     bool Flush() {
-        while (!Stack.empty()) {
-            if (!WriteText("</" + Stack.top() + ">", false)) {
+        Buffer.clear();
+        if (!CloseAll()) return Release();
+        Stack.clear();
+        return WriteBuffer();
+    }
+
+    // formats an entity into the buffer, writes it and records its size and how long it took
+    bool WriteEntity(const SXMLEntity &entity) {
+        CIOStatsTimer timer;
+        Buffer.clear();
+        // only a refused Put fails, before the open elements change
+        if (!WriteEntityData(entity)) return Release();
+        Stats.AddRecord(Buffer.size());
+        Stats.AddField(entity.DNameData.size(), false);
+        for (const auto &attr : entity.DAttributes) {
+            Stats.AddField(attr.second.size(), false);
+        }
+        Stats.AddProcessTime(timer.Nanoseconds());
+        return WriteBuffer();
+    }
+
+    // writes the end tags of all open xml elements, innermost first, the caller
+    // empties the stack once they are buffered
+    bool CloseAll() {
+        for (auto name = Stack.rbegin(); name != Stack.rend(); name++) {
+            if (!WriteText("</" + *name + ">", false)) {
                 return false;
             }
-            Stack.pop();
         }
         return true;
     }
 
     // writes an xml entity based on its type (tag, data, or self-closing element)
-    bool WriteEntity(const SXMLEntity &entity) {
+    bool WriteEntityData(const SXMLEntity &entity) {
         switch (entity.DType) {
             // handle opening tags
             case SXMLEntity::EType::StartElement:
@@ -57,14 +131,14 @@ struct CXMLWriter::SImplementation {
                 }
 
                 if (!WriteText(">", false)) return false;
-                Stack.push(entity.DNameData);  // remember this tag to close it later
+                Stack.push_back(entity.DNameData);  // remember this tag to close it later
                 break;
 
             // handle closing tags
             case SXMLEntity::EType::EndElement:
                 if (!WriteText("</" + entity.DNameData + ">", false)) return false;
                 if (!Stack.empty()) {
-                    Stack.pop();
+                    Stack.pop_back();
                 }
                 break;
 
@@ -94,6 +168,16 @@ struct CXMLWriter::SImplementation {
 CXMLWriter::CXMLWriter(std::shared_ptr<CDataSink> sink)
     : DImplementation(std::make_unique<SImplementation>(std::move(sink))) {}
 
+// continues a document whose output was cut short, openelements are the tags
+// still open there, outermost first, and Flush will close them
+CXMLWriter::CXMLWriter(std::shared_ptr<CDataSink> sink, std::vector<std::string> openelements)
+    : DImplementation(std::make_unique<SImplementation>(std::move(sink), std::move(openelements))) {}
+
+// the account is charged for the output buffer, an entity that would take it
+// past its limit is not written
+CXMLWriter::CXMLWriter(std::shared_ptr<CDataSink> sink, std::shared_ptr<CMemoryAccount> account)
+    : DImplementation(std::make_unique<SImplementation>(std::move(sink), std::vector<std::string>(), std::move(account))) {}
+
 // destructor ensures resources are cleaned up properly
 CXMLWriter::~CXMLWriter() = default;
 
@@ -107,3 +191,14 @@ bool CXMLWriter::WriteEntity(const SXMLEntity &entity) {
     return DImplementation->WriteEntity(entity);
 }
 
+// tags written but not yet closed, outermost first, to resume the writer from
+std::vector<std::string> CXMLWriter::OpenElements() const {
+    return DImplementation->Stack;
+}
+
+// counters for this writer, all zero unless built with ENABLE_IOSTATS
+SIOStats CXMLWriter::Stats() const {
+    SIOStats Result = DImplementation->Stats.Snapshot();
+    Result.DKind = SIOStats::EKind::XMLWriter;
+    return Result;
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include "AsyncDSVReader.h"
+#include "AsyncXMLReader.h"
+#include "AsyncFDDataSource.h"
+#include "AsyncScheduler.h"
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+CTask<int> Add(int left, int right){
+    co_return left + right;
+}
+
+CTask<int> Sum(int count){
+    int Total = 0;
+    for(int Index = 0; Index < count; Index++){
+        Total += co_await Add(Index, 1);
+    }
+    co_return Total;
+}
+
+CTask<void> Fail(){
+    throw std::runtime_error("task failed");
+    co_return;
+}
+
+// writes data into a new pipe from another thread in small delayed pieces
+// and returns the read end
+int SlowPipe(std::string data, std::size_t piece, std::vector<std::thread> &writers){
+    int FDs[2];
+    if(pipe(FDs) != 0){
+        return -1;
+    }
+    writers.emplace_back([data, piece, fd = FDs[1]]{
+        for(std::size_t Offset = 0; Offset < data.size(); Offset += piece){
+            std::size_t Length = std::min(piece, data.size() - Offset);
+            if(write(fd, data.data() + Offset, Length) != static_cast<ssize_t>(Length)){
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        close(fd);
+    });
+    return FDs[0];
+}
+
+}
+
+TEST(Async, TaskTest){
+    CAsyncScheduler Scheduler;
+    int Result = 0;
+    // the lambda has to outlive its coroutine, which refers to its captures
+    auto Body = [&]() -> CTask<void> {
+        Result = co_await Sum(10000);
+    };
+    Scheduler.Spawn(Body());
+    EXPECT_EQ(Scheduler.TaskCount(), 1);
+    EXPECT_EQ(CAsyncScheduler::Current(), nullptr);
+    Scheduler.Run();
+    EXPECT_EQ(Result, 50005000);
+    EXPECT_EQ(Scheduler.TaskCount(), 0);
+
+    Scheduler.Spawn(Fail());
+    EXPECT_THROW(Scheduler.Run(), std::runtime_error);
+}
+
+TEST(Async, PostTest){
+    CAsyncScheduler Scheduler;
+    bool Ran = false;
+    std::thread Other([&]{
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        Scheduler.Post([&]{ Ran = true; });
+    });
+    Scheduler.Post([&]{ EXPECT_EQ(CAsyncScheduler::Current(), &Scheduler); });
+    Scheduler.Run();
+    Other.join();
+    Scheduler.Run();
+    EXPECT_TRUE(Ran);
+}
+
+TEST(Async, ManyDSVStreamsTest){
+    const std::size_t Streams = 64;
+    std::string Data;
+    for(int Index = 0; Index < 50; Index++){
+        Data += std::to_string(Index) + ",\"quoted,\r\nfield\",x\r\n";
+    }
+    CAsyncScheduler Scheduler;
+    std::vector<std::thread> Writers;
+    std::vector<std::size_t> Counts(Streams, 0);
+    std::vector<bool> Matched(Streams, true);
+    for(std::size_t Stream = 0; Stream < Streams; Stream++){
+        auto Source = std::make_shared<CAsyncFDDataSource>(SlowPipe(Data, 97, Writers));
+        Scheduler.Spawn([](std::shared_ptr<CAsyncFDDataSource> source, std::size_t &count, std::vector<bool>::reference matched) -> CTask<void> {
+            CAsyncDSVReader Reader(source, ',', 64);
+            std::vector<std::string> Row;
+            while(co_await Reader.ReadRow(Row)){
+                if(Row != std::vector<std::string>({std::to_string(count), "quoted,\r\nfield", "x"})){
+                    matched = false;
+                }
+                count++;
+            }
+            if(!Reader.End()){
+                matched = false;
+            }
+        }(Source, Counts[Stream], Matched[Stream]));
+    }
+    Scheduler.Run();
+    for(auto &Writer : Writers){
+        Writer.join();
+    }
+    for(std::size_t Stream = 0; Stream < Streams; Stream++){
+        EXPECT_EQ(Counts[Stream], 50);
+        EXPECT_TRUE(Matched[Stream]);
+    }
+}
+
+TEST(Async, XMLStreamTest){
+    CAsyncScheduler Scheduler;
+    std::vector<std::thread> Writers;
+    auto Source = std::make_shared<CAsyncFDDataSource>(SlowPipe("<a x=\"1\">text<b/><c>more</c></a>", 5, Writers));
+    std::vector<std::string> Names;
+    bool Ended = false;
+    auto Body = [&]() -> CTask<void> {
+        CAsyncXMLReader Reader(Source, 3);
+        SXMLEntity Entity;
+        while(co_await Reader.ReadEntity(Entity, true)){
+            Names.push_back(Entity.DNameData);
+        }
+        Ended = Reader.End();
+    };
+    Scheduler.Spawn(Body());
+    Scheduler.Run();
+    Writers[0].join();
+    EXPECT_EQ(Names, std::vector<std::string>({"a", "b", "b", "c", "c", "a"}));
+    EXPECT_TRUE(Ended);
+}
+
+TEST(Async, NoSchedulerTest){
+    int FDs[2];
+    ASSERT_EQ(pipe(FDs), 0);
+    CAsyncFDDataSource Source(FDs[0]);
+    std::vector<char> Buffer;
+    EXPECT_EQ(Source.ReadSome(Buffer, 16), CAsyncDataSource::EStatus::Pending);
+    EXPECT_FALSE(Source.Wait([]{}));
+    ASSERT_EQ(write(FDs[1], "ab", 2), 2);
+    EXPECT_EQ(Source.ReadSome(Buffer, 16), CAsyncDataSource::EStatus::Data);
+    EXPECT_EQ(std::string(Buffer.begin(), Buffer.end()), "ab");
+    close(FDs[1]);
+    EXPECT_EQ(Source.ReadSome(Buffer, 16), CAsyncDataSource::EStatus::End);
+}
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include "Checkpoint.h"
+#include "DSVReader.h"
+#include "XMLReader.h"
+#include "XMLWriter.h"
+#include "FileDataSink.h"
+#include "FileDataSource.h"
+#include "StringDataSink.h"
+#include "StringDataSource.h"
+#include "TestScratch.h"
+#include <cstdio>
+
+namespace {
+
+std::string Describe(const SXMLEntity &entity){
+    std::string Result = std::to_string(static_cast<int>(entity.DType)) + ":" + entity.DNameData;
+    for(const auto &Attribute : entity.DAttributes){
+        Result += " " + Attribute.first + "=" + Attribute.second;
+    }
+    return Result;
+}
+
+std::vector<std::string> ReadAll(CXMLReader &reader, bool skipcdata = false){
+    std::vector<std::string> Result;
+    SXMLEntity Entity;
+    while(reader.ReadEntity(Entity, skipcdata)){
+        Result.push_back(Describe(Entity));
+    }
+    return Result;
+}
+
+const std::string Document = "<?xml version=\"1.0\"?>\n<root a=\"1\"><item id=\"x\">text &amp; more</item><empty/>"
+                             "<![CDATA[raw <b>]]><n k=\"v\"><m/>tail<o></o></n>\n</root>";
+
+}
+
+TEST(Checkpoint, SerializeTest){
+    SDSVCheckpoint DSV{120, 7}, DSVParsed;
+    EXPECT_EQ(DSV.Serialize(), "DSV 120 7");
+    ASSERT_TRUE(SDSVCheckpoint::Parse(DSV.Serialize(), DSVParsed));
+    EXPECT_EQ(DSVParsed.DOffset, 120);
+    EXPECT_EQ(DSVParsed.DRow, 7);
+    EXPECT_FALSE(SDSVCheckpoint::Parse("XML 1 2", DSVParsed));
+    EXPECT_FALSE(SDSVCheckpoint::Parse("DSV 1", DSVParsed));
+
+    SXMLCheckpoint XML{42, 1, {"root", "n"}}, XMLParsed;
+    EXPECT_EQ(XML.Serialize(), "XML 42 1 root n");
+    ASSERT_TRUE(SXMLCheckpoint::Parse(XML.Serialize(), XMLParsed));
+    EXPECT_EQ(XMLParsed.DOffset, 42);
+    EXPECT_EQ(XMLParsed.DSkip, 1);
+    EXPECT_EQ(XMLParsed.DOpenElements, XML.DOpenElements);
+    EXPECT_FALSE(SXMLCheckpoint::Parse("DSV 1 2", XMLParsed));
+}
+
+TEST(Checkpoint, DSVResumeTest){
+    std::string Input = "a,b\n\"1\n2\",3\n4,5\n6,7\n";
+    CDSVReader Reader(std::make_shared<CStringDataSource>(Input), ',');
+    std::vector<std::string> Row;
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    std::string Saved = Reader.Checkpoint().Serialize();
+    ASSERT_TRUE(Reader.ReadRow(Row));
+
+    SDSVCheckpoint Checkpoint;
+    ASSERT_TRUE(SDSVCheckpoint::Parse(Saved, Checkpoint));
+    CDSVReader Resumed(std::make_shared<CStringDataSource>(Input), ',');
+    ASSERT_TRUE(Resumed.Resume(Checkpoint));
+    EXPECT_EQ(Resumed.Row(), 2);
+    ASSERT_TRUE(Resumed.ReadRow(Row));
+    EXPECT_EQ(Row, (std::vector<std::string>{"4", "5"}));
+    ASSERT_TRUE(Resumed.ReadRow(Row));
+    EXPECT_EQ(Row, (std::vector<std::string>{"6", "7"}));
+    EXPECT_FALSE(Resumed.ReadRow(Row));
+}
+
+TEST(Checkpoint, XMLResumeTest){
+    CXMLReader Full(std::make_shared<CStringDataSource>(Document));
+    std::vector<std::string> Expected = ReadAll(Full);
+    ASSERT_FALSE(Expected.empty());
+
+    // a checkpoint after every entity, including both halves of an empty element
+    for(std::size_t Count = 0; Count <= Expected.size(); Count++){
+        CXMLReader Reader(std::make_shared<CStringDataSource>(Document));
+        SXMLEntity Entity;
+        for(std::size_t Index = 0; Index < Count; Index++){
+            ASSERT_TRUE(Reader.ReadEntity(Entity));
+        }
+        SXMLCheckpoint Checkpoint;
+        ASSERT_TRUE(SXMLCheckpoint::Parse(Reader.Checkpoint().Serialize(), Checkpoint));
+
+        CXMLReader Resumed(std::make_shared<CStringDataSource>(Document));
+        ASSERT_TRUE(Resumed.Resume(Checkpoint)) << Count;
+        std::vector<std::string> Rest = ReadAll(Resumed);
+        EXPECT_EQ(Rest, std::vector<std::string>(Expected.begin() + Count, Expected.end())) << Count;
+
+        // the reader that took the checkpoint can also go back to it
+        ReadAll(Reader);
+        ASSERT_TRUE(Reader.Resume(Checkpoint));
+        EXPECT_EQ(ReadAll(Reader), Rest) << Count;
+    }
+}
+
+TEST(Checkpoint, XMLResumeSkipCDataTest){
+    CXMLReader Full(std::make_shared<CStringDataSource>(Document));
+    std::vector<std::string> Expected = ReadAll(Full, true);
+    for(std::size_t Count = 0; Count <= Expected.size(); Count++){
+        CXMLReader Reader(std::make_shared<CStringDataSource>(Document));
+        SXMLEntity Entity;
+        for(std::size_t Index = 0; Index < Count; Index++){
+            ASSERT_TRUE(Reader.ReadEntity(Entity, true));
+        }
+        CXMLReader Resumed(std::make_shared<CStringDataSource>(Document));
+        ASSERT_TRUE(Resumed.Resume(Reader.Checkpoint()));
+        EXPECT_EQ(ReadAll(Resumed, true), std::vector<std::string>(Expected.begin() + Count, Expected.end())) << Count;
+    }
+}
+
+TEST(Checkpoint, FileDataSinkResumeTest){
+    CScratch Scratch;
+    std::string Path = Scratch.Write("sink.txt", "");
+    std::size_t Offset;
+    {
+        CFileDataSink Sink(Path, 4);
+        ASSERT_TRUE(Sink.Write({'a', 'b', 'c'}));
+        Offset = Sink.Offset();
+        EXPECT_EQ(Offset, 3);
+        // output past the checkpoint, lost when resuming
+        ASSERT_TRUE(Sink.Write({'x', 'y', 'z'}));
+        EXPECT_EQ(Sink.Offset(), 6);
+    }
+    {
+        auto Sink = CFileDataSink::Resume(Path, Offset, 4);
+        ASSERT_TRUE(Sink->IsOpen());
+        EXPECT_EQ(Sink->Offset(), 3);
+        ASSERT_TRUE(Sink->Put('d'));
+        EXPECT_EQ(Sink->Offset(), 4);
+    }
+    CFileDataSource Source(Path);
+    std::vector<char> Buffer;
+    ASSERT_TRUE(Source.Read(Buffer, 100));
+    EXPECT_EQ(std::string(Buffer.begin(), Buffer.end()), "abcd");
+
+    EXPECT_FALSE(CFileDataSink::Resume(Path, 100, 4)->IsOpen());
+    // the default buffer size does not turn the offset into one
+    {
+        auto Sink = CFileDataSink::Resume(Path, 2);
+        ASSERT_TRUE(Sink->IsOpen());
+        EXPECT_EQ(Sink->Offset(), 2);
+    }
+    ASSERT_TRUE(Source.Seek(0));
+    ASSERT_TRUE(Source.Read(Buffer, 100));
+    EXPECT_EQ(std::string(Buffer.begin(), Buffer.end()), "ab");
+    std::remove(Path.c_str());
+    EXPECT_FALSE(CFileDataSink::Resume(Path, 0, 4)->IsOpen());
+}
+
+TEST(Checkpoint, XMLWriterResumeTest){
+    auto First = std::make_shared<CStringDataSink>();
+    CXMLWriter Writer(First);
+    ASSERT_TRUE(Writer.WriteEntity({SXMLEntity::EType::StartElement, "root"}));
+    ASSERT_TRUE(Writer.WriteEntity({SXMLEntity::EType::StartElement, "n"}));
+    std::vector<std::string> Open = Writer.OpenElements();
+    EXPECT_EQ(Open, (std::vector<std::string>{"root", "n"}));
+
+    auto Second = std::make_shared<CStringDataSink>();
+    CXMLWriter Resumed(Second, Open);
+    ASSERT_TRUE(Resumed.WriteEntity({SXMLEntity::EType::CharData, "x"}));
+    ASSERT_TRUE(Resumed.WriteEntity({SXMLEntity::EType::EndElement, "n"}));
+    EXPECT_EQ(Resumed.OpenElements(), (std::vector<std::string>{"root"}));
+    ASSERT_TRUE(Resumed.Flush());
+    EXPECT_EQ(First->String() + Second->String(), "<root><n>x</n></root>");
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "DSVDeduplicator.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+#include <set>
+
+namespace {
+
+std::vector<std::vector<std::string>> RunDeduplicate(CDSVDeduplicator &deduplicator, const std::string &data){
+    CDSVReader Reader(std::make_shared<CStringDataSource>(data), ',');
+    auto Sink = std::make_shared<CStringDataSink>();
+    CDSVWriter Writer(Sink, ',');
+    EXPECT_TRUE(deduplicator.Deduplicate(Reader, Writer));
+    CDSVReader Output(std::make_shared<CStringDataSource>(Sink->String()), ',');
+    std::vector<std::vector<std::string>> Rows;
+    std::vector<std::string> Row;
+    while(Output.ReadRow(Row)){
+        Rows.push_back(Row);
+    }
+    return Rows;
+}
+
+}
+
+TEST(DSVDeduplicator, FirstRowKeptTest){
+    CDSVDeduplicator Deduplicator({0, 2});
+    auto Rows = RunDeduplicate(Deduplicator, "a,1,x\nb,2,x\na,3,x\na,4,y\nb,5,x\n\"a,\",6,x\n");
+    EXPECT_FALSE(Deduplicator.Spilled());
+    EXPECT_EQ(Deduplicator.Duplicates(), 2);
+    EXPECT_EQ(Rows, (std::vector<std::vector<std::string>>{{"a", "1", "x"}, {"b", "2", "x"}, {"a", "4", "y"}, {"a,", "6", "x"}}));
+}
+
+TEST(DSVDeduplicator, SpilledMatchesInMemoryTest){
+    std::string Data;
+    std::set<std::string> Keys;
+    std::size_t Duplicates = 0;
+    for(int Index = 0; Index < 40000; Index++){
+        std::string Key = "key" + std::to_string((Index * 7919) % 9000);
+        Duplicates += !Keys.insert(Key).second;
+        Data += std::to_string(Index) + "," + Key + "\n";
+    }
+    CDSVDeduplicator Deduplicator({1}, 16 << 10);
+    auto Rows = RunDeduplicate(Deduplicator, Data);
+    EXPECT_TRUE(Deduplicator.Spilled());
+    EXPECT_EQ(Deduplicator.Duplicates(), Duplicates);
+    ASSERT_EQ(Rows.size(), Keys.size());
+    // keys repeat every 9000 rows, so each key's first row is among the first 9000
+    std::set<std::string> Seen;
+    for(auto &Row : Rows){
+        EXPECT_TRUE(Seen.insert(Row[1]).second);
+        EXPECT_LT(std::stoi(Row[0]), 9000);
+    }
+}
+
+TEST(DSVDeduplicator, OversizedPartitionsSplitAgainTest){
+    // far more keys than the budget holds, so the first partitions spill again
+    std::string Data;
+    std::set<std::string> Keys;
+    std::size_t Duplicates = 0;
+    for(int Index = 0; Index < 40000; Index++){
+        std::string Key = "key" + std::to_string((Index * 7919) % 30000);
+        Duplicates += !Keys.insert(Key).second;
+        Data += std::to_string(Index) + "," + Key + "\n";
+    }
+    CDSVDeduplicator Deduplicator({1}, 2 << 10);
+    auto Rows = RunDeduplicate(Deduplicator, Data);
+    EXPECT_TRUE(Deduplicator.Spilled());
+    EXPECT_EQ(Deduplicator.Duplicates(), Duplicates);
+    ASSERT_EQ(Rows.size(), Keys.size());
+    std::set<std::string> Seen;
+    for(auto &Row : Rows){
+        EXPECT_TRUE(Seen.insert(Row[1]).second);
+        EXPECT_LT(std::stoi(Row[0]), 30000);
+    }
+}
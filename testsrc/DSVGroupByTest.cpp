@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "DSVGroupBy.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+#include <algorithm>
+#include <map>
+
+namespace {
+
+using EFunction = CDSVGroupBy::SAggregate::EFunction;
+
+std::vector<std::vector<std::string>> RunGroupBy(CDSVGroupBy &groupby, const std::string &data){
+    CDSVReader Reader(std::make_shared<CStringDataSource>(data), ',');
+    auto Sink = std::make_shared<CStringDataSink>();
+    CDSVWriter Writer(Sink, ',');
+    EXPECT_TRUE(groupby.Aggregate(Reader, Writer));
+    CDSVReader Output(std::make_shared<CStringDataSource>(Sink->String()), ',');
+    std::vector<std::vector<std::string>> Rows;
+    std::vector<std::string> Row;
+    while(Output.ReadRow(Row)){
+        Rows.push_back(Row);
+    }
+    std::sort(Rows.begin(), Rows.end());
+    return Rows;
+}
+
+}
+
+TEST(DSVGroupBy, Aggregates){
+    CDSVGroupBy GroupBy({0}, {{EFunction::Count}, {EFunction::Sum, 1}, {EFunction::Min, 1}, {EFunction::Max, 1}});
+    auto Rows = RunGroupBy(GroupBy, "a,1\nb,5\na,2.5\n\"x,\"\"y\"\"\",7\na,oops\nb,-3\nc,\n");
+
+    EXPECT_FALSE(GroupBy.Spilled());
+    ASSERT_EQ(Rows.size(), 4);
+    EXPECT_EQ(Rows[0], (std::vector<std::string>{"a", "3", "3.5", "1", "2.5"}));
+    EXPECT_EQ(Rows[1], (std::vector<std::string>{"b", "2", "2", "-3", "5"}));
+    EXPECT_EQ(Rows[2], (std::vector<std::string>{"c", "1", "", "", ""}));
+    EXPECT_EQ(Rows[3], (std::vector<std::string>{"x,\"y\"", "1", "7", "7", "7"}));
+}
+
+TEST(DSVGroupBy, SpilledMatchesInMemory){
+    std::string Data;
+    std::map<std::string, std::pair<long, long>> Expected;
+    for(int Index = 0; Index < 50000; Index++){
+        std::string Key = "key" + std::to_string((Index * 7919) % 3000);
+        Data += Key + "," + std::to_string(Index) + "\n";
+        Expected[Key].first++;
+        Expected[Key].second += Index;
+    }
+    CDSVGroupBy GroupBy({0}, {{EFunction::Count}, {EFunction::Sum, 1}}, 32 << 10);
+    auto Rows = RunGroupBy(GroupBy, Data);
+
+    EXPECT_TRUE(GroupBy.Spilled());
+    ASSERT_EQ(Rows.size(), Expected.size());
+    for(auto &Row : Rows){
+        EXPECT_EQ(std::stol(Row[1]), Expected[Row[0]].first);
+        EXPECT_EQ(std::stol(Row[2]), Expected[Row[0]].second);
+    }
+}
+
+TEST(DSVGroupBy, OversizedPartitionsSplitAgain){
+    // each of the first partitions holds far more keys than the budget allows
+    std::string Data;
+    std::map<std::string, std::pair<long, long>> Expected;
+    for(int Index = 0; Index < 40000; Index++){
+        std::string Key = "key" + std::to_string((Index * 7919) % 8000);
+        Data += Key + "," + std::to_string(Index) + "\n";
+        Expected[Key].first++;
+        Expected[Key].second += Index;
+    }
+    CDSVGroupBy GroupBy({0}, {{EFunction::Count}, {EFunction::Sum, 1}}, 4 << 10);
+    auto Rows = RunGroupBy(GroupBy, Data);
+
+    EXPECT_TRUE(GroupBy.Spilled());
+    ASSERT_EQ(Rows.size(), Expected.size());
+    for(auto &Row : Rows){
+        EXPECT_EQ(std::stol(Row[1]), Expected[Row[0]].first);
+        EXPECT_EQ(std::stol(Row[2]), Expected[Row[0]].second);
+    }
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include "DSVHashJoin.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+#include <algorithm>
+
+namespace {
+
+using EType = CDSVHashJoin::EType;
+
+std::vector<std::vector<std::string>> RunJoin(CDSVHashJoin &join, const std::string &build, const std::string &probe, bool sorted = true){
+    CDSVReader BuildReader(std::make_shared<CStringDataSource>(build), ',');
+    CDSVReader ProbeReader(std::make_shared<CStringDataSource>(probe), ',');
+    auto Sink = std::make_shared<CStringDataSink>();
+    CDSVWriter Writer(Sink, ',');
+    EXPECT_TRUE(join.Join(BuildReader, ProbeReader, Writer));
+    CDSVReader Output(std::make_shared<CStringDataSource>(Sink->String()), ',');
+    std::vector<std::vector<std::string>> Rows;
+    std::vector<std::string> Row;
+    while(Output.ReadRow(Row)){
+        Rows.push_back(Row);
+    }
+    if(sorted){
+        std::sort(Rows.begin(), Rows.end());
+    }
+    return Rows;
+}
+
+const std::string Build = "1,red,r\n2,green,g\n1,crimson,c\n4,blue\n";
+const std::string Probe = "a,1\nb,2\nc,3\nd,4\n";
+
+}
+
+TEST(DSVHashJoin, TypesTest){
+    CDSVHashJoin Inner({0}, {1});
+    EXPECT_EQ(RunJoin(Inner, Build, Probe, false), (std::vector<std::vector<std::string>>{
+        {"a", "1", "red", "r"}, {"a", "1", "crimson", "c"}, {"b", "2", "green", "g"}, {"d", "4", "blue"}
+    }));
+    EXPECT_FALSE(Inner.Spilled());
+
+    CDSVHashJoin Left({0}, {1}, EType::Left);
+    EXPECT_EQ(RunJoin(Left, Build, Probe, false), (std::vector<std::vector<std::string>>{
+        {"a", "1", "red", "r"}, {"a", "1", "crimson", "c"}, {"b", "2", "green", "g"}, {"c", "3", "", ""}, {"d", "4", "blue"}
+    }));
+
+    CDSVHashJoin Semi({0}, {1}, EType::Semi);
+    EXPECT_EQ(RunJoin(Semi, Build, Probe, false), (std::vector<std::vector<std::string>>{{"a", "1"}, {"b", "2"}, {"d", "4"}}));
+
+    CDSVHashJoin Anti({0}, {1}, EType::Anti);
+    EXPECT_EQ(RunJoin(Anti, Build, Probe, false), (std::vector<std::vector<std::string>>{{"c", "3"}}));
+}
+
+TEST(DSVHashJoin, CompositeKeyTest){
+    CDSVHashJoin Join({2, 0}, {0, 1});
+    EXPECT_EQ(RunJoin(Join, "x,v1,1\ny,v2,1\nx,v3,2\n", "1,x\n1,y\n2,y\n"), (std::vector<std::vector<std::string>>{
+        {"1", "x", "v1"}, {"1", "y", "v2"}
+    }));
+}
+
+TEST(DSVHashJoin, KeyCountMismatchTest){
+    for(auto Keys : {std::vector<std::size_t>{0, 1}, std::vector<std::size_t>{}}){
+        CDSVHashJoin Join({0}, Keys);
+        CDSVReader BuildReader(std::make_shared<CStringDataSource>(Build), ',');
+        CDSVReader ProbeReader(std::make_shared<CStringDataSource>(Probe), ',');
+        auto Sink = std::make_shared<CStringDataSink>();
+        CDSVWriter Writer(Sink, ',');
+        EXPECT_FALSE(Join.Join(BuildReader, ProbeReader, Writer));
+        EXPECT_TRUE(Sink->String().empty());
+    }
+}
+
+TEST(DSVHashJoin, SpilledMatchesInMemoryTest){
+    std::string BuildData, ProbeData;
+    for(int Index = 0; Index < 6000; Index++){
+        BuildData += "k" + std::to_string(Index) + ",name" + std::to_string(Index) + "\n";
+    }
+    for(int Index = 0; Index < 20000; Index++){
+        ProbeData += std::to_string(Index) + ",k" + std::to_string((Index * 7919) % 8000) + "\n";
+    }
+    for(auto Type : {EType::Inner, EType::Left, EType::Semi, EType::Anti}){
+        CDSVHashJoin InMemory({0}, {1}, Type);
+        auto Expected = RunJoin(InMemory, BuildData, ProbeData);
+        EXPECT_FALSE(InMemory.Spilled());
+        EXPECT_FALSE(Expected.empty());
+        for(bool Parallel : {false, true}){
+            CDSVHashJoin Spilling({0}, {1}, Type, 16 << 10, "", Parallel);
+            EXPECT_EQ(RunJoin(Spilling, BuildData, ProbeData), Expected);
+            EXPECT_TRUE(Spilling.Spilled());
+
+            CDSVHashJoin Probing({0}, {1}, Type, 64 << 20, "", Parallel);
+            // probing in parallel keeps the probe order
+            CDSVHashJoin Ordered({0}, {1}, Type);
+            EXPECT_EQ(RunJoin(Probing, BuildData, ProbeData, false), RunJoin(Ordered, BuildData, ProbeData, false));
+        }
+    }
+}
+
+TEST(DSVHashJoin, OversizedPartitionsTest){
+    // the budget holds a fraction of one partition, so partitions are split again
+    std::string BuildData, ProbeData;
+    for(int Index = 0; Index < 6000; Index++){
+        BuildData += "k" + std::to_string(Index) + ",name" + std::to_string(Index) + "\n";
+    }
+    for(int Index = 0; Index < 20000; Index++){
+        ProbeData += std::to_string(Index) + ",k" + std::to_string((Index * 7919) % 8000) + "\n";
+    }
+    for(auto Type : {EType::Inner, EType::Left, EType::Semi, EType::Anti}){
+        CDSVHashJoin InMemory({0}, {1}, Type);
+        auto Expected = RunJoin(InMemory, BuildData, ProbeData);
+        CDSVHashJoin Spilling({0}, {1}, Type, 1 << 10, "", Type == EType::Inner);
+        EXPECT_EQ(RunJoin(Spilling, BuildData, ProbeData), Expected);
+        EXPECT_TRUE(Spilling.Spilled());
+    }
+}
+
+TEST(DSVHashJoin, CommonKeyTest){
+    // the rows of one key never fit the budget and cannot be split by hash
+    std::string BuildData, ProbeData;
+    for(int Index = 0; Index < 3000; Index++){
+        BuildData += (Index % 3 ? "hot" : "k" + std::to_string(Index)) + ",v" + std::to_string(Index) + "\n";
+    }
+    for(int Index = 0; Index < 500; Index++){
+        ProbeData += std::to_string(Index) + "," + (Index % 50 ? "k" + std::to_string(Index * 2) : std::string("hot")) + "\n";
+    }
+    for(auto Type : {EType::Inner, EType::Left, EType::Semi, EType::Anti}){
+        CDSVHashJoin InMemory({0}, {1}, Type);
+        auto Expected = RunJoin(InMemory, BuildData, ProbeData);
+        EXPECT_FALSE(Expected.empty());
+        CDSVHashJoin Spilling({0}, {1}, Type, 16 << 10);
+        EXPECT_EQ(RunJoin(Spilling, BuildData, ProbeData), Expected);
+        EXPECT_TRUE(Spilling.Spilled());
+    }
+}
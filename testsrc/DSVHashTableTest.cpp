@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include "DSVHashTable.h"
+#include <algorithm>
+
+TEST(DSVHashTable, InsertFindTest){
+    CDSVHashTable Table({1});
+    Table.Insert({"x", "a", "1"});
+    Table.Insert({"y", "b", "2"});
+    Table.Insert({"z", "a", "3", "extra"});
+    Table.Insert({"w"});
+    EXPECT_EQ(Table.Size(), 3);
+    EXPECT_EQ(Table.Rows(), 4);
+    EXPECT_EQ(Table.Width(), 3);
+
+    // rows with equal keys come back in insertion order
+    std::vector<std::vector<std::string>> Found;
+    for(auto Row = Table.Find({"a"}, {0}); Row != CDSVHashTable::NoRow; Row = Table.NextRow(Row)){
+        Found.emplace_back();
+        Table.AppendPayload(Row, Found.back());
+    }
+    EXPECT_EQ(Found, (std::vector<std::vector<std::string>>{{"x", "1"}, {"z", "3", "extra"}}));
+    // a missing key column is an empty key
+    auto Row = Table.Find({"", "unused"}, {0});
+    ASSERT_NE(Row, CDSVHashTable::NoRow);
+    std::vector<std::string> Payload;
+    Table.AppendPayload(Row, Payload);
+    EXPECT_EQ(Payload, std::vector<std::string>{"w"});
+    EXPECT_EQ(Table.Find({"c"}, {0}), CDSVHashTable::NoRow);
+    EXPECT_TRUE(Table.Contains({"q", "b"}, {1}));
+    // a key list of another length never matches
+    EXPECT_EQ(Table.Find({"a", "1"}, {0, 1}), CDSVHashTable::NoRow);
+    EXPECT_FALSE(Table.Contains({"a"}, {}));
+
+    Table.Clear();
+    EXPECT_EQ(Table.Size(), 0);
+    EXPECT_EQ(Table.Bytes(), 0);
+    EXPECT_EQ(Table.Find({"a"}, {0}), CDSVHashTable::NoRow);
+}
+
+TEST(DSVHashTable, GrowTest){
+    CDSVHashTable Table({0, 1});
+    for(int Index = 0; Index < 20000; Index++){
+        EXPECT_TRUE(Table.InsertKey({std::to_string(Index % 100), std::to_string(Index / 100)}));
+    }
+    // the same fields split across the two columns differently are other keys
+    EXPECT_TRUE(Table.InsertKey({"1", "x23"}));
+    EXPECT_TRUE(Table.InsertKey({"1x", "23"}));
+    EXPECT_FALSE(Table.InsertKey({"1x", "23", "ignored"}));
+    EXPECT_EQ(Table.Size(), 20002);
+    for(int Index = 0; Index < 20000; Index += 997){
+        EXPECT_TRUE(Table.Contains({std::to_string(Index / 100), std::to_string(Index % 100)}, {1, 0}));
+    }
+    EXPECT_FALSE(Table.Contains({"100", "0"}, {0, 1}));
+}
+
+TEST(DSVHashTable, ExportTest){
+    CDSVHashTable Table({2, 0});
+    Table.Insert({"k0", "p", "k2", "q"});
+    Table.Insert({"k0", "r", "k2"});
+    Table.InsertKey({"m0", "x", "m2"});
+    std::vector<std::vector<std::string>> Rows;
+    EXPECT_TRUE(Table.Export([&](const std::vector<std::string> &row){
+        Rows.push_back(row);
+        return true;
+    }));
+    std::sort(Rows.begin(), Rows.end());
+    EXPECT_EQ(Rows, (std::vector<std::vector<std::string>>{{"k2", "k0", "p", "q"}, {"k2", "k0", "r"}, {"m2", "m0"}}));
+    EXPECT_FALSE(Table.Export([](const std::vector<std::string> &){ return false; }));
+}
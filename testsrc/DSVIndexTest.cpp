@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "DSVIndex.h"
+#include "DSVReader.h"
+#include "FileDataSource.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+#include "TestScratch.h"
+
+namespace {
+
+// rows with embedded delimiters, quotes, newlines and mixed line endings
+std::string IndexTestData(){
+    std::string Data;
+    for(int Index = 0; Index < 500; Index++){
+        switch(Index % 5){
+            case 0: Data += std::to_string(Index) + ",plain\n"; break;
+            case 1: Data += std::to_string(Index) + ",\"multi\nline\"\r\n"; break;
+            case 2: Data += std::to_string(Index) + ",\"say \"\"hi\"\"\"\r"; break;
+            case 3: Data += "\n"; break;
+            case 4: Data += std::to_string(Index) + ",\"a,b\"\n"; break;
+        }
+    }
+    return Data + "last,row";
+}
+
+std::vector<std::vector<std::string>> ReadAll(std::shared_ptr<CDataSource> src){
+    CDSVReader Reader(src, ',');
+    std::vector<std::vector<std::string>> Rows;
+    std::vector<std::string> Row;
+    while(Reader.ReadRow(Row)){
+        Rows.push_back(Row);
+    }
+    return Rows;
+}
+
+}
+
+TEST(DSVIndex, RowCountMatchesReader){
+    std::string Data = IndexTestData();
+    CDSVIndex Index(7);
+
+    ASSERT_TRUE(Index.Build(std::make_shared<CStringDataSource>(Data)));
+    EXPECT_EQ(Index.RowCount(), ReadAll(std::make_shared<CStringDataSource>(Data)).size());
+    EXPECT_EQ(Index.EndOffset(), Data.size());
+}
+
+TEST(DSVIndex, SeekEveryRow){
+    std::string Data = IndexTestData();
+    auto Rows = ReadAll(std::make_shared<CStringDataSource>(Data));
+    auto Index = std::make_shared<CDSVIndex>(7);
+    ASSERT_TRUE(Index->Build(std::make_shared<CStringDataSource>(Data)));
+
+    CDSVReader Reader(std::make_shared<CStringDataSource>(Data), ',', Index);
+    std::vector<std::string> Row;
+    for(size_t Target = Rows.size(); Target-- > 0;){
+        ASSERT_TRUE(Reader.SeekRow(Target));
+        EXPECT_EQ(Reader.Row(), Target);
+        ASSERT_TRUE(Reader.ReadRow(Row));
+        EXPECT_EQ(Row, Rows[Target]);
+    }
+    EXPECT_TRUE(Reader.SeekRow(Rows.size()));
+    EXPECT_FALSE(Reader.ReadRow(Row));
+    EXPECT_FALSE(Reader.SeekRow(Rows.size() + 1));
+}
+
+TEST(DSVIndex, SeekWithoutIndex){
+    CDSVReader Reader(std::make_shared<CStringDataSource>("a\nb\nc\n"), ',');
+    std::vector<std::string> Row;
+
+    ASSERT_TRUE(Reader.SeekRow(2));
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector<std::string>{"c"});
+    ASSERT_TRUE(Reader.SeekRow(0));
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector<std::string>{"a"});
+    EXPECT_EQ(Reader.Offset(), 2);
+}
+
+TEST(DSVIndex, SeekWithoutIndexFromOffset){
+    // rows count from where the source stood when the reader was made
+    auto Source = std::make_shared<CStringDataSource>("skip\na\nb\nc\n");
+    ASSERT_TRUE(Source->Seek(5));
+    CDSVReader Reader(Source, ',');
+    std::vector<std::string> Row;
+
+    ASSERT_TRUE(Reader.SeekRow(1));
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector<std::string>{"b"});
+    ASSERT_TRUE(Reader.SeekRow(0));
+    EXPECT_EQ(Reader.Offset(), 5);
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector<std::string>{"a"});
+}
+
+TEST(DSVIndex, SaveLoad){
+    CDSVIndex Index(3), Loaded;
+    auto Sink = std::make_shared<CStringDataSink>();
+
+    ASSERT_TRUE(Index.Build(std::make_shared<CStringDataSource>(IndexTestData())));
+    ASSERT_TRUE(Index.Save(Sink));
+    ASSERT_TRUE(Loaded.Load(std::make_shared<CStringDataSource>(Sink->String())));
+    EXPECT_EQ(Loaded.Stride(), 3);
+    EXPECT_EQ(Loaded.RowCount(), Index.RowCount());
+    EXPECT_EQ(Loaded.EndOffset(), Index.EndOffset());
+    size_t Offset1, Skip1, Offset2, Skip2;
+    for(size_t Row = 0; Row <= Index.RowCount(); Row++){
+        ASSERT_TRUE(Index.Locate(Row, Offset1, Skip1));
+        ASSERT_TRUE(Loaded.Locate(Row, Offset2, Skip2));
+        EXPECT_EQ(Offset1, Offset2);
+        EXPECT_EQ(Skip1, Skip2);
+    }
+    EXPECT_FALSE(Loaded.Load(std::make_shared<CStringDataSource>("junk")));
+}
+
+TEST(DSVIndex, SplitsCoverRows){
+    std::string Data = IndexTestData();
+    auto Rows = ReadAll(std::make_shared<CStringDataSource>(Data));
+    auto Index = std::make_shared<CDSVIndex>(4);
+    ASSERT_TRUE(Index->Build(std::make_shared<CStringDataSource>(Data)));
+
+    auto Splits = Index->Splits(4);
+    ASSERT_EQ(Splits.size(), 5);
+    size_t Total = 0;
+    for(size_t Part = 0; Part + 1 < Splits.size(); Part++){
+        CDSVReader Reader(std::make_shared<CStringDataSource>(Data), ',', Index);
+        ASSERT_TRUE(Reader.SeekRow(Splits[Part].DRow));
+        EXPECT_EQ(Reader.Offset(), Splits[Part].DOffset);
+        std::vector<std::string> Row;
+        while(Reader.Row() < Splits[Part + 1].DRow && Reader.ReadRow(Row)){
+            EXPECT_EQ(Row, Rows[Total++]);
+        }
+    }
+    EXPECT_EQ(Total, Rows.size());
+}
+
+TEST(DSVIndex, FileSource){
+    CScratch Scratch;
+    std::string Path = Scratch.Write("index.csv", IndexTestData());
+    auto Source = std::make_shared<CFileDataSource>(Path, 64);
+    auto Index = std::make_shared<CDSVIndex>(16);
+
+    ASSERT_TRUE(Source->IsOpen());
+    EXPECT_EQ(Source->Size(), IndexTestData().size());
+    ASSERT_TRUE(Index->Build(std::make_shared<CFileDataSource>(Path)));
+    CDSVReader Reader(Source, ',', Index);
+    std::vector<std::string> Row;
+    ASSERT_TRUE(Reader.SeekRow(Index->RowCount() - 1));
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, (std::vector<std::string>{"last", "row"}));
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "DSVPushParser.h"
+#include "DSVReader.h"
+#include "StringDataSource.h"
+
+namespace {
+
+using TRows = std::vector< std::vector< std::string > >;
+
+TRows ReadAll(const std::string &data, char delimiter){
+    CDSVReader Reader(std::make_shared<CStringDataSource>(data), delimiter);
+    TRows Rows;
+    std::vector<std::string> Row;
+    while(Reader.ReadRow(Row)){
+        Rows.push_back(Row);
+    }
+    return Rows;
+}
+
+}
+
+TEST(DSVPushParser, SplitAtEveryByteTest){
+    std::vector<std::string> Inputs = {
+        "a,b,c\n1,2,3\n",
+        "a,\"b,c\",d\r\n\"x\"\"y\",,\r\n",
+        "\"multi\r\nline\",z\rnext\n\nlast",
+        "\"\"\"\",\"\"\n,\n\"open",
+        "trailing,\r",
+        "\r\n\r\n"
+    };
+    for(auto &Input : Inputs){
+        TRows Expected = ReadAll(Input, ',');
+        // one split point, then byte at a time
+        for(std::size_t Split = 0; Split <= Input.size(); Split++){
+            TRows Rows;
+            CDSVPushParser Parser(',', [&](std::vector<std::string> &row){ Rows.push_back(std::move(row)); });
+            EXPECT_TRUE(Parser.Feed(Input.data(), Split));
+            EXPECT_TRUE(Parser.Feed(Input.data() + Split, Input.size() - Split));
+            Parser.Finish();
+            EXPECT_EQ(Rows, Expected) << Input << " split " << Split;
+        }
+        TRows Rows;
+        CDSVPushParser Parser(',', [&](std::vector<std::string> &row){ Rows.push_back(row); });
+        for(char Ch : Input){
+            Parser.Feed(&Ch, 1);
+            Parser.Feed(nullptr, 0);
+        }
+        Parser.Finish();
+        EXPECT_EQ(Rows, Expected) << Input;
+        EXPECT_EQ(Parser.Row(), Expected.size());
+    }
+}
+
+TEST(DSVPushParser, IncrementalTest){
+    TRows Rows;
+    CDSVPushParser Parser('\t', [&](std::vector<std::string> &row){ Rows.push_back(row); });
+    std::string Chunk = "a\tb";
+    Parser.Feed(Chunk.data(), Chunk.size());
+    EXPECT_TRUE(Rows.empty());
+    Chunk = "\r";
+    Parser.Feed(Chunk.data(), Chunk.size());
+    ASSERT_EQ(Rows.size(), 1);
+    EXPECT_EQ(Rows[0], std::vector<std::string>({"a", "b"}));
+    Chunk = "\nc";
+    Parser.Feed(Chunk.data(), Chunk.size());
+    EXPECT_EQ(Rows.size(), 1);
+    EXPECT_TRUE(Parser.Finish());
+    ASSERT_EQ(Rows.size(), 2);
+    EXPECT_EQ(Rows[1], std::vector<std::string>({"c"}));
+    EXPECT_TRUE(Parser.Finished());
+    EXPECT_FALSE(Parser.Feed(Chunk.data(), Chunk.size()));
+    EXPECT_FALSE(Parser.Finish());
+
+    Parser.Reset();
+    EXPECT_FALSE(Parser.Finished());
+    EXPECT_EQ(Parser.Row(), 0);
+    EXPECT_FALSE(Parser.Finish());
+    EXPECT_EQ(Rows.size(), 2);
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include "DSVSorter.h"
+#include "DSVSpillFile.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+#include <algorithm>
+#include <random>
+
+namespace {
+
+// rows with numeric ids, a few tricky strings and duplicate keys
+std::vector<std::vector<std::string>> SorterTestRows(size_t count){
+    std::mt19937 Random(42);
+    std::vector<std::vector<std::string>> Rows;
+    for(size_t Index = 0; Index < count; Index++){
+        std::string Id = std::to_string(Random() % 1000);
+        std::string Name = (Index % 7 == 0) ? "quote \"" + Id + "\",\nline" : "name" + std::to_string(Random() % 50);
+        Rows.push_back({Id, Name, std::to_string(Index)});
+    }
+    return Rows;
+}
+
+std::string WriteRows(const std::vector<std::vector<std::string>> &rows){
+    auto Sink = std::make_shared<CStringDataSink>();
+    CDSVWriter Writer(Sink, ',');
+    for(auto &Row : rows){
+        Writer.WriteRow(Row);
+    }
+    return Sink->String();
+}
+
+}
+
+TEST(DSVSpillFile, RoundTrip){
+    CDSVSpillFile File;
+    std::vector<std::string> Row;
+
+    ASSERT_TRUE(File.IsOpen());
+    EXPECT_TRUE(File.WriteRow({"a", "", "b,\"c\"\n"}));
+    EXPECT_TRUE(File.WriteRow({}));
+    EXPECT_TRUE(File.WriteRow({std::string(3000000, 'x')}));
+    EXPECT_EQ(File.Rows(), 3);
+    ASSERT_TRUE(File.Rewind());
+    EXPECT_FALSE(File.WriteRow({"late"}));
+    ASSERT_TRUE(File.ReadRow(Row));
+    EXPECT_EQ(Row, (std::vector<std::string>{"a", "", "b,\"c\"\n"}));
+    ASSERT_TRUE(File.ReadRow(Row));
+    EXPECT_TRUE(Row.empty());
+    ASSERT_TRUE(File.ReadRow(Row));
+    EXPECT_EQ(Row[0].size(), 3000000);
+    EXPECT_FALSE(File.ReadRow(Row));
+}
+
+TEST(DSVSorter, InMemory){
+    CDSVReader Reader(std::make_shared<CStringDataSource>("b,2\na,10\nc,1\na,9\n"), ',');
+    auto Sink = std::make_shared<CStringDataSink>();
+    CDSVWriter Writer(Sink, ',');
+    CDSVSorter Sorter({{0}, {1, true, true}});
+
+    ASSERT_TRUE(Sorter.Sort(Reader, Writer));
+    EXPECT_EQ(Sorter.RunCount(), 1);
+    EXPECT_EQ(Sink->String(), "a,10\na,9\nb,2\nc,1\n");
+}
+
+TEST(DSVSorter, SpilledMatchesStableSort){
+    auto Rows = SorterTestRows(20000);
+    CDSVReader Reader(std::make_shared<CStringDataSource>(WriteRows(Rows)), ',');
+    auto Sink = std::make_shared<CStringDataSink>();
+    CDSVWriter Writer(Sink, ',');
+    CDSVSorter Sorter({{0, true}}, 256 << 10);
+
+    ASSERT_TRUE(Sorter.Sort(Reader, Writer));
+    EXPECT_GT(Sorter.RunCount(), 2);
+    std::stable_sort(Rows.begin(), Rows.end(), [](const auto &left, const auto &right){
+        return std::stod(left[0]) < std::stod(right[0]);
+    });
+    EXPECT_EQ(Sink->String(), WriteRows(Rows));
+}
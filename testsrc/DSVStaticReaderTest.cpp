@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include "DSVStaticReader.h"
+#include "DSVReader.h"
+#include "StringDataSource.h"
+
+namespace {
+
+std::vector< std::vector< std::string > > ReadAll(CDSVReader &reader){
+    std::vector< std::vector< std::string > > Rows;
+    std::vector<std::string> Row;
+    while(reader.ReadRow(Row)){
+        Rows.push_back(Row);
+    }
+    return Rows;
+}
+
+template <typename TReader>
+std::vector< std::vector< std::string > > ReadAll(TReader &reader){
+    std::vector< std::vector< std::string > > Rows;
+    std::vector<std::string> Row;
+    while(reader.ReadRow(Row)){
+        Rows.push_back(Row);
+    }
+    return Rows;
+}
+
+}
+
+TEST(DSVStaticReader, MatchesDSVReader){
+    std::vector<std::string> Inputs = {
+        "a,b,c\n1,2,3\n",
+        "a,\"b,c\",d\r\n\"x\"\"y\",,\r\n",
+        "\"multi\nline\",z\rnext\n\nlast",
+        "\"\"\"\",\"\"\n,\n\"open",
+        "trailing,\r"
+    };
+    for(auto &Input : Inputs){
+        CDSVReader Reader(std::make_shared<CStringDataSource>(Input), ',');
+        auto Expected = ReadAll(Reader);
+        // small blocks put quote pairs and CRLF across refills
+        for(std::size_t BlockSize : {1, 2, 3, 7, 65536}){
+            CDSVStaticReader<','> Static(std::make_shared<CStringDataSource>(Input), BlockSize);
+            EXPECT_EQ(ReadAll(Static), Expected) << Input << " block " << BlockSize;
+            EXPECT_TRUE(Static.End());
+            EXPECT_EQ(Static.Row(), Expected.size());
+        }
+    }
+}
+
+TEST(DSVStaticReader, NoQuotingTest){
+    CDSVStaticReader<'\t', EDSVQuoting::None, EDSVLineEnding::LF, CStringDataSource> Reader(
+        std::make_shared<CStringDataSource>("\"a\"\tb\t\nc\"\"\td\n"));
+    std::vector<std::string> Row;
+    EXPECT_FALSE(Reader.End());
+    EXPECT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector<std::string>({"\"a\"", "b", ""}));
+    EXPECT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, std::vector<std::string>({"c\"\"", "d"}));
+    EXPECT_FALSE(Reader.ReadRow(Row));
+    EXPECT_TRUE(Reader.End());
+}
+
+TEST(DSVStaticReader, LineEndingTest){
+    std::string Input = "a\r\nb\rc\n";
+    CDSVStaticReader<',', EDSVQuoting::RFC4180, EDSVLineEnding::LF> LF(std::make_shared<CStringDataSource>(Input));
+    EXPECT_EQ(ReadAll(LF), (std::vector< std::vector< std::string > >{{"a\r"}, {"b\rc"}}));
+    for(std::size_t BlockSize : {1, 2, 65536}){
+        CDSVStaticReader<',', EDSVQuoting::RFC4180, EDSVLineEnding::CRLF> CRLF(std::make_shared<CStringDataSource>(Input), BlockSize);
+        EXPECT_EQ(ReadAll(CRLF), (std::vector< std::vector< std::string > >{{"a"}, {"b\rc"}}));
+    }
+    CDSVStaticReader<',', EDSVQuoting::RFC4180, EDSVLineEnding::Any> Any(std::make_shared<CStringDataSource>(Input));
+    EXPECT_EQ(ReadAll(Any), (std::vector< std::vector< std::string > >{{"a"}, {"b"}, {"c"}}));
+}
+
+TEST(DSVStaticReader, EmptyTest){
+    CDSVStaticReader<'|'> Reader(std::make_shared<CStringDataSource>(""));
+    std::vector<std::string> Row = {"stale"};
+    EXPECT_TRUE(Reader.End());
+    EXPECT_FALSE(Reader.ReadRow(Row));
+    EXPECT_TRUE(Row.empty());
+    EXPECT_EQ(Reader.Row(), 0);
+}
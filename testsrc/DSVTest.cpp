@@ -3,6 +3,11 @@
 #include "StringDataSource.h"
 #include "StringDataSink.h"
 #include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <span>
+#include <tuple>
 
 TEST(DSVTest, BasicReadWrite) {
     // initialize a shared pointer for data w/ DSV content
@@ -27,3 +32,123 @@ TEST(DSVTest, BasicReadWrite) {
     EXPECT_EQ(sink->String(), "hello,anikaandaleena,hi\na,b,c\n");
 }
 
+TEST(DSVTest, RowsGenerator) {
+    CDSVReader reader(std::make_shared<CStringDataSource>("a,b\n\"c\nd\",e\nf\n"), ',');
+    std::vector<std::vector<std::string>> rows;
+    // the generator hands out the same row buffer each time
+    const std::vector<std::string> *buffer = nullptr;
+    for (auto &row : reader.Rows()) {
+        if (buffer) {
+            EXPECT_EQ(&row, buffer);
+        }
+        buffer = &row;
+        rows.push_back(row);
+    }
+    EXPECT_EQ(rows, (std::vector<std::vector<std::string>>{{"a", "b"}, {"c\nd", "e"}, {"f"}}));
+    EXPECT_TRUE(reader.End());
+}
+
+namespace {
+
+// counts the writes that reach the sink
+class CCountingSink : public CStringDataSink {
+    public:
+        std::size_t Writes = 0;
+
+        bool Write(const std::vector<char> &buf) noexcept override {
+            Writes++;
+            return CStringDataSink::Write(buf);
+        }
+};
+
+}
+
+TEST(DSVTest, TypedWriteRow) {
+    auto sink = std::make_shared<CStringDataSink>();
+    CDSVWriter writer(sink, ',');
+    std::string name = "a,b";
+    EXPECT_TRUE(writer.WriteRow("id", 42, -7L, 0u, 1.5, 0.1f, true, false, 'x', std::string_view("say \"hi\""), name));
+    EXPECT_TRUE(writer.WriteRow(std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::uint64_t>::max()));
+    EXPECT_TRUE(writer.WriteRow());
+    EXPECT_TRUE(writer.WriteRow(std::make_tuple(std::string("t"), 3, 2.25)));
+    EXPECT_EQ(sink->String(), "id,42,-7,0,1.5,0.1,true,false,x,\"say \"\"hi\"\"\",\"a,b\"\n"
+                              "-9223372036854775808,18446744073709551615\n"
+                              "\n"
+                              "t,3,2.25\n");
+
+    // the same row as strings gives the same output
+    auto stringsink = std::make_shared<CStringDataSink>();
+    CDSVWriter stringwriter(stringsink, ',');
+    stringwriter.WriteRow(std::vector<std::string>{"t", "3", "2.25"});
+    EXPECT_EQ(stringsink->String(), "t,3,2.25\n");
+}
+
+TEST(DSVTest, TypedWriteRowRoundTrip) {
+    auto sink = std::make_shared<CStringDataSink>();
+    CDSVWriter writer(sink, ',');
+    std::vector<double> values = {0.1, 1.0 / 3.0, 1e300, -2.2250738585072014e-308, 123456789.125, std::nextafter(1.0, 2.0)};
+    for (double value : values) {
+        writer.WriteRow(value);
+    }
+    CDSVReader reader(std::make_shared<CStringDataSource>(sink->String()), ',');
+    std::vector<std::string> row;
+    for (double value : values) {
+        ASSERT_TRUE(reader.ReadRow(row));
+        ASSERT_EQ(row.size(), 1);
+        // the shortest form still reads back to the same double
+        EXPECT_EQ(std::strtod(row[0].c_str(), nullptr), value) << row[0];
+        EXPECT_LE(row[0].size(), 24);
+    }
+}
+
+TEST(DSVTest, TypedWriteRowQuoting) {
+    // numbers only need quotes when the delimiter is part of how they are written
+    auto sink = std::make_shared<CStringDataSink>();
+    CDSVWriter writer(sink, '.');
+    writer.WriteRow(1.5, 2, true, "x.y");
+    EXPECT_EQ(sink->String(), "\"1.5\".2.true.\"x.y\"\n");
+
+    auto quotesink = std::make_shared<CStringDataSink>();
+    CDSVWriter quotewriter(quotesink, ',', true);
+    quotewriter.WriteRow(1, false, "a");
+    EXPECT_EQ(quotesink->String(), "\"1\",\"false\",\"a\"\n");
+}
+
+TEST(DSVTest, WriteColumns) {
+    auto sink = std::make_shared<CCountingSink>();
+    CDSVWriter writer(sink, ',');
+    std::vector<int> ids;
+    std::vector<double> scores;
+    std::vector<std::string> names;
+    std::vector<bool> flags;
+    for (int index = 0; index < 10000; index++) {
+        ids.push_back(index);
+        scores.push_back(index / 4.0);
+        names.push_back(index % 2 ? "odd, name" : "even");
+        flags.push_back(index % 3 == 0);
+    }
+    EXPECT_TRUE(writer.WriteColumns(ids, scores, names, flags));
+    // rows are batched into a few large writes
+    EXPECT_GT(sink->Writes, 1);
+    EXPECT_LT(sink->Writes, 10);
+
+    CDSVReader reader(std::make_shared<CStringDataSource>(sink->String()), ',');
+    std::vector<std::string> row;
+    for (int index = 0; index < 10000; index++) {
+        ASSERT_TRUE(reader.ReadRow(row));
+        ASSERT_EQ(row.size(), 4);
+        EXPECT_EQ(row[0], std::to_string(index));
+        EXPECT_EQ(row[2], names[index]);
+        EXPECT_EQ(row[3], flags[index] ? "true" : "false");
+        EXPECT_EQ(std::strtod(row[1].c_str(), nullptr), scores[index]);
+    }
+    EXPECT_FALSE(reader.ReadRow(row));
+
+    // spans work as columns and mismatched lengths are refused
+    std::span<const int> first(ids.data(), 2);
+    auto spansink = std::make_shared<CStringDataSink>();
+    CDSVWriter spanwriter(spansink, '\t');
+    EXPECT_TRUE(spanwriter.WriteColumns(first, std::span<const double>(scores.data() + 1, 2)));
+    EXPECT_EQ(spansink->String(), "0\t0.25\n1\t0.5\n");
+    EXPECT_FALSE(spanwriter.WriteColumns(ids, first));
+}
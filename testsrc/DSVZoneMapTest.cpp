@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "DSVZoneMap.h"
+#include "DSVReader.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+
+namespace {
+
+// ids increase so numeric ranges prune well, names repeat per block
+std::string ZoneMapTestData(){
+    std::string Data;
+    for(int Index = 0; Index < 1000; Index++){
+        Data += std::to_string(Index) + ",name" + std::to_string(Index / 100) + ",";
+        Data += (Index % 10 == 0) ? "" : "\"x,y\"";
+        Data += "\n";
+    }
+    return Data;
+}
+
+std::vector<std::vector<std::string>> ScanAll(const CDSVZoneMap &map, const std::string &data, const std::vector<CDSVZoneMap::SPredicate> &preds){
+    std::vector<std::vector<std::string>> Rows;
+    map.Scan(std::make_shared<CStringDataSource>(data), ',', preds, [&Rows](const std::vector<std::string> &row){
+        Rows.push_back(row);
+        return true;
+    });
+    return Rows;
+}
+
+std::vector<std::vector<std::string>> FilterAll(const std::string &data, const std::vector<CDSVZoneMap::SPredicate> &preds){
+    CDSVReader Reader(std::make_shared<CStringDataSource>(data), ',');
+    std::vector<std::vector<std::string>> Rows;
+    std::vector<std::string> Row;
+    while(Reader.ReadRow(Row)){
+        bool Match = true;
+        for(auto &Pred : preds){
+            Match = Match && Pred.Matches(Row);
+        }
+        if(Match){
+            Rows.push_back(Row);
+        }
+    }
+    return Rows;
+}
+
+using EOp = CDSVZoneMap::SPredicate::EOp;
+
+}
+
+TEST(DSVZoneMap, BuildStats){
+    CDSVZoneMap Map(100);
+
+    ASSERT_TRUE(Map.Build(std::make_shared<CStringDataSource>(ZoneMapTestData()), ','));
+    ASSERT_EQ(Map.Blocks().size(), 10);
+    auto &Block = Map.Blocks()[3];
+    EXPECT_EQ(Block.DRow, 300);
+    EXPECT_EQ(Block.DRowCount, 100);
+    ASSERT_EQ(Block.DColumns.size(), 3);
+    EXPECT_EQ(Block.DColumns[0].DMin, 300);
+    EXPECT_EQ(Block.DColumns[0].DMax, 399);
+    EXPECT_EQ(Block.DColumns[1].DNumericCount, 0);
+    EXPECT_EQ(Block.DColumns[2].DNullCount, 10);
+}
+
+TEST(DSVZoneMap, SkipsBlocks){
+    std::string Data = ZoneMapTestData();
+    CDSVZoneMap Map(100);
+    ASSERT_TRUE(Map.Build(std::make_shared<CStringDataSource>(Data), ','));
+
+    std::vector<std::vector<CDSVZoneMap::SPredicate>> Cases = {
+        {{0, EOp::GreaterEqual, "850"}},
+        {{0, EOp::Less, "120"}, {2, EOp::Empty, ""}},
+        {{1, EOp::Equal, "name4"}},
+        {{0, EOp::Equal, "512"}},
+        {{1, EOp::Equal, "missing"}},
+        {{2, EOp::Equal, "x,y"}, {0, EOp::LessEqual, "3"}},
+        {{5, EOp::NotEmpty, ""}},
+    };
+    for(auto &Preds : Cases){
+        EXPECT_EQ(ScanAll(Map, Data, Preds), FilterAll(Data, Preds));
+    }
+    EXPECT_EQ(Map.CandidateBlocks(Cases[0]).size(), 2);
+    EXPECT_EQ(Map.CandidateBlocks(Cases[2]), std::vector<size_t>{4});
+    EXPECT_EQ(Map.CandidateBlocks(Cases[3]), std::vector<size_t>{5});
+    EXPECT_TRUE(Map.CandidateBlocks(Cases[6]).empty());
+}
+
+TEST(DSVZoneMap, SaveLoad){
+    std::string Data = ZoneMapTestData();
+    CDSVZoneMap Map(64), Loaded;
+    auto Sink = std::make_shared<CStringDataSink>();
+    std::vector<CDSVZoneMap::SPredicate> Preds = {{0, EOp::Greater, "700"}, {1, EOp::Equal, "name7"}};
+
+    ASSERT_TRUE(Map.Build(std::make_shared<CStringDataSource>(Data), ','));
+    ASSERT_TRUE(Map.Save(Sink));
+    ASSERT_TRUE(Loaded.Load(std::make_shared<CStringDataSource>(Sink->String())));
+    EXPECT_EQ(Loaded.BlockRows(), 64);
+    EXPECT_EQ(Loaded.CandidateBlocks(Preds), Map.CandidateBlocks(Preds));
+    EXPECT_EQ(ScanAll(Loaded, Data, Preds), FilterAll(Data, Preds));
+    EXPECT_FALSE(Loaded.Load(std::make_shared<CStringDataSource>("DSVI")));
+}
+
+TEST(DSVZoneMap, DistinctValuesPrune){
+    // every name in a block is different, the filter must still rule most blocks out
+    std::string Data;
+    for(int Index = 0; Index < 4 * 4096; Index++){
+        Data += std::to_string(Index) + ",name" + std::to_string(Index) + "\n";
+    }
+    CDSVZoneMap Map;
+    EXPECT_EQ(Map.BloomBits(), CDSVZoneMap::MaxBloomBits);
+    EXPECT_EQ(CDSVZoneMap(100).BloomBits(), 1024);
+    EXPECT_EQ(CDSVZoneMap(100, 128).BloomBits(), 128);
+    ASSERT_TRUE(Map.Build(std::make_shared<CStringDataSource>(Data), ','));
+    ASSERT_EQ(Map.Blocks().size(), 4);
+    EXPECT_EQ(Map.CandidateBlocks({{1, EOp::Equal, "name5000"}}), std::vector<size_t>{1});
+    std::size_t Candidates = 0;
+    for(int Index = 0; Index < 100; Index++){
+        Candidates += Map.CandidateBlocks({{1, EOp::Equal, "other" + std::to_string(Index)}}).size();
+    }
+    EXPECT_LT(Candidates, 40);
+
+    auto Sink = std::make_shared<CStringDataSink>();
+    CDSVZoneMap Loaded;
+    ASSERT_TRUE(Map.Save(Sink));
+    ASSERT_TRUE(Loaded.Load(std::make_shared<CStringDataSource>(Sink->String())));
+    EXPECT_EQ(Loaded.BloomBits(), Map.BloomBits());
+    EXPECT_EQ(Loaded.Blocks()[2].DColumns[1].DBloom, Map.Blocks()[2].DColumns[1].DBloom);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "EncodingDataSource.h"
+#include "StringDataSource.h"
+#include "DSVReader.h"
+#include "XMLReader.h"
+
+namespace {
+
+std::string Convert(const std::string &input, EEncoding encoding, EInvalidPolicy policy, std::size_t blocksize, std::size_t *invalid = nullptr){
+    CEncodingDataSource Source(std::make_shared<CStringDataSource>(input), encoding, policy, blocksize);
+    std::string Result;
+    std::vector<char> Buffer;
+    while(Source.Read(Buffer, 7)){
+        Result.append(Buffer.begin(), Buffer.end());
+    }
+    EXPECT_TRUE(Source.End());
+    if(invalid){
+        *invalid = Source.InvalidSequences();
+    }
+    return Result;
+}
+
+std::string UTF16(const std::u16string &text, bool bigendian){
+    std::string Result;
+    for(char16_t Unit : text){
+        char Low = static_cast<char>(Unit & 0xFF), High = static_cast<char>(Unit >> 8);
+        Result += bigendian ? High : Low;
+        Result += bigendian ? Low : High;
+    }
+    return Result;
+}
+
+const std::string Text = "plain ascii text long enough for a vector step, caf\xC3\xA9, \xE2\x82\xAC and \xF0\x9F\x98\x80 end";
+
+}
+
+TEST(EncodingDataSource, DetectTest){
+    struct SCase{
+        std::string DInput;
+        EEncoding DEncoding;
+        std::string DExpected;
+    };
+    std::vector<SCase> Cases = {
+        {"\xEF\xBB\xBF" + Text, EEncoding::UTF8, Text},
+        {Text, EEncoding::UTF8, Text},
+        {"caf\xE9 cr\xE8me", EEncoding::Latin1, "caf\xC3\xA9 cr\xC3\xA8me"},
+        {"\xFF\xFE" + UTF16(u"a€b\U0001F600", false), EEncoding::UTF16LE, "a\xE2\x82\xAC" "b\xF0\x9F\x98\x80"},
+        {"\xFE\xFF" + UTF16(u"a€b\U0001F600", true), EEncoding::UTF16BE, "a\xE2\x82\xAC" "b\xF0\x9F\x98\x80"},
+        {UTF16(u"<root/>", false), EEncoding::UTF16LE, "<root/>"},
+        {UTF16(u"<root/>", true), EEncoding::UTF16BE, "<root/>"},
+        {"", EEncoding::UTF8, ""}
+    };
+    for(auto &Case : Cases){
+        // every block size splits sequences and the mark at a different place
+        for(std::size_t BlockSize : {1, 2, 3, 5, 16, 65536}){
+            CEncodingDataSource Source(std::make_shared<CStringDataSource>(Case.DInput), EEncoding::Auto, EInvalidPolicy::Reject, BlockSize);
+            std::string Result;
+            char Ch;
+            while(Source.Get(Ch)){
+                Result += Ch;
+            }
+            EXPECT_EQ(Result, Case.DExpected) << BlockSize;
+            EXPECT_EQ(Source.Encoding(), Case.DEncoding);
+            EXPECT_FALSE(Source.Failed());
+        }
+    }
+}
+
+TEST(EncodingDataSource, ExplicitEncodingTest){
+    EXPECT_EQ(Convert("\xEF\xBB\xBFx", EEncoding::UTF8, EInvalidPolicy::Reject, 64), "x");
+    // a mark for another encoding is data, here Latin-1 text
+    EXPECT_EQ(Convert("\xFF\xFEx", EEncoding::Latin1, EInvalidPolicy::Reject, 64), "\xC3\xBF\xC3\xBEx");
+    EXPECT_EQ(Convert(Text, EEncoding::Latin1, EInvalidPolicy::Reject, 64).size(), Text.size() + 9);
+    EXPECT_EQ(Convert(UTF16(u"été", true), EEncoding::UTF16BE, EInvalidPolicy::Reject, 3), "\xC3\xA9t\xC3\xA9");
+}
+
+TEST(EncodingDataSource, InvalidUTF8Test){
+    // a bad continuation, an overlong lead, a surrogate, and a sequence cut off by the end
+    std::string Input = "a\xC3(b\xC0\xAF" "c\xED\xA0\x80" "d\xF0\x9F\x98";
+    std::size_t Invalid = 0;
+    for(std::size_t BlockSize : {1, 4, 64}){
+        EXPECT_EQ(Convert(Input, EEncoding::UTF8, EInvalidPolicy::Replace, BlockSize, &Invalid),
+                  "a\xEF\xBF\xBD(b\xEF\xBF\xBD\xEF\xBF\xBD" "c\xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD" "d\xEF\xBF\xBD");
+        EXPECT_EQ(Invalid, 7);
+        EXPECT_EQ(Convert(Input, EEncoding::UTF8, EInvalidPolicy::PassThrough, BlockSize, &Invalid), Input);
+        EXPECT_EQ(Invalid, 7);
+    }
+
+    CEncodingDataSource Source(std::make_shared<CStringDataSource>(Input), EEncoding::UTF8, EInvalidPolicy::Reject);
+    std::vector<char> Buffer;
+    EXPECT_TRUE(Source.Read(Buffer, 100));
+    EXPECT_EQ(std::string(Buffer.begin(), Buffer.end()), "a");
+    EXPECT_TRUE(Source.Failed());
+    EXPECT_TRUE(Source.End());
+    EXPECT_FALSE(Source.Read(Buffer, 100));
+}
+
+TEST(EncodingDataSource, InvalidUTF16Test){
+    // a lone high surrogate, a lone low surrogate and an odd trailing byte
+    std::string Input = UTF16(u"a", false) + std::string("\x00\xD8", 2) + UTF16(u"b", false) + std::string("\x00\xDC", 2) + "c";
+    std::size_t Invalid = 0;
+    EXPECT_EQ(Convert(Input, EEncoding::UTF16LE, EInvalidPolicy::Replace, 3, &Invalid),
+              "a\xEF\xBF\xBD" "b\xEF\xBF\xBD\xEF\xBF\xBD");
+    EXPECT_EQ(Invalid, 3);
+    EXPECT_EQ(Convert(Input, EEncoding::UTF16LE, EInvalidPolicy::PassThrough, 3, &Invalid),
+              "a\xED\xA0\x80" "b\xED\xB0\x80\xEF\xBF\xBD");
+    EXPECT_EQ(Convert(Input, EEncoding::UTF16LE, EInvalidPolicy::Reject, 3), "a");
+}
+
+TEST(EncodingDataSource, ValidUTF8LengthTest){
+    EXPECT_EQ(CEncodingDataSource::ValidUTF8Length(Text), Text.size());
+    EXPECT_EQ(CEncodingDataSource::ValidUTF8Length(Text + "\xF4\x90\x80\x80" + Text), Text.size());
+    EXPECT_EQ(CEncodingDataSource::ValidUTF8Length(Text.substr(0, Text.size() - 5)), Text.size() - 8);
+    EXPECT_EQ(CEncodingDataSource::ValidUTF8Length(""), 0);
+}
+
+TEST(EncodingDataSource, ReaderTest){
+    std::string Input = "\xFF\xFE" + UTF16(u"name,price\r\nÉclair,€3\r\n", false);
+    CDSVReader Reader(std::make_shared<CEncodingDataSource>(std::make_shared<CStringDataSource>(Input)), ',');
+    std::vector<std::string> Row;
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, (std::vector<std::string>{"name", "price"}));
+    ASSERT_TRUE(Reader.ReadRow(Row));
+    EXPECT_EQ(Row, (std::vector<std::string>{"\xC3\x89" "clair", "\xE2\x82\xAC" "3"}));
+    EXPECT_FALSE(Reader.ReadRow(Row));
+
+    CXMLReader XMLReader(std::make_shared<CEncodingDataSource>(std::make_shared<CStringDataSource>("<a b=\"caf\xE9\"/>")));
+    SXMLEntity Entity;
+    ASSERT_TRUE(XMLReader.ReadEntity(Entity));
+    EXPECT_EQ(Entity.AttributeValue("b"), "caf\xC3\xA9");
+}
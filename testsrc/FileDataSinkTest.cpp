@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include "FileDataSink.h"
+#include "FileDataSource.h"
+#include "TestScratch.h"
+
+namespace {
+
+std::string ReadFile(const std::string &path){
+    CFileDataSource Source(path);
+    std::string Result;
+    std::vector<char> Buffer;
+    while(Source.Read(Buffer, 1000)){
+        Result.append(Buffer.begin(), Buffer.end());
+    }
+    return Result;
+}
+
+}
+
+TEST(FileDataSink, WriteTest){
+    CScratch Scratch;
+    std::string Path = Scratch.Write("sink.txt", "");
+    std::string Expected;
+    {
+        CFileDataSink Sink(Path, 8);
+        ASSERT_TRUE(Sink.IsOpen());
+        for(char Ch : std::string("abc")){
+            EXPECT_TRUE(Sink.Put(Ch));
+            Expected += Ch;
+        }
+        // smaller than the buffer, then larger than it
+        std::vector<char> Small = {'d', 'e'};
+        std::vector<char> Large(20, 'x');
+        EXPECT_TRUE(Sink.Write(Small));
+        EXPECT_EQ(ReadFile(Path), "");
+        EXPECT_TRUE(Sink.Write(Large));
+        EXPECT_TRUE(Sink.Write({}));
+        Expected += "de" + std::string(20, 'x');
+        EXPECT_EQ(ReadFile(Path), Expected);
+        EXPECT_TRUE(Sink.Put('!'));
+        EXPECT_TRUE(Sink.Flush());
+        EXPECT_EQ(ReadFile(Path), Expected + "!");
+        EXPECT_TRUE(Sink.Put('?'));
+        Expected += "!?";
+    }
+    // the destructor writes what is still buffered
+    EXPECT_EQ(ReadFile(Path), Expected);
+}
+
+TEST(FileDataSink, BadPathTest){
+    CScratch Scratch;
+    CFileDataSink Sink(Scratch.DPath + "/missing_directory/sink.txt");
+    EXPECT_FALSE(Sink.IsOpen());
+    EXPECT_FALSE(Sink.Write({'a'}));
+    EXPECT_FALSE(Sink.Flush());
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include "DSVReader.h"
+#include "DSVWriter.h"
+#include "XMLReader.h"
+#include "XMLWriter.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+
+TEST(IOStats, DSVCounters){
+    std::string Data = "a,\"b,c\"\nlonger field,d\n";
+    CDSVReader Reader(std::make_shared<CStringDataSource>(Data), ',');
+    CDSVWriter Writer(std::make_shared<CStringDataSink>(), ',');
+    std::vector<std::string> Row;
+    while(Reader.ReadRow(Row)){
+        Writer.WriteRow(Row);
+    }
+    SIOStats ReaderStats = Reader.Stats();
+    SIOStats WriterStats = Writer.Stats();
+
+    EXPECT_EQ(ReaderStats.DKind, SIOStats::EKind::DSVReader);
+    EXPECT_EQ(WriterStats.DKind, SIOStats::EKind::DSVWriter);
+    if(CIOStatsCounters::Enabled){
+        EXPECT_EQ(ReaderStats.DBytes, Data.size());
+        EXPECT_EQ(ReaderStats.DRecords, 2);
+        EXPECT_EQ(ReaderStats.DMaxFieldSize, 12);
+        EXPECT_EQ(ReaderStats.DMaxRecordSize, 15);
+        EXPECT_EQ(ReaderStats.DQuotedFields, 1);
+        EXPECT_EQ(WriterStats.DBytes, Data.size());
+        EXPECT_EQ(WriterStats.DRecords, 2);
+        EXPECT_EQ(WriterStats.DQuotedFields, 1);
+    }
+    else{
+        EXPECT_EQ(ReaderStats.DBytes, 0);
+        EXPECT_EQ(WriterStats.DRecords, 0);
+    }
+}
+
+TEST(IOStats, XMLCounters){
+    std::string Data = "<a x=\"1\"><b>text</b><c/></a>";
+    CXMLReader Reader(std::make_shared<CStringDataSource>(Data));
+    CXMLWriter Writer(std::make_shared<CStringDataSink>());
+    SXMLEntity Entity;
+    while(Reader.ReadEntity(Entity)){
+        Writer.WriteEntity(Entity);
+    }
+    SIOStats ReaderStats = Reader.Stats();
+
+    EXPECT_EQ(ReaderStats.DKind, SIOStats::EKind::XMLReader);
+    EXPECT_EQ(Writer.Stats().DKind, SIOStats::EKind::XMLWriter);
+    if(CIOStatsCounters::Enabled){
+        EXPECT_EQ(ReaderStats.DBytes, Data.size());
+        EXPECT_EQ(ReaderStats.DRecords, 7);
+        EXPECT_EQ(ReaderStats.DParseCalls, 1);
+        EXPECT_EQ(ReaderStats.DQueueHighWater, 7);
+        EXPECT_EQ(Writer.Stats().DRecords, 7);
+    }
+}
+
+TEST(IOStats, Registry){
+    size_t Before = CIOStatsRegistry::Snapshot().size();
+    {
+        CDSVReader Reader(std::make_shared<CStringDataSource>(""), ',');
+        CXMLWriter Writer(std::make_shared<CStringDataSink>());
+        EXPECT_EQ(CIOStatsRegistry::Snapshot().size(), Before + (CIOStatsCounters::Enabled ? 2 : 0));
+    }
+    EXPECT_EQ(CIOStatsRegistry::Snapshot().size(), Before);
+}
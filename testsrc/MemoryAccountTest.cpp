@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include "MemoryAccount.h"
+#include "DSVReader.h"
+#include "DSVWriter.h"
+#include "XMLReader.h"
+#include "XMLWriter.h"
+#include "SegmentedDataSink.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+#include <algorithm>
+
+TEST(MemoryAccount, ResourceTest){
+    CMemoryAccount Account("resource");
+    {
+        std::pmr::vector<char> Vector(&Account);
+        Vector.resize(1000);
+        EXPECT_GE(Account.Live(), 1000);
+        Vector.resize(5000);
+        EXPECT_GE(Account.Live(), 5000);
+        EXPECT_GE(Account.Peak(), 6000);
+    }
+    EXPECT_EQ(Account.Live(), 0);
+    EXPECT_GE(Account.Peak(), 6000);
+    EXPECT_FALSE(Account.Exceeded());
+}
+
+TEST(MemoryAccount, LimitTest){
+    CMemoryAccount Account("limit", 100);
+    EXPECT_TRUE(Account.Charge(60));
+    EXPECT_FALSE(Account.Charge(60));
+    EXPECT_TRUE(Account.Exceeded());
+    EXPECT_EQ(Account.Live(), 60);
+    EXPECT_THROW(static_cast<void>(Account.allocate(50)), std::bad_alloc);
+    EXPECT_EQ(Account.Live(), 60);
+
+    std::size_t Charged = 60;
+    EXPECT_TRUE(Account.Resize(Charged, 100));
+    EXPECT_FALSE(Account.Resize(Charged, 101));
+    EXPECT_EQ(Charged, 100);
+    EXPECT_TRUE(Account.Resize(Charged, 0));
+    EXPECT_EQ(Account.Live(), 0);
+    EXPECT_EQ(Account.Peak(), 100);
+    EXPECT_EQ(Account.Stats().DRefused, 3);
+}
+
+TEST(MemoryAccount, SnapshotTest){
+    auto Named = [](const std::string &name){
+        auto Accounts = CMemoryAccount::Snapshot();
+        return std::count_if(Accounts.begin(), Accounts.end(), [&name](const SMemoryStats &stats){ return stats.DName == name; });
+    };
+    {
+        CMemoryAccount Account("snapshot", 10);
+        Account.Charge(4);
+        EXPECT_EQ(Named("snapshot"), 1);
+        for(auto &Stats : CMemoryAccount::Snapshot()){
+            if(Stats.DName == "snapshot"){
+                EXPECT_EQ(Stats.DLive, 4);
+                EXPECT_EQ(Stats.DLimit, 10);
+            }
+        }
+        Account.Credit(4);
+    }
+    EXPECT_EQ(Named("snapshot"), 0);
+}
+
+TEST(MemoryAccount, DSVReaderTest){
+    std::string Data = "a,b\n\"" + std::string(1 << 20, 'x');
+    auto Account = std::make_shared<CMemoryAccount>("dsvreader", 1 << 18);
+    {
+        CDSVReader Reader(std::make_shared<CStringDataSource>(Data), ',', nullptr, Account);
+        std::vector<std::string> Row;
+        EXPECT_TRUE(Reader.ReadRow(Row));
+        EXPECT_EQ(Row, (std::vector<std::string>{"a", "b"}));
+        EXPECT_GT(Account->Live(), 0);
+        EXPECT_FALSE(Reader.ReadRow(Row));
+        EXPECT_TRUE(Row.empty());
+        EXPECT_TRUE(Account->Exceeded());
+        EXPECT_TRUE(Reader.End());
+        EXPECT_FALSE(Reader.ReadRow(Row));
+    }
+    EXPECT_EQ(Account->Live(), 0);
+    EXPECT_LE(Account->Peak(), 1 << 18);
+}
+
+TEST(MemoryAccount, XMLReaderTest){
+    std::string Data = "<a><b>" + std::string(1 << 16, 'x') + "</b><c/></a>";
+    auto Account = std::make_shared<CMemoryAccount>("xmlreader", 1 << 14);
+    {
+        CXMLReader Reader(std::make_shared<CStringDataSource>(Data), Account);
+        SXMLEntity Entity;
+        EXPECT_TRUE(Reader.ReadEntity(Entity));
+        EXPECT_EQ(Entity.DNameData, "a");
+        EXPECT_TRUE(Reader.ReadEntity(Entity));
+        EXPECT_EQ(Entity.DNameData, "b");
+        EXPECT_FALSE(Reader.ReadEntity(Entity));
+        EXPECT_TRUE(Account->Exceeded());
+        EXPECT_TRUE(Reader.End());
+    }
+    EXPECT_EQ(Account->Live(), 0);
+
+    auto Large = std::make_shared<CMemoryAccount>("xmlreader", 1 << 20);
+    CXMLReader Reader(std::make_shared<CStringDataSource>(Data), Large);
+    SXMLEntity Entity;
+    std::size_t Count = 0;
+    while(Reader.ReadEntity(Entity)){
+        Count++;
+    }
+    EXPECT_EQ(Count, 7);
+    EXPECT_FALSE(Large->Exceeded());
+    EXPECT_GT(Large->Peak(), 1 << 16);
+}
+
+TEST(MemoryAccount, WriterTest){
+    auto Account = std::make_shared<CMemoryAccount>("dsvwriter", 64);
+    auto Sink = std::make_shared<CStringDataSink>();
+    CDSVWriter Writer(Sink, ',', false, Account);
+    EXPECT_TRUE(Writer.WriteRow({"a", "b"}));
+    EXPECT_FALSE(Writer.WriteRow({std::string(100, 'x')}));
+    EXPECT_TRUE(Account->Exceeded());
+    EXPECT_EQ(Sink->String(), "a,b\n");
+    EXPECT_LE(Account->Peak(), 64);
+    EXPECT_TRUE(Writer.WriteRow("c", 1));
+    EXPECT_EQ(Sink->String(), "a,b\nc,1\n");
+
+    auto XMLAccount = std::make_shared<CMemoryAccount>("xmlwriter", 64);
+    auto XMLSink = std::make_shared<CStringDataSink>();
+    CXMLWriter XMLWriter(XMLSink, XMLAccount);
+    EXPECT_TRUE(XMLWriter.WriteEntity({SXMLEntity::EType::StartElement, "a", {}}));
+    EXPECT_FALSE(XMLWriter.WriteEntity({SXMLEntity::EType::StartElement, std::string(100, 'b'), {}}));
+    EXPECT_EQ(XMLWriter.OpenElements(), std::vector<std::string>{"a"});
+    EXPECT_LE(XMLAccount->Peak(), 64);
+    EXPECT_TRUE(XMLWriter.Flush());
+    EXPECT_EQ(XMLSink->String(), "<a></a>");
+}
+
+TEST(MemoryAccount, WriteColumnsTest){
+    // the rows before the refused one still reach the sink
+    auto Account = std::make_shared<CMemoryAccount>("dsvcolumns", 4096);
+    auto Sink = std::make_shared<CStringDataSink>();
+    CDSVWriter Writer(Sink, ',', false, Account);
+    std::vector<std::string> Names;
+    std::vector<int> Values;
+    std::string Expected;
+    for(int Index = 0; Index < 200; Index++){
+        Names.push_back("r" + std::to_string(Index));
+        Values.push_back(Index);
+        Expected += Names.back() + "," + std::to_string(Index) + "\n";
+    }
+    Names.push_back(std::string(8000, 'x'));
+    Values.push_back(200);
+    EXPECT_FALSE(Writer.WriteColumns(Names, Values));
+    EXPECT_EQ(Sink->String(), Expected);
+    EXPECT_LE(Account->Peak(), 4096);
+    EXPECT_TRUE(Account->Exceeded());
+}
+
+TEST(MemoryAccount, XMLWriterFlushTest){
+    // end tags the account has no room for leave the elements open
+    auto Account = std::make_shared<CMemoryAccount>("xmlflush", 64);
+    auto Sink = std::make_shared<CStringDataSink>();
+    CXMLWriter Writer(Sink, Account);
+    std::vector<std::string> Names;
+    for(char Name : {'a', 'b', 'c'}){
+        Names.push_back(std::string(20, Name));
+        EXPECT_TRUE(Writer.WriteEntity({SXMLEntity::EType::StartElement, Names.back(), {}}));
+    }
+    std::string Written = Sink->String();
+    EXPECT_FALSE(Writer.Flush());
+    EXPECT_EQ(Writer.OpenElements(), Names);
+    EXPECT_EQ(Sink->String(), Written);
+}
+
+TEST(MemoryAccount, SinkTest){
+    auto Account = std::make_shared<CMemoryAccount>("stringsink", 100);
+    {
+        CStringDataSink Sink(Account);
+        EXPECT_TRUE(Sink.Write(std::vector<char>(40, 'x')));
+        EXPECT_TRUE(Sink.Put('y'));
+        EXPECT_FALSE(Sink.Write(std::vector<char>(60, 'z')));
+        EXPECT_EQ(Sink.String(), std::string(40, 'x') + "y");
+        EXPECT_LE(Account->Live(), 100);
+    }
+    EXPECT_EQ(Account->Live(), 0);
+
+    auto Chunks = std::make_shared<CMemoryAccount>("segmentedsink", 32);
+    CSegmentedDataSink Sink(16, Chunks);
+    EXPECT_TRUE(Sink.Write(std::vector<char>(32, 'x')));
+    EXPECT_EQ(Chunks->Live(), 32);
+    EXPECT_FALSE(Sink.Put('y'));
+    EXPECT_EQ(Sink.Size(), 32);
+    EXPECT_EQ(Sink.TakeChunks().size(), 2);
+    EXPECT_EQ(Chunks->Live(), 0);
+    EXPECT_TRUE(Sink.Put('y'));
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "MultiFileDataSource.h"
+#include "DSVReader.h"
+#include "TestScratch.h"
+
+namespace {
+
+std::vector<std::vector<std::string>> ReadRows(CDataSource &source){
+    CDSVReader Reader(std::shared_ptr<CDataSource>(std::shared_ptr<CDataSource>(), &source), ',');
+    std::vector<std::vector<std::string>> Result;
+    std::vector<std::string> Row;
+    while(Reader.ReadRow(Row)){
+        Result.push_back(Row);
+    }
+    return Result;
+}
+
+}
+
+TEST(MultiFileDataSource, ConcatenateTest){
+    CScratch Scratch;
+    std::vector<std::string> Paths = {Scratch.Write("a", "abc"), Scratch.Write("b", ""), Scratch.Write("c", "defgh"), Scratch.Write("d", "i")};
+    CMultiFileDataSource Source(Paths, false, 2);
+    char Ch;
+    ASSERT_TRUE(Source.Peek(Ch));
+    EXPECT_EQ(Ch, 'a');
+    ASSERT_TRUE(Source.Get(Ch));
+    EXPECT_EQ(Source.FileIndex(), 0);
+    std::vector<char> Buffer;
+    // a read runs across the empty file into the next one
+    ASSERT_TRUE(Source.Read(Buffer, 4));
+    EXPECT_EQ(std::string(Buffer.begin(), Buffer.end()), "bcde");
+    EXPECT_EQ(Source.FileIndex(), 2);
+    ASSERT_TRUE(Source.Read(Buffer, 100));
+    EXPECT_EQ(std::string(Buffer.begin(), Buffer.end()), "fghi");
+    EXPECT_TRUE(Source.End());
+    EXPECT_FALSE(Source.Get(Ch));
+    EXPECT_FALSE(Source.Read(Buffer, 1));
+    EXPECT_FALSE(Source.Failed());
+
+    CMultiFileDataSource Empty(std::vector<std::string>{});
+    EXPECT_TRUE(Empty.End());
+}
+
+TEST(MultiFileDataSource, DSVHeaderTest){
+    CScratch Scratch;
+    std::vector<std::string> Paths = {
+        Scratch.Write("1.csv", "h1,h2\r\n1,2\n"),
+        Scratch.Write("2.csv", "h1,h2\n3,4"),
+        Scratch.Write("3.csv", "h1,h2\n"),
+        Scratch.Write("4.csv", ""),
+        Scratch.Write("5.csv", "\"h\nx\",y\n5,6\n")
+    };
+    for(std::size_t BufferSize : {1, 3, 4096}){
+        CMultiFileDataSource Source(Paths, true, BufferSize);
+        EXPECT_EQ(ReadRows(Source), (std::vector<std::vector<std::string>>{
+            {"h1", "h2"}, {"1", "2"}, {"3", "4"}, {"h\nx", "y"}, {"5", "6"}
+        }));
+        EXPECT_EQ(Source.HeaderMismatches(), 1);
+        EXPECT_FALSE(Source.Failed());
+    }
+}
+
+TEST(MultiFileDataSource, MissingFileTest){
+    CScratch Scratch;
+    std::vector<std::string> Paths = {Scratch.Write("a", "ab"), Scratch.DPath + "/missing", Scratch.Write("c", "cd")};
+    CMultiFileDataSource Source(Paths);
+    std::vector<char> Buffer;
+    ASSERT_TRUE(Source.Read(Buffer, 100));
+    EXPECT_EQ(std::string(Buffer.begin(), Buffer.end()), "ab");
+    EXPECT_TRUE(Source.End());
+    EXPECT_TRUE(Source.Failed());
+    EXPECT_EQ(Source.FileIndex(), 1);
+}
+
+TEST(MultiFileDataSource, GlobTest){
+    CScratch Scratch;
+    std::string B = Scratch.Write("b.csv", "");
+    std::string A = Scratch.Write("a.csv", "");
+    std::string X = Scratch.Write("x.xml", "");
+    EXPECT_EQ(CMultiFileDataSource::Glob(Scratch.DPath), (std::vector<std::string>{A, B, X}));
+    EXPECT_EQ(CMultiFileDataSource::Glob(Scratch.DPath + "/"), (std::vector<std::string>{A, B, X}));
+    EXPECT_EQ(CMultiFileDataSource::Glob(Scratch.DPath + "/*.csv"), (std::vector<std::string>{A, B}));
+    EXPECT_TRUE(CMultiFileDataSource::Glob(Scratch.DPath + "/*.json").empty());
+}
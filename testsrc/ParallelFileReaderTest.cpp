@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "ParallelFileReader.h"
+#include "TestScratch.h"
+#include <latch>
+#include <mutex>
+
+TEST(ParallelFileReader, ReadDSVTest){
+    CScratch Scratch;
+    std::vector<std::string> Paths;
+    std::vector<std::size_t> Expected;
+    // skewed sizes, one file much larger than the rest
+    for(std::size_t File = 0; File < 20; File++){
+        std::size_t Rows = File == 7 ? 5000 : File * 3;
+        std::string Contents = "file,row\n";
+        for(std::size_t Row = 0; Row < Rows; Row++){
+            Contents += std::to_string(File) + "," + std::to_string(Row) + "\n";
+        }
+        Paths.push_back(Scratch.Write(std::to_string(File) + ".csv", Contents));
+        Expected.push_back(Rows);
+    }
+    CThreadPool Pool(3);
+    for(std::size_t Workers : {1, 4, 32}){
+        CParallelFileReader Reader(Paths, Workers, &Pool, 256);
+        EXPECT_EQ(Reader.WorkerCount(), Workers);
+        std::mutex Mutex;
+        std::vector<std::size_t> Counts(Paths.size());
+        std::vector<std::size_t> Next(Paths.size());
+        bool InOrder = true;
+        ASSERT_TRUE(Reader.ReadDSV(',', true, [&](std::size_t worker, std::size_t file, const std::vector<std::string> &row){
+            std::lock_guard<std::mutex> Lock(Mutex);
+            EXPECT_LT(worker, Workers);
+            // rows of one file arrive in order on one worker
+            InOrder = InOrder && row[0] == std::to_string(file) && row[1] == std::to_string(Next[file]++);
+            Counts[file]++;
+        }));
+        EXPECT_TRUE(InOrder);
+        EXPECT_EQ(Counts, Expected);
+        EXPECT_TRUE(Reader.FailedFiles().empty());
+    }
+}
+
+TEST(ParallelFileReader, StealTest){
+    CScratch Scratch;
+    std::vector<std::string> Paths;
+    // file 0 is the largest, so it is dealt to worker 0 with files 2, 4 and 6
+    // behind it, and worker 1 gets the odd files
+    for(std::size_t File = 0; File < 8; File++){
+        Paths.push_back(Scratch.Write(std::to_string(File) + ".xml", "<r>" + std::string(File ? 10 : 20, 'x') + "</r>"));
+    }
+    CThreadPool Pool(2);
+    CParallelFileReader Reader(Paths, 2, &Pool);
+    std::mutex Mutex;
+    std::vector<std::size_t> Seen(Paths.size());
+    // worker 0 holds file 0 until every other file's entities have arrived,
+    // which only happens if worker 1 steals the files queued behind it
+    std::latch Others((Paths.size() - 1) * 3);
+    ASSERT_TRUE(Reader.ReadXML(false, [&](std::size_t, std::size_t file, const SXMLEntity &){
+        if(file == 0){
+            Others.wait();
+        }
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            Seen[file]++;
+        }
+        if(file != 0){
+            Others.count_down();
+        }
+    }));
+    EXPECT_EQ(Seen, std::vector<std::size_t>(Paths.size(), 3));
+    EXPECT_EQ(Reader.StolenFiles(), 3);
+}
+
+TEST(ParallelFileReader, FailedFilesTest){
+    CScratch Scratch;
+    std::vector<std::string> Paths = {
+        Scratch.Write("good.xml", "<a/>"),
+        Scratch.DPath + "/missing.xml",
+        Scratch.Write("bad.xml", "<a><b></a>")
+    };
+    CParallelFileReader Reader(Paths, 2);
+    std::size_t Entities = 0;
+    std::mutex Mutex;
+    EXPECT_FALSE(Reader.ReadXML(false, [&](std::size_t, std::size_t, const SXMLEntity &){
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Entities++;
+    }));
+    EXPECT_EQ(Reader.FailedFiles(), (std::vector<std::size_t>{1, 2}));
+    // the reader gives up on the block holding the error, so only good.xml's entities arrive
+    EXPECT_EQ(Entities, 2);
+}
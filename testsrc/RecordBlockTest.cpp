@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include "DSVReader.h"
+#include "XMLReader.h"
+#include "XMLPushParser.h"
+#include "StringDataSource.h"
+
+namespace {
+
+// passes allocations on to the default resource and counts them
+class CCountingResource : public std::pmr::memory_resource{
+    public:
+        std::size_t DAllocations = 0;
+        std::size_t DOutstanding = 0;
+
+    private:
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override{
+            DAllocations++;
+            DOutstanding++;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void *ptr, std::size_t bytes, std::size_t alignment) override{
+            DOutstanding--;
+            std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override{
+            return this == &other;
+        }
+};
+
+const std::string DSVInput = "first column value,\"second, quoted \"\" value\",3\r\n"
+                             "\n"
+                             "alpha alpha alpha alpha,beta beta beta beta,\n"
+                             "x\r"
+                             "last row without an end of line,,";
+
+const std::string XMLInput = "<records><record id=\"one hundred and one\" name=\"a rather long name\">some text that is long</record>"
+                             "<record id=\"two\"/>tail text after the records</records>";
+
+}
+
+TEST(RecordBlock, DSVPmrRowTest){
+    CDSVReader Expected(std::make_shared<CStringDataSource>(DSVInput), ',');
+    CCountingResource Resource;
+    CDSVReader Reader(std::make_shared<CStringDataSource>(DSVInput), ',');
+    std::vector<std::string> Row;
+    std::pmr::vector<std::pmr::string> PmrRow(&Resource);
+    while(Expected.ReadRow(Row)){
+        ASSERT_TRUE(Reader.ReadRow(PmrRow));
+        ASSERT_EQ(PmrRow.size(), Row.size());
+        for(std::size_t Index = 0; Index < Row.size(); Index++){
+            EXPECT_EQ(std::string_view(PmrRow[Index]), Row[Index]);
+            EXPECT_EQ(PmrRow[Index].get_allocator().resource(), &Resource);
+        }
+    }
+    EXPECT_FALSE(Reader.ReadRow(PmrRow));
+    EXPECT_TRUE(PmrRow.empty());
+    EXPECT_GT(Resource.DAllocations, 0);
+    EXPECT_EQ(Reader.Row(), Expected.Row());
+}
+
+TEST(RecordBlock, DSVReadRowsTest){
+    std::string Input;
+    for(int Index = 0; Index < 7; Index++){
+        Input += "a field longer than the small string buffer," + std::to_string(Index) + ",another long field of the row\n";
+    }
+    CCountingResource Resource;
+    TDSVRowBlock Block(&Resource);
+    CDSVReader Reader(std::make_shared<CStringDataSource>(Input), ',');
+    EXPECT_EQ(Reader.ReadRows(Block, 3), 3);
+    EXPECT_EQ(Block[2][1], "2");
+    std::size_t Allocations = Resource.DAllocations;
+
+    // later batches of the same shape refill the rows already in the block
+    EXPECT_EQ(Reader.ReadRows(Block, 3), 3);
+    EXPECT_EQ(Block[0][1], "3");
+    EXPECT_EQ(Reader.ReadRows(Block, 3), 1);
+    EXPECT_EQ(Block.Size(), 1);
+    EXPECT_EQ(Block.Capacity(), 3);
+    EXPECT_EQ(Block[0][1], "6");
+    EXPECT_EQ(Block[0][2], "another long field of the row");
+    EXPECT_EQ(Resource.DAllocations, Allocations);
+
+    std::size_t Rows = 0;
+    for(auto &Row : Block){
+        EXPECT_EQ(Row.size(), 3);
+        Rows++;
+    }
+    EXPECT_EQ(Rows, 1);
+    EXPECT_EQ(Reader.ReadRows(Block, 3), 0);
+    EXPECT_TRUE(Block.Empty());
+}
+
+TEST(RecordBlock, DSVArenaPerBatchTest){
+    std::string Input;
+    for(int Index = 0; Index < 100; Index++){
+        Input += "row number " + std::to_string(Index) + " has a long first column,second\n";
+    }
+    CDSVReader Reader(std::make_shared<CStringDataSource>(Input), ',');
+    std::size_t Rows = 0;
+    while(true){
+        // the arena cannot fall back on the heap, so every string came from it
+        alignas(std::max_align_t) char Storage[16384];
+        std::pmr::monotonic_buffer_resource Arena(Storage, sizeof(Storage), std::pmr::null_memory_resource());
+        TDSVRowBlock Block(&Arena);
+        if(!Reader.ReadRows(Block, 32)){
+            break;
+        }
+        for(auto &Row : Block){
+            ASSERT_EQ(Row.size(), 2);
+            EXPECT_EQ(std::string_view(Row[0]), "row number " + std::to_string(Rows++) + " has a long first column");
+        }
+    }
+    EXPECT_EQ(Rows, 100);
+}
+
+TEST(RecordBlock, XMLPmrEntityTest){
+    std::vector<SXMLEntity> Expected;
+    CXMLReader Plain(std::make_shared<CStringDataSource>(XMLInput));
+    SXMLEntity Entity;
+    while(Plain.ReadEntity(Entity)){
+        Expected.push_back(Entity);
+    }
+
+    CCountingResource Resource;
+    {
+        CXMLReader Reader(std::make_shared<CStringDataSource>(XMLInput), &Resource);
+        SPmrXMLEntity PmrEntity(&Resource);
+        for(auto &Want : Expected){
+            ASSERT_TRUE(Reader.ReadEntity(PmrEntity));
+            EXPECT_EQ(PmrEntity.DType, Want.DType);
+            EXPECT_EQ(std::string_view(PmrEntity.DNameData), Want.DNameData);
+            ASSERT_EQ(PmrEntity.DAttributes.size(), Want.DAttributes.size());
+            for(auto &Attribute : Want.DAttributes){
+                EXPECT_EQ(std::string_view(PmrEntity.AttributeValue(Attribute.first)), Attribute.second);
+            }
+        }
+        EXPECT_FALSE(Reader.ReadEntity(PmrEntity));
+        EXPECT_TRUE(Reader.End());
+        EXPECT_GT(Resource.DAllocations, 0);
+    }
+    EXPECT_EQ(Resource.DOutstanding, 0);
+
+    // the heap entity overload gives the same results from a pmr backed reader
+    CXMLReader Reader(std::make_shared<CStringDataSource>(XMLInput), &Resource);
+    for(auto &Want : Expected){
+        ASSERT_TRUE(Reader.ReadEntity(Entity));
+        EXPECT_EQ(Entity.DType, Want.DType);
+        EXPECT_EQ(Entity.DNameData, Want.DNameData);
+        EXPECT_EQ(Entity.DAttributes, Want.DAttributes);
+    }
+}
+
+TEST(RecordBlock, XMLReadEntitiesTest){
+    std::pmr::unsynchronized_pool_resource Pool;
+    CXMLReader Reader(std::make_shared<CStringDataSource>(XMLInput), &Pool);
+    TXMLEntityBlock Block(&Pool);
+    ASSERT_EQ(Reader.ReadEntities(Block, 3, true), 3);
+    EXPECT_EQ(Block[0].DNameData, "records");
+    EXPECT_EQ(Block[1].AttributeValue("id"), "one hundred and one");
+    EXPECT_EQ(Block[2].DType, SXMLEntity::EType::EndElement);
+    EXPECT_EQ(Block[2].DNameData.get_allocator().resource(), &Pool);
+    ASSERT_EQ(Reader.ReadEntities(Block, 3, true), 3);
+    EXPECT_EQ(Block[0].AttributeValue("id"), "two");
+    EXPECT_EQ(Block[2].DNameData, "records");
+    EXPECT_EQ(Reader.ReadEntities(Block, 3, true), 0);
+    EXPECT_EQ(Block.Capacity(), 3);
+}
+
+TEST(RecordBlock, PmrPushParserTest){
+    CCountingResource Resource;
+    std::pmr::vector<SPmrXMLEntity> Entities(&Resource);
+    CXMLPushParser Parser([&](SPmrXMLEntity &entity){ Entities.push_back(std::move(entity)); }, &Resource);
+    EXPECT_TRUE(Parser.Feed(XMLInput.data(), XMLInput.size()));
+    EXPECT_TRUE(Parser.Finish());
+    ASSERT_EQ(Entities.size(), 8);
+    EXPECT_EQ(Entities[2].DNameData, "some text that is long");
+    for(auto &Entity : Entities){
+        EXPECT_EQ(Entity.DNameData.get_allocator().resource(), &Resource);
+    }
+
+    SPmrXMLEntity &Record = Entities[1];
+    EXPECT_TRUE(Record.SetAttribute("name", "a replacement that is long too"));
+    EXPECT_TRUE(Record.SetAttribute("added", "x"));
+    EXPECT_FALSE(Record.SetAttribute("", "x"));
+    EXPECT_EQ(Record.AttributeValue("name"), "a replacement that is long too");
+    EXPECT_TRUE(Record.AttributeExists("added"));
+    EXPECT_EQ(Record.DAttributes.back().first.get_allocator().resource(), &Resource);
+}
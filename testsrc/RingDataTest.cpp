@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "RingDataSink.h"
+#include "RingDataSource.h"
+#include "DSVReader.h"
+#include "DSVWriter.h"
+#include <string>
+#include <thread>
+
+TEST(RingData, SingleThread){
+    auto Ring = std::make_shared<CSPSCRing>(64);
+    CRingDataSink Sink(Ring);
+    CRingDataSource Source(Ring);
+    char TempCh = 'x';
+
+    EXPECT_TRUE(Sink.Put('H'));
+    EXPECT_TRUE(Sink.Write(std::vector<char>{'i', '!'}));
+    Sink.Close();
+    EXPECT_FALSE(Sink.Put('x'));
+    EXPECT_FALSE(Source.End());
+    EXPECT_TRUE(Source.Peek(TempCh));
+    EXPECT_EQ(TempCh, 'H');
+    EXPECT_TRUE(Source.Get(TempCh));
+    EXPECT_EQ(TempCh, 'H');
+    std::vector<char> Buffer;
+    EXPECT_TRUE(Source.Read(Buffer, 10));
+    EXPECT_EQ(std::string(Buffer.begin(), Buffer.end()), "i!");
+    EXPECT_TRUE(Source.End());
+    EXPECT_FALSE(Source.Get(TempCh));
+}
+
+TEST(RingData, ThreadedTransfer){
+    auto Ring = std::make_shared<CSPSCRing>(128, 16);
+    std::string Expected;
+    for(int Index = 0; Index < 100000; Index++){
+        Expected += static_cast<char>('a' + Index % 26);
+    }
+    std::thread Producer([Ring, &Expected]{
+        CRingDataSink Sink(Ring);
+        for(char Ch : Expected){
+            Sink.Put(Ch);
+        }
+    });
+    CRingDataSource Source(Ring);
+    std::string Received;
+    char TempCh;
+    while(Source.Get(TempCh)){
+        Received += TempCh;
+    }
+    Producer.join();
+    EXPECT_EQ(Received, Expected);
+}
+
+TEST(RingData, DSVPipeline){
+    auto Ring = std::make_shared<CSPSCRing>(256);
+    std::thread Producer([Ring]{
+        CDSVWriter Writer(std::make_shared<CRingDataSink>(Ring), ',');
+        for(int Index = 0; Index < 1000; Index++){
+            Writer.WriteRow({std::to_string(Index), "a,b", "say \"hi\""});
+        }
+    });
+    CDSVReader Reader(std::make_shared<CRingDataSource>(Ring), ',');
+    std::vector<std::string> Row;
+    int Rows = 0;
+    while(Reader.ReadRow(Row)){
+        ASSERT_EQ(Row, (std::vector<std::string>{std::to_string(Rows), "a,b", "say \"hi\""}));
+        Rows++;
+    }
+    Producer.join();
+    EXPECT_EQ(Rows, 1000);
+}
+
+TEST(RingData, ConsumerCloseReleasesProducer){
+    auto Ring = std::make_shared<CSPSCRing>(64);
+    std::thread Producer([Ring]{
+        CRingDataSink Sink(Ring);
+        std::vector<char> Block(1000, 'z');
+        EXPECT_FALSE(Sink.Write(Block));
+    });
+    {
+        CRingDataSource Source(Ring);
+        char TempCh;
+        EXPECT_TRUE(Source.Get(TempCh));
+    }
+    Producer.join();
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "SegmentedDataSink.h"
+#include "SegmentedDataSource.h"
+#include "DSVReader.h"
+#include "DSVWriter.h"
+
+TEST(SegmentedData, SinkTest){
+    CSegmentedDataSink Sink(4);
+    EXPECT_EQ(Sink.String(), "");
+    EXPECT_TRUE(Sink.Put('a'));
+    EXPECT_TRUE(Sink.Write(std::vector<char>{'b', 'c', 'd', 'e', 'f'}));
+    EXPECT_TRUE(Sink.Write("ghijklmnop", 10));
+    EXPECT_EQ(Sink.Size(), 16);
+    EXPECT_EQ(Sink.ChunkCount(), 4);
+    EXPECT_EQ(Sink.String(), "abcdefghijklmnop");
+
+    // chunks keep the capacity they were created with
+    auto Chunks = Sink.TakeChunks();
+    ASSERT_EQ(Chunks.size(), 4);
+    const char *First = Chunks[0]->data();
+    EXPECT_EQ(*Chunks[0], "abcd");
+    EXPECT_EQ(*Chunks[3], "mnop");
+    EXPECT_EQ(Sink.Size(), 0);
+    EXPECT_EQ(Sink.String(), "");
+
+    // a source reads the same buffers
+    CSegmentedDataSource Source(Chunks);
+    EXPECT_EQ(Source.Size(), 16);
+    char Ch;
+    EXPECT_TRUE(Source.Peek(Ch));
+    EXPECT_EQ(Ch, 'a');
+    EXPECT_EQ(Chunks[0]->data(), First);
+}
+
+TEST(SegmentedData, SourceTest){
+    std::vector<CSegmentedDataSource::TChunk> Chunks = {
+        std::make_shared<const std::string>("abc"), nullptr,
+        std::make_shared<const std::string>(""), std::make_shared<const std::string>("de"),
+        std::make_shared<const std::string>("fghij")
+    };
+    CSegmentedDataSource Source(Chunks);
+    std::vector<char> Buffer;
+    char Ch;
+    EXPECT_EQ(Source.Size(), 10);
+    EXPECT_TRUE(Source.Get(Ch));
+    EXPECT_EQ(Ch, 'a');
+    EXPECT_TRUE(Source.Read(Buffer, 4));
+    EXPECT_EQ(std::string(Buffer.begin(), Buffer.end()), "bcde");
+    EXPECT_EQ(Source.Tell(), 5);
+    EXPECT_TRUE(Source.Seek(2));
+    EXPECT_TRUE(Source.Read(Buffer, 100));
+    EXPECT_EQ(std::string(Buffer.begin(), Buffer.end()), "cdefghij");
+    EXPECT_TRUE(Source.End());
+    EXPECT_FALSE(Source.Get(Ch));
+    EXPECT_FALSE(Source.Read(Buffer, 1));
+    EXPECT_EQ(Source.Tell(), 10);
+    EXPECT_TRUE(Source.Seek(3));
+    EXPECT_TRUE(Source.Get(Ch));
+    EXPECT_EQ(Ch, 'd');
+    EXPECT_TRUE(Source.Seek(10));
+    EXPECT_TRUE(Source.End());
+    EXPECT_FALSE(Source.Seek(11));
+
+    CSegmentedDataSource Empty({});
+    EXPECT_TRUE(Empty.End());
+    EXPECT_TRUE(Empty.Seek(0));
+    EXPECT_EQ(Empty.Tell(), 0);
+}
+
+TEST(SegmentedData, PipelineTest){
+    // rows written into small chunks are read back across chunk boundaries
+    auto Sink = std::make_shared<CSegmentedDataSink>(7);
+    CDSVWriter Writer(Sink, ',');
+    std::vector<std::vector<std::string>> Rows = {{"a", "b,c"}, {"longer field", "\"q\""}, {"x"}};
+    for(auto &Row : Rows){
+        Writer.WriteRow(Row);
+    }
+    CDSVReader Reader(std::make_shared<CSegmentedDataSource>(Sink->TakeChunks()), ',');
+    std::vector<std::string> Row;
+    for(auto &Expected : Rows){
+        ASSERT_TRUE(Reader.ReadRow(Row));
+        EXPECT_EQ(Row, Expected);
+    }
+    EXPECT_FALSE(Reader.ReadRow(Row));
+}
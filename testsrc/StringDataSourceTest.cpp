@@ -81,3 +81,24 @@ TEST(StringDataSource, ReadTest){
     EXPECT_FALSE(Source2.Peek(TempCh));
     EXPECT_EQ(TempCh,'x');
 }
+
+TEST(StringDataSource, OwnershipTest){
+    std::string Text = "Shared";
+    auto Shared = std::make_shared<const std::string>(Text);
+    CStringDataSource SharedSource(Shared);
+    CStringDataSource BorrowedSource(std::string_view(Text).substr(1, 3));
+    CStringDataSource MovedSource(std::string("Moved"));
+    CStringDataSource NullSource(std::shared_ptr<const std::string>{});
+    std::vector<char> Buffer;
+
+    EXPECT_EQ(Shared.use_count(), 2);
+    EXPECT_TRUE(SharedSource.Read(Buffer, 10));
+    EXPECT_EQ(std::string(Buffer.begin(), Buffer.end()), "Shared");
+    EXPECT_EQ(BorrowedSource.Size(), 3);
+    EXPECT_TRUE(BorrowedSource.Read(Buffer, 10));
+    EXPECT_EQ(std::string(Buffer.begin(), Buffer.end()), "har");
+    EXPECT_TRUE(MovedSource.Read(Buffer, 10));
+    EXPECT_EQ(std::string(Buffer.begin(), Buffer.end()), "Moved");
+    EXPECT_TRUE(NullSource.End());
+    EXPECT_EQ(NullSource.Size(), 0);
+}
@@ -76,3 +76,36 @@ TEST(StringUtilsTest, EditDistance){
     ASSERT_EQ(StringUtils::EditDistance("anika", "anika"), 0);
     ASSERT_EQ(StringUtils::EditDistance("anika", "anik"), 1);
 }
+
+TEST(StringUtilsTest, ColumnTransforms){
+    std::vector<std::string> Column = {"  anika ", "Loves\tCS", "", "aleena"};
+    SStringColumn Packed(Column);
+
+    ASSERT_EQ(Packed.Size(), 4);
+    ASSERT_EQ(StringUtils::Strip(Packed).Strings(), (std::vector<std::string>{"anika", "Loves\tCS", "", "aleena"}));
+    ASSERT_EQ(StringUtils::Upper(Column).Strings(), (std::vector<std::string>{"  ANIKA ", "LOVES\tCS", "", "ALEENA"}));
+    ASSERT_EQ(StringUtils::Lower(Packed).Strings(), (std::vector<std::string>{"  anika ", "loves\tcs", "", "aleena"}));
+    ASSERT_EQ(StringUtils::Replace(Column, "a", "AA").Strings(), (std::vector<std::string>{"  AAnikAA ", "Loves\tCS", "", "AAleenAA"}));
+    ASSERT_EQ(StringUtils::ExpandTabs(Packed, 4).Field(1), "Loves   CS");
+    ASSERT_EQ(StringUtils::Center(Column, 8, '*').Strings(), (std::vector<std::string>{"  anika ", "Loves\tCS", "********", "*aleena*"}));
+    ASSERT_EQ(StringUtils::LJust(Packed, 7, '-').Field(3), "aleena-");
+    ASSERT_EQ(StringUtils::RJust(Packed, 7, '-').Field(3), "-aleena");
+}
+
+TEST(StringUtilsTest, ColumnMatchesScalar){
+    std::vector<std::string> Column;
+    for(int Index = 0; Index < 20000; Index++){
+        Column.push_back(std::string(Index % 7, ' ') + "field\t" + std::to_string(Index) + std::string(Index % 3, '\t'));
+    }
+    auto Stripped = StringUtils::Strip(Column);
+    auto Replaced = StringUtils::Replace(Column, "el", "EEL");
+    auto Expanded = StringUtils::ExpandTabs(Column, 3);
+    auto Centered = StringUtils::Center(Column, 16, '.');
+    ASSERT_EQ(Stripped.Size(), Column.size());
+    for(size_t Index = 0; Index < Column.size(); Index++){
+        ASSERT_EQ(Stripped.String(Index), StringUtils::Strip(Column[Index]));
+        ASSERT_EQ(Replaced.String(Index), StringUtils::Replace(Column[Index], "el", "EEL"));
+        ASSERT_EQ(Expanded.String(Index), StringUtils::ExpandTabs(Column[Index], 3));
+        ASSERT_EQ(Centered.String(Index), StringUtils::Center(Column[Index], 16, '.'));
+    }
+}
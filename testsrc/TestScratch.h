@@ -0,0 +1,36 @@
+#ifndef TESTSCRATCH_H
+#define TESTSCRATCH_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// scratch directory removed with its files at the end of a test
+class CScratch{
+    public:
+        std::string DPath;
+        std::vector<std::string> DFiles;
+
+        CScratch(){
+            char Template[] = "/tmp/scratchXXXXXX";
+            DPath = mkdtemp(Template);
+        }
+        ~CScratch(){
+            for(const auto &File : DFiles){
+                std::remove(File.c_str());
+            }
+            rmdir(DPath.c_str());
+        }
+        std::string Write(const std::string &name, const std::string &contents){
+            std::string Path = DPath + "/" + name;
+            FILE *File = std::fopen(Path.c_str(), "wb");
+            std::fwrite(contents.data(), 1, contents.size(), File);
+            std::fclose(File);
+            DFiles.push_back(Path);
+            return Path;
+        }
+};
+
+#endif
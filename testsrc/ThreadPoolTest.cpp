@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include "ThreadPool.h"
+#include <atomic>
+#include <vector>
+
+TEST(ThreadPool, SubmitWait){
+    CThreadPool Pool(4);
+    std::atomic<int> Count(0);
+
+    EXPECT_EQ(Pool.ThreadCount(), 4);
+    for(int Index = 0; Index < 100; Index++){
+        Pool.Submit([&Count]{ Count++; });
+    }
+    Pool.Wait();
+    EXPECT_EQ(Count.load(), 100);
+}
+
+TEST(ThreadPool, ParallelForCoversRange){
+    CThreadPool Pool(3);
+    std::vector<int> Hits(1000, 0);
+
+    Pool.ParallelFor(Hits.size(), 64, [&Hits](size_t begin, size_t end){
+        for(size_t Index = begin; Index < end; Index++){
+            Hits[Index]++;
+        }
+    });
+    for(auto Hit : Hits){
+        EXPECT_EQ(Hit, 1);
+    }
+}
+
+TEST(ThreadPool, NestedParallelFor){
+    CThreadPool Pool(2);
+    std::atomic<int> Count(0);
+
+    Pool.ParallelFor(8, 1, [&](size_t, size_t){
+        Pool.ParallelFor(8, 1, [&](size_t, size_t){ Count++; });
+    });
+    EXPECT_EQ(Count.load(), 64);
+}
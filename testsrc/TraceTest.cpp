@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include "Trace.h"
+#include "DSVReader.h"
+#include "DSVWriter.h"
+#include "XMLReader.h"
+#include "XMLWriter.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+#include <thread>
+
+TEST(Trace, SpanTest){
+    CTrace::Clear();
+    {
+        TRACE_SPAN("Test::Outer");
+        TRACE_SPAN("Test::Inner");
+    }
+    EXPECT_EQ(CTrace::EventCount(), CTrace::Enabled ? 2 : 0);
+    std::thread Worker([]{
+        TRACE_SPAN("Test::Worker");
+    });
+    Worker.join();
+    EXPECT_EQ(CTrace::EventCount(), CTrace::Enabled ? 3 : 0);
+    CTrace::Clear();
+    EXPECT_EQ(CTrace::EventCount(), 0);
+}
+
+TEST(Trace, PipelineTest){
+    CTrace::Clear();
+    CDSVReader DSVReader(std::make_shared<CStringDataSource>("a,b\nc,d\n"), ',');
+    CDSVWriter DSVWriter(std::make_shared<CStringDataSink>(), ',');
+    std::vector<std::string> Row;
+    while(DSVReader.ReadRow(Row)){
+        DSVWriter.WriteRow(Row);
+    }
+    CXMLReader XMLReader(std::make_shared<CStringDataSource>("<a><b/></a>"));
+    CXMLWriter XMLWriter(std::make_shared<CStringDataSink>());
+    SXMLEntity Entity;
+    while(XMLReader.ReadEntity(Entity)){
+        XMLWriter.WriteEntity(Entity);
+    }
+    XMLWriter.Flush();
+
+    auto Sink = std::make_shared<CStringDataSink>();
+    EXPECT_TRUE(CTrace::WriteChromeTrace(Sink));
+    std::string Trace = Sink->String();
+    EXPECT_EQ(Trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0);
+    EXPECT_EQ(Trace.substr(Trace.size() - 4), "\n]}\n");
+    if(CTrace::Enabled){
+        for(auto Name : {"DSVReader::Refill", "DSVReader::Tokenize", "DSVWriter::SinkWrite",
+                         "XMLReader::Refill", "XMLReader::XML_Parse", "XMLReader::QueueDrain", "XMLWriter::SinkWrite"}){
+            EXPECT_NE(Trace.find(std::string("\"name\":\"") + Name + "\",\"ph\":\"X\""), std::string::npos) << Name;
+        }
+    }
+    else{
+        EXPECT_EQ(CTrace::EventCount(), 0);
+        EXPECT_EQ(Trace.find("\"ph\""), std::string::npos);
+    }
+    EXPECT_FALSE(CTrace::WriteChromeTrace(nullptr));
+    CTrace::Clear();
+}
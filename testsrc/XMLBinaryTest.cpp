@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "XMLBinaryReader.h"
+#include "XMLBinaryWriter.h"
+#include "XMLReader.h"
+#include "FileDataSink.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+#include "TestScratch.h"
+#include <cstdio>
+
+namespace {
+
+std::string BinaryTestXML(){
+    std::string XML = "<root version=\"2\">";
+    for(int Index = 0; Index < 100; Index++){
+        XML += "<item id=\"" + std::to_string(Index) + "\" kind=\"k" + std::to_string(Index % 3) + "\">text &amp; " + std::to_string(Index) + "<empty/></item>";
+    }
+    return XML + "</root>";
+}
+
+std::vector<SXMLEntity> Parse(const std::string &xml){
+    CXMLReader Reader(std::make_shared<CStringDataSource>(xml));
+    std::vector<SXMLEntity> Entities;
+    for(auto &Entity : Reader.Entities()){
+        Entities.push_back(Entity);
+    }
+    return Entities;
+}
+
+std::shared_ptr<const std::string> Record(const std::vector<SXMLEntity> &entities, std::size_t blockentities){
+    auto Sink = std::make_shared<CStringDataSink>();
+    CXMLBinaryWriter Writer(Sink, blockentities);
+    for(auto &Entity : entities){
+        EXPECT_TRUE(Writer.WriteEntity(Entity));
+    }
+    EXPECT_TRUE(Writer.Flush());
+    EXPECT_FALSE(Writer.WriteEntity(entities[0]));
+    return std::make_shared<const std::string>(Sink->String());
+}
+
+void ExpectSame(const SXMLEntity &left, const SXMLEntity &right){
+    EXPECT_EQ(left.DType, right.DType);
+    EXPECT_EQ(left.DNameData, right.DNameData);
+    EXPECT_EQ(left.DAttributes, right.DAttributes);
+}
+
+}
+
+TEST(XMLBinary, ReplayTest){
+    auto Expected = Parse(BinaryTestXML());
+    for(std::size_t BlockEntities : {1, 7, 4096}){
+        auto Data = Record(Expected, BlockEntities);
+        CXMLBinaryReader Reader(Data);
+        ASSERT_TRUE(Reader.IsOpen());
+        EXPECT_EQ(Reader.BlockCount(), (Expected.size() + BlockEntities - 1) / BlockEntities);
+        std::size_t Index = 0;
+        SXMLEntity Entity;
+        EXPECT_FALSE(Reader.End());
+        while(Reader.ReadEntity(Entity)){
+            ASSERT_LT(Index, Expected.size());
+            ExpectSame(Entity, Expected[Index++]);
+        }
+        EXPECT_EQ(Index, Expected.size());
+        EXPECT_TRUE(Reader.End());
+    }
+}
+
+TEST(XMLBinary, SkipCDataTest){
+    auto Expected = Parse(BinaryTestXML());
+    CXMLBinaryReader Reader(Record(Expected, 16));
+    std::size_t Count = 0;
+    for(auto &Entity : Reader.Entities(true)){
+        EXPECT_NE(Entity.DType, SXMLEntity::EType::CharData);
+        Count++;
+    }
+    EXPECT_EQ(Count, Expected.size() - 100);
+}
+
+TEST(XMLBinary, BlockRangeTest){
+    auto Expected = Parse(BinaryTestXML());
+    CXMLBinaryReader Reader(Record(Expected, 10));
+    ASSERT_EQ(Reader.BlockCount(), (Expected.size() + 9) / 10);
+    // replay the blocks in ranges as separate workers would
+    std::size_t Index = 0;
+    for(std::size_t Block = 0; Block < Reader.BlockCount(); Block += 3){
+        ASSERT_TRUE(Reader.SeekBlock(Block, 3));
+        std::size_t Count = 0;
+        SXMLEntity Entity;
+        while(Reader.ReadEntity(Entity)){
+            ExpectSame(Entity, Expected[Index++]);
+            Count++;
+        }
+        std::size_t RangeEntities = 0;
+        for(std::size_t Part = Block; Part < Block + 3; Part++){
+            RangeEntities += Reader.BlockEntities(Part);
+        }
+        EXPECT_EQ(Count, RangeEntities);
+        EXPECT_TRUE(Reader.End());
+    }
+    EXPECT_EQ(Index, Expected.size());
+    EXPECT_FALSE(Reader.SeekBlock(Reader.BlockCount() + 1));
+    EXPECT_EQ(Reader.BlockEntities(Reader.BlockCount()), 0);
+}
+
+TEST(XMLBinary, MappedFileTest){
+    CScratch Scratch;
+    std::string Path = Scratch.Write("entities.bin", "");
+    auto Expected = Parse(BinaryTestXML());
+    {
+        CXMLBinaryWriter Writer(std::make_shared<CFileDataSink>(Path), 50);
+        for(auto &Entity : Expected){
+            Writer.WriteEntity(Entity);
+        }
+        EXPECT_TRUE(Writer.Flush());
+    }
+    CXMLBinaryReader Reader(Path);
+    ASSERT_TRUE(Reader.IsOpen());
+    std::size_t Index = 0;
+    for(auto &Entity : Reader.Entities()){
+        ExpectSame(Entity, Expected[Index++]);
+    }
+    EXPECT_EQ(Index, Expected.size());
+    std::remove(Path.c_str());
+
+    CXMLBinaryReader Missing(Path);
+    EXPECT_FALSE(Missing.IsOpen());
+    EXPECT_TRUE(Missing.End());
+}
+
+TEST(XMLBinary, CorruptTest){
+    auto Expected = Parse(BinaryTestXML());
+    std::string Data = *Record(Expected, 64);
+    EXPECT_FALSE(CXMLBinaryReader(std::make_shared<const std::string>(Data.substr(0, Data.size() - 1))).IsOpen());
+    EXPECT_FALSE(CXMLBinaryReader(std::make_shared<const std::string>("XMLB")).IsOpen());
+
+    // a block of one start element is its entity count, a one word
+    // dictionary and then the entity, whose type byte is damaged here
+    std::string Single = *Record({{SXMLEntity::EType::StartElement, "a", {}}}, 1);
+    ASSERT_EQ(Single.substr(5, 4), std::string("\x01\x01\x01" "a"));
+    Single[9] = 9;
+    CXMLBinaryReader Reader(std::make_shared<const std::string>(Single));
+    ASSERT_TRUE(Reader.IsOpen());
+    SXMLEntity Entity;
+    EXPECT_FALSE(Reader.ReadEntity(Entity));
+    EXPECT_TRUE(Reader.End());
+}
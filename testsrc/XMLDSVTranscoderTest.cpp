@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "XMLDSVTranscoder.h"
+#include "BoundedQueue.h"
+#include "StringDataSource.h"
+#include "StringDataSink.h"
+#include <thread>
+
+namespace {
+
+CXMLDSVTranscoder::SSpec TestSpec(){
+    CXMLDSVTranscoder::SSpec Spec;
+    Spec.DRecordElement = "item";
+    Spec.DRootElement = "catalog";
+    for(auto Arg : {"id=@id", "name", "cur=price/@cur", "price", "note=."}){
+        CXMLDSVTranscoder::SField Field;
+        EXPECT_TRUE(CXMLDSVTranscoder::ParseField(Arg, Field));
+        Spec.DFields.push_back(Field);
+    }
+    return Spec;
+}
+
+}
+
+TEST(XMLDSVTranscoder, XMLToDSVTest){
+    std::string XML = "<catalog><meta><name>ignored</name></meta>"
+                      "<item id=\"1\"><name>A &amp; B</name><price cur=\"USD\">1.50</price>text</item>"
+                      "<item id=\"2\"><price>2</price><name>first</name><name>second</name><extra><name>deep</name></extra></item>"
+                      "</catalog>";
+    CXMLDSVTranscoder Transcoder(TestSpec(), 1, 1);
+    auto Sink = std::make_shared<CStringDataSink>();
+    ASSERT_TRUE(Transcoder.XMLToDSV(std::make_shared<CStringDataSource>(XML), Sink));
+    EXPECT_EQ(Sink->String(), "id,name,cur,price,note\n"
+                              "1,A & B,USD,1.50,text\n"
+                              "2,first,,2,\n");
+    ASSERT_EQ(Transcoder.Stages().size(), 3);
+    EXPECT_EQ(Transcoder.Stages()[0].DBytes, XML.size());
+    EXPECT_EQ(Transcoder.Stages()[1].DItems, 2);
+    EXPECT_EQ(Transcoder.Stages()[2].DItems, 2);
+    EXPECT_EQ(Transcoder.Stages()[2].DBytes, Sink->String().size());
+}
+
+TEST(XMLDSVTranscoder, DSVToXMLTest){
+    // header columns out of field order, and one missing
+    std::string DSV = "price,id,name,extra\n1.50,1,\"A <&> B\",x\n2,2,,y\n";
+    CXMLDSVTranscoder Transcoder(TestSpec(), 2, 1);
+    auto Sink = std::make_shared<CStringDataSink>();
+    ASSERT_TRUE(Transcoder.DSVToXML(std::make_shared<CStringDataSource>(DSV), Sink));
+    EXPECT_EQ(Sink->String(), "<catalog>"
+                              "<item id=\"1\"><name>A &lt;&amp;&gt; B</name><price cur=\"\">1.50</price></item>"
+                              "<item id=\"2\"><name></name><price cur=\"\">2</price></item>"
+                              "</catalog>");
+    EXPECT_EQ(Transcoder.Stages()[0].DItems, 3);
+    EXPECT_EQ(Transcoder.Stages()[1].DItems, 2);
+}
+
+TEST(XMLDSVTranscoder, RoundTripTest){
+    std::string DSV;
+    for(int Index = 0; Index < 5000; Index++){
+        DSV += std::to_string(Index) + ",\"name, " + std::to_string(Index) + "\",EUR," + std::to_string(Index % 97) + ",\n";
+    }
+    auto Spec = TestSpec();
+    Spec.DHeader = false;
+    Spec.DDelimiter = ',';
+    CXMLDSVTranscoder Transcoder(Spec, 64, 2);
+    auto XML = std::make_shared<CStringDataSink>();
+    ASSERT_TRUE(Transcoder.DSVToXML(std::make_shared<CStringDataSource>(DSV), XML));
+    auto Back = std::make_shared<CStringDataSink>();
+    ASSERT_TRUE(Transcoder.XMLToDSV(std::make_shared<CStringDataSource>(XML->String()), Back));
+    EXPECT_EQ(Back->String(), DSV);
+}
+
+TEST(XMLDSVTranscoder, ErrorTest){
+    CXMLDSVTranscoder Transcoder(TestSpec());
+    auto Sink = std::make_shared<CStringDataSink>();
+    EXPECT_FALSE(Transcoder.XMLToDSV(std::make_shared<CStringDataSource>("<catalog><item id=\"1\"></catalog>"), Sink));
+    EXPECT_FALSE(Transcoder.XMLToDSV(nullptr, Sink));
+
+    CXMLDSVTranscoder::SField Field;
+    EXPECT_TRUE(CXMLDSVTranscoder::ParseField("child/@attr", Field));
+    EXPECT_EQ(Field.DColumn, "child/@attr");
+    EXPECT_FALSE(CXMLDSVTranscoder::ParseField("=@id", Field));
+    EXPECT_FALSE(CXMLDSVTranscoder::ParseField("x=a/b", Field));
+    EXPECT_FALSE(CXMLDSVTranscoder::ParseField("x=/@y", Field));
+
+    CXMLDSVTranscoder::SSpec Spec = TestSpec();
+    Spec.DFields.push_back({"bad", "@"});
+    CXMLDSVTranscoder Invalid(Spec);
+    EXPECT_FALSE(Invalid.DSVToXML(std::make_shared<CStringDataSource>("a\n"), Sink));
+}
+
+TEST(XMLDSVTranscoder, BoundedQueueTest){
+    CBoundedQueue<int> Queue(2);
+    std::thread Producer([&]{
+        for(int Index = 0; Index < 1000; Index++){
+            Queue.Push(Index);
+        }
+        Queue.Close();
+    });
+    int Expected = 0;
+    int Value;
+    while(Queue.Pop(Value)){
+        EXPECT_EQ(Value, Expected++);
+    }
+    Producer.join();
+    EXPECT_EQ(Expected, 1000);
+    EXPECT_LE(Queue.HighWater(), 2);
+    EXPECT_FALSE(Queue.Push(1));
+}
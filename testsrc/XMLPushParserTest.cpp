@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include "XMLPushParser.h"
+#include "XMLReader.h"
+#include "StringDataSource.h"
+
+TEST(XMLPushParser, SplitAtEveryByteTest){
+    std::string Input = "<root a=\"1\" b=\"&amp;\"><item>one &lt; two</item><empty/>tail</root>";
+    std::vector<SXMLEntity> Expected;
+    CXMLReader Reader(std::make_shared<CStringDataSource>(Input));
+    SXMLEntity Entity;
+    while(Reader.ReadEntity(Entity)){
+        Expected.push_back(Entity);
+    }
+    for(std::size_t Split = 0; Split <= Input.size(); Split++){
+        std::vector<SXMLEntity> Entities;
+        CXMLPushParser Parser([&](SXMLEntity &entity){ Entities.push_back(std::move(entity)); });
+        EXPECT_TRUE(Parser.Feed(Input.data(), Split));
+        EXPECT_TRUE(Parser.Feed(Input.data() + Split, Input.size() - Split));
+        EXPECT_TRUE(Parser.Finish());
+        ASSERT_EQ(Entities.size(), Expected.size()) << Split;
+        for(std::size_t Index = 0; Index < Expected.size(); Index++){
+            EXPECT_EQ(Entities[Index].DType, Expected[Index].DType);
+            EXPECT_EQ(Entities[Index].DNameData, Expected[Index].DNameData);
+            EXPECT_EQ(Entities[Index].DAttributes, Expected[Index].DAttributes);
+        }
+    }
+}
+
+TEST(XMLPushParser, ErrorTest){
+    std::size_t Count = 0;
+    CXMLPushParser Parser([&](SXMLEntity &){ Count++; });
+    std::string Input = "<a><b></a>";
+    EXPECT_FALSE(Parser.Feed(Input.data(), Input.size()));
+    EXPECT_EQ(Count, 2);
+
+    CXMLPushParser Incomplete(nullptr);
+    Input = "<a>";
+    EXPECT_TRUE(Incomplete.Feed(Input.data(), Input.size()));
+    EXPECT_FALSE(Incomplete.Finish());
+    EXPECT_TRUE(Incomplete.Finished());
+    EXPECT_FALSE(Incomplete.Feed(Input.data(), Input.size()));
+}
+
+TEST(XMLPushParser, EntityOffsetTest){
+    std::string Input = "<root><item>one &lt; two</item><empty/><![CDATA[x]]></root>";
+    std::vector<std::size_t> Offsets;
+    CXMLPushParser *Current = nullptr;
+    CXMLPushParser Parser([&](SXMLEntity &){ Offsets.push_back(Current->EntityOffset()); });
+    Current = &Parser;
+    for(int Pass = 0; Pass < 2; Pass++){
+        Offsets.clear();
+        EXPECT_TRUE(Parser.Feed(Input.data(), Input.size()));
+        EXPECT_TRUE(Parser.Finish());
+        // both halves of the empty element belong to its tag
+        EXPECT_EQ(Offsets, (std::vector<std::size_t>{0, 6, 12, 24, 31, 31, 39, 52}));
+        Parser.Reset();
+    }
+}
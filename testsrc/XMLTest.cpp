@@ -32,3 +32,13 @@ TEST(XMLTest, BasicReadWrite) {
     // After all entities are processed, check if the output matches the original input
     EXPECT_EQ(sink->String(), "<tag>data</tag>");
 }
+
+TEST(XMLTest, EntitiesGenerator) {
+    CXMLReader reader(std::make_shared<CStringDataSource>("<a x=\"1\">text<b/></a>"));
+    std::vector<std::string> names;
+    for (auto &entity : reader.Entities(true)) {
+        names.push_back(entity.DNameData);
+    }
+    EXPECT_EQ(names, (std::vector<std::string>{"a", "b", "b", "a"}));
+    EXPECT_TRUE(reader.End());
+}
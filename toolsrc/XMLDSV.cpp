@@ -0,0 +1,117 @@
+#include "XMLDSVTranscoder.h"
+#include "FileDataSink.h"
+#include "FileDataSource.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+void Usage(const char *program){
+    std::fprintf(stderr,
+        "usage: %s (--to-dsv | --to-xml) --record NAME --field COLUMN=PATH... [options] INPUT OUTPUT\n"
+        "  PATH is @attr, ., child or child/@attr relative to the record element\n"
+        "  INPUT and OUTPUT may be - for standard input and output\n"
+        "  --root NAME       root element written by --to-xml (default records)\n"
+        "  --delimiter C     DSV delimiter, \\t for tab (default ,)\n"
+        "  --no-header       the DSV has no header row\n"
+        "  --batch N         items passed between stages at once (default 1024)\n"
+        "  --queue N         batches buffered between stages (default 8)\n"
+        "  --stats           print per stage throughput to standard error\n", program);
+}
+
+// prints items and megabytes per second of busy time, and the share of wall time spent busy
+void PrintStats(const CXMLDSVTranscoder &transcoder){
+    for(auto &Stage : transcoder.Stages()){
+        double Busy = Stage.DBusyNanoseconds ? Stage.DBusyNanoseconds / 1e9 : 1e-9;
+        double Wall = Stage.DWallNanoseconds ? Stage.DWallNanoseconds / 1e9 : 1e-9;
+        std::fprintf(stderr, "%-10s %12llu items %10.0f items/s", Stage.DName.c_str(), static_cast<unsigned long long>(Stage.DItems), Stage.DItems / Busy);
+        if(Stage.DBytes){
+            std::fprintf(stderr, " %8.1f MB/s", Stage.DBytes / Busy / 1e6);
+        }
+        std::fprintf(stderr, " busy %5.1f%% of %.3fs", 100.0 * Busy / Wall, Wall);
+        if(Stage.DQueueHighWater){
+            std::fprintf(stderr, " input queue peak %zu", Stage.DQueueHighWater);
+        }
+        std::fprintf(stderr, "\n");
+    }
+}
+
+}
+
+int main(int argc, char *argv[]){
+    CXMLDSVTranscoder::SSpec Spec;
+    int Direction = 0;
+    std::size_t Batch = 1024;
+    std::size_t Queue = 8;
+    bool Stats = false;
+    std::vector<std::string> Paths;
+    for(int Index = 1; Index < argc; Index++){
+        std::string Arg = argv[Index];
+        bool HasValue = Index + 1 < argc;
+        if(Arg == "--to-dsv" || Arg == "--to-xml"){
+            Direction = Arg == "--to-dsv" ? 1 : 2;
+        }
+        else if(Arg == "--record" && HasValue){
+            Spec.DRecordElement = argv[++Index];
+        }
+        else if(Arg == "--field" && HasValue){
+            CXMLDSVTranscoder::SField Field;
+            if(!CXMLDSVTranscoder::ParseField(argv[++Index], Field)){
+                std::fprintf(stderr, "invalid field %s\n", argv[Index]);
+                return EXIT_FAILURE;
+            }
+            Spec.DFields.push_back(Field);
+        }
+        else if(Arg == "--root" && HasValue){
+            Spec.DRootElement = argv[++Index];
+        }
+        else if(Arg == "--delimiter" && HasValue){
+            std::string Delimiter = argv[++Index];
+            Spec.DDelimiter = Delimiter == "\\t" ? '\t' : Delimiter[0];
+        }
+        else if(Arg == "--no-header"){
+            Spec.DHeader = false;
+        }
+        else if(Arg == "--batch" && HasValue){
+            Batch = std::strtoul(argv[++Index], nullptr, 10);
+        }
+        else if(Arg == "--queue" && HasValue){
+            Queue = std::strtoul(argv[++Index], nullptr, 10);
+        }
+        else if(Arg == "--stats"){
+            Stats = true;
+        }
+        else if(Arg == "-" || Arg[0] != '-'){
+            Paths.push_back(Arg);
+        }
+        else{
+            Usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if(!Direction || Spec.DRecordElement.empty() || Spec.DFields.empty() || Paths.size() != 2){
+        Usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    auto Source = std::make_shared<CFileDataSource>(Paths[0] == "-" ? "/dev/stdin" : Paths[0]);
+    auto Sink = Paths[1] == "-" ? std::make_shared<CFileDataSink>(STDOUT_FILENO, false) : std::make_shared<CFileDataSink>(Paths[1]);
+    if(!Source->IsOpen() || !Sink->IsOpen()){
+        std::fprintf(stderr, "cannot open %s\n", Source->IsOpen() ? Paths[1].c_str() : Paths[0].c_str());
+        return EXIT_FAILURE;
+    }
+    CXMLDSVTranscoder Transcoder(Spec, Batch, Queue);
+    bool Result = Direction == 1 ? Transcoder.XMLToDSV(Source, Sink) : Transcoder.DSVToXML(Source, Sink);
+    Result = Sink->Flush() && Result;
+    if(Stats){
+        PrintStats(Transcoder);
+    }
+    if(!Result){
+        std::fprintf(stderr, "conversion failed\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}